@@ -0,0 +1,313 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <filesystem>
+#include <unordered_set>
+#include "BinaryCatalog.h"
+#include "BookJournal.h"
+
+namespace {
+    const char catalogMagic[8] = { 'B', 'O', 'O', 'K', 'C', 'A', 'T', '\0' };
+
+    uint64_t align8(uint64_t offset) {
+        return (offset + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    // дһݲۼУ
+    bool writeSection(FILE* file, const void* data, size_t length, uint32_t& checksum) {
+        if (length == 0) return true;
+        checksum = BookJournal::checksum(static_cast<const char*>(data), length, checksum);
+        return std::fwrite(data, 1, length, file) == length;
+    }
+
+    // 㵽 8 ֽڶ
+    bool writePadding(FILE* file, uint64_t& offset, uint32_t& checksum) {
+        static const char zeros[8] = {};
+        uint64_t aligned = align8(offset);
+        bool ok = writeSection(file, zeros, static_cast<size_t>(aligned - offset), checksum);
+        offset = aligned;
+        return ok;
+    }
+}
+
+void BinaryCatalog::Writer::add(const Book& book) {
+    prices.push_back(book.getPrice());
+    quantities.push_back(book.getQuantity());
+    for (const std::string& value : { book.getISBN(), book.getTitle(), book.getAuthor(),
+        book.getPublisher(), book.getPublishDate() }) {
+        heap += value;
+        offsets.push_back(heap.size());
+    }
+}
+
+bool BinaryCatalog::Writer::write(const std::string& path, std::string& error) const {
+    const size_t count = prices.size();
+    if (count > UINT32_MAX) {
+        error = "ͼʽ";
+        return false;
+    }
+
+    // ISBN  ISBN ͼ
+    auto isbnOf = [this](uint32_t index) {
+        return std::string_view(heap.data() + offsets[index * FieldCount],
+            static_cast<size_t>(offsets[index * FieldCount + 1] - offsets[index * FieldCount]));
+    };
+    std::vector<uint32_t> index(count);
+    for (size_t i = 0; i < count; ++i) index[i] = static_cast<uint32_t>(i);
+    std::sort(index.begin(), index.end(),
+        [&isbnOf](uint32_t a, uint32_t b) { return isbnOf(a) < isbnOf(b); });
+    for (size_t i = 1; i < count; ++i) {
+        if (isbnOf(index[i - 1]) == isbnOf(index[i])) {
+            error = "ISBN " + std::string(isbnOf(index[i])) + " ظ";
+            return false;
+        }
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, catalogMagic, sizeof(catalogMagic));
+    header.version = currentVersion;
+    header.headerSize = sizeof(Header);
+    header.bookCount = count;
+    header.priceOffset = sizeof(Header);
+    header.quantityOffset = header.priceOffset + count * sizeof(double);
+    header.stringOffsetTable = align8(header.quantityOffset + count * sizeof(int32_t));
+    header.isbnIndexOffset = header.stringOffsetTable + offsets.size() * sizeof(uint64_t);
+    header.heapOffset = align8(header.isbnIndexOffset + count * sizeof(uint32_t));
+    header.fileSize = header.heapOffset + heap.size();
+
+    const std::string tmpPath = path + ".tmp";
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        error = "޷ļ " + tmpPath;
+        return false;
+    }
+
+    // ļͷд룺ռλУһ
+    uint32_t checksum = 2166136261u;
+    uint32_t ignored = 0;
+    uint64_t offset = header.quantityOffset;
+    bool ok = writeSection(file, &header, sizeof(header), ignored)
+        && writeSection(file, prices.data(), count * sizeof(double), checksum)
+        && writeSection(file, quantities.data(), count * sizeof(int32_t), checksum);
+    offset += count * sizeof(int32_t);
+    ok = ok && writePadding(file, offset, checksum)
+        && writeSection(file, offsets.data(), offsets.size() * sizeof(uint64_t), checksum)
+        && writeSection(file, index.data(), count * sizeof(uint32_t), checksum);
+    offset = header.isbnIndexOffset + count * sizeof(uint32_t);
+    ok = ok && writePadding(file, offset, checksum)
+        && writeSection(file, heap.data(), heap.size(), checksum);
+
+    header.checksum = checksum;
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0
+        && writeSection(file, &header, sizeof(header), ignored)
+        && std::fflush(file) == 0;
+    if (ok) BookJournal::syncFile(file);
+    std::fclose(file);
+
+    std::error_code ec;
+    if (!ok) {
+        error = "дļ " + tmpPath + " ʧ";
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        error = "޷滻ļ " + path;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryCatalog::open(const std::string& path, std::string& error) {
+    header = nullptr;
+    if (!file.open(path)) {
+        error = "޷ļ " + path;
+        return false;
+    }
+
+    const uint64_t size = file.size();
+    if (size < sizeof(Header) || std::memcmp(file.data(), catalogMagic, sizeof(catalogMagic)) != 0) {
+        error = "ͼĿ¼ļ";
+        return false;
+    }
+    const Header* h = reinterpret_cast<const Header*>(file.data());
+    if (h->version > currentVersion) {
+        error = "Ŀ¼ļ汾 " + std::to_string(h->version) + " ڵǰֵ֧İ汾";
+        return false;
+    }
+
+    // αļڡ˳Ҷ롣ƫļţȷϲļС
+    // üȽγȣӻƺͨ
+    const uint64_t n = h->bookCount;
+    auto fits = [size](uint64_t begin, uint64_t bytes, uint64_t end) {
+        return end <= size && begin <= end && bytes <= end - begin;
+    };
+    bool valid = h->headerSize >= sizeof(Header) && h->headerSize <= size && h->fileSize == size && n <= UINT32_MAX
+        && h->priceOffset >= h->headerSize && h->priceOffset % 8 == 0
+        && h->quantityOffset % sizeof(int32_t) == 0 && h->stringOffsetTable % 8 == 0
+        && h->isbnIndexOffset % sizeof(uint32_t) == 0
+        && fits(h->priceOffset, n * sizeof(double), h->quantityOffset)
+        && fits(h->quantityOffset, n * sizeof(int32_t), h->stringOffsetTable)
+        && fits(h->stringOffsetTable, (n * FieldCount + 1) * sizeof(uint64_t), h->isbnIndexOffset)
+        && fits(h->isbnIndexOffset, n * sizeof(uint32_t), h->heapOffset)
+        && h->heapOffset <= size;
+    if (!valid) {
+        error = "Ŀ¼ļṹ";
+        return false;
+    }
+
+    const char* base = file.data();
+    prices = reinterpret_cast<const double*>(base + h->priceOffset);
+    quantities = reinterpret_cast<const int32_t*>(base + h->quantityOffset);
+    offsets = reinterpret_cast<const uint64_t*>(base + h->stringOffsetTable);
+    isbnIndex = reinterpret_cast<const uint32_t*>(base + h->isbnIndexOffset);
+    heap = base + h->heapOffset;
+    if (offsets[n * FieldCount] > size - h->heapOffset) {
+        error = "Ŀ¼ļṹ";
+        return false;
+    }
+    header = h;
+    return true;
+}
+
+bool BinaryCatalog::verify() const {
+    if (!header) return false;
+    uint32_t checksum = BookJournal::checksum(file.data() + header->headerSize,
+        static_cast<size_t>(header->fileSize - header->headerSize));
+    return checksum == header->checksum;
+}
+
+std::string_view BinaryCatalog::field(size_t index, Field f) const {
+    uint64_t begin = offsets[index * FieldCount + f];
+    uint64_t end = offsets[index * FieldCount + f + 1];
+    uint64_t heapSize = offsets[header->bookCount * FieldCount];
+    if (begin > end || end > heapSize) return std::string_view();  // ƫ
+    return std::string_view(heap + begin, static_cast<size_t>(end - begin));
+}
+
+Book BinaryCatalog::get(size_t index) const {
+    return Book(std::string(field(index, ISBN)), std::string(field(index, Title)),
+        std::string(field(index, Author)), std::string(field(index, Publisher)),
+        std::string(field(index, PublishDate)), price(index), quantity(index));
+}
+
+long long BinaryCatalog::findByISBN(std::string_view isbn) const {
+    size_t low = 0, high = size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        uint32_t book = isbnIndex[mid];
+        if (book >= size()) return -1;  // 
+        int cmp = field(book, ISBN).compare(isbn);
+        if (cmp == 0) return book;
+        if (cmp < 0) low = mid + 1;
+        else high = mid;
+    }
+    return -1;
+}
+
+bool BinaryCatalog::exportFromText(const std::string& textPath, const std::string& catalogPath) {
+    MappedFile text;
+    if (!text.open(textPath)) {
+        std::cerr << "޷ļ " << textPath << "" << std::endl;
+        return false;
+    }
+
+    Writer writer;
+    std::unordered_set<std::string> seen;
+    Book book("", "", "", "", "", 0.0, 0);
+    std::string error;
+    size_t lineNumber = 0, skipped = 0;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        std::string_view line(p, static_cast<size_t>(lineEnd - p));
+        p = nl ? nl + 1 : end;
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        if (!Book::tryParse(line, book, error)) {
+            std::cerr << "棺 " << lineNumber << " " << error << "С" << std::endl;
+            ++skipped;
+            continue;
+        }
+        if (!seen.insert(book.getISBN()).second) {
+            std::cerr << "棺 " << lineNumber << " ISBN " << book.getISBN() << " ظС" << std::endl;
+            ++skipped;
+            continue;
+        }
+        writer.add(book);
+    }
+
+    if (!writer.write(catalogPath, error)) {
+        std::cerr << "" << error << "" << std::endl;
+        return false;
+    }
+    std::cout << "ѵ " << writer.size() << " ͼ鵽 " << catalogPath;
+    if (skipped > 0) std::cout << " " << skipped << " У";
+    std::cout << "" << std::endl;
+    return true;
+}
+
+bool BinaryCatalog::importToText(const std::string& catalogPath, const std::string& textPath) {
+    BinaryCatalog catalog;
+    std::string error;
+    if (!catalog.open(catalogPath, error)) {
+        std::cerr << "" << error << "" << std::endl;
+        return false;
+    }
+    if (!catalog.verify()) {
+        std::cerr << "Ŀ¼ļУͲƥ䣬ļ𻵡" << std::endl;
+        return false;
+    }
+
+    // ıʽ '|' ֶָΡзָͼ飬Щֶַ޷д
+    for (size_t i = 0; i < catalog.size(); ++i) {
+        for (int f = ISBN; f < FieldCount; ++f) {
+            if (catalog.field(i, static_cast<Field>(f)).find_first_of("|\r\n") != std::string_view::npos) {
+                std::cerr << "ISBN " << catalog.field(i, ISBN)
+                    << " ֶκ '|' з޷תΪıʽ" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    const std::string tmpPath = textPath + ".tmp";
+    FILE* file = std::fopen(tmpPath.c_str(), "w");
+    if (!file) {
+        std::cerr << "޷ļ " << tmpPath << "" << std::endl;
+        return false;
+    }
+    std::string line;
+    char number[32];
+    for (size_t i = 0; i < catalog.size(); ++i) {
+        //  Book::toStringλС۸̵Ŀʾ
+        line.clear();
+        for (int f = ISBN; f < FieldCount; ++f) {
+            line += catalog.field(i, static_cast<Field>(f));
+            line += '|';
+        }
+        line.append(number, std::to_chars(number, number + sizeof(number), catalog.price(i)).ptr);
+        line += '|';
+        line += std::to_string(catalog.quantity(i));
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), file);
+    }
+    bool ok = !std::ferror(file);
+    BookJournal::syncFile(file);
+    std::fclose(file);
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, textPath, ec);
+    if (!ok || ec) {
+        std::cerr << "дļ " << textPath << " ʧܡ" << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    std::cout << "ѵ " << catalog.size() << " ͼ鵽 " << textPath << "" << std::endl;
+    return true;
+}
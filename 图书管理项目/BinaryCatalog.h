@@ -0,0 +1,84 @@
+#ifndef BINARY_CATALOG_H
+#define BINARY_CATALOG_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "LibraryManagement.h"
+#include "MappedFile.h"
+
+// ͼĿ¼ļС
+//   ļͷħ汾šͼƫơУ
+//   ۸Уdouble[n]ԭֵ棬ıʽ
+//   Уint32[n]
+//   ַƫƱuint64[5n+1] b  f ֶλ [off[5b+f], off[5b+f+1])
+//   ISBNuint32[n] ISBN ֵеͼţֱӳڴ϶ֲ
+//   ֶַβ
+class BinaryCatalog {
+public:
+    enum Field { ISBN = 0, Title = 1, Author = 2, Publisher = 3, PublishDate = 4, FieldCount = 5 };
+
+    static const uint32_t currentVersion = 1;
+
+    // ļͷ̶ 80 ֽڣ
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t bookCount;
+        uint64_t priceOffset;
+        uint64_t quantityOffset;
+        uint64_t stringOffsetTable;
+        uint64_t isbnIndexOffset;
+        uint64_t heapOffset;
+        uint64_t fileSize;
+        uint32_t checksum;      // ļͷ֮ȫݵ FNV-1a У
+        uint32_t reserved;
+    };
+
+    // ׷Ӻһд
+    class Writer {
+    private:
+        std::vector<double> prices;
+        std::vector<int32_t> quantities;
+        std::vector<uint64_t> offsets{ 0 };
+        std::string heap;
+
+    public:
+        void add(const Book& book);
+        size_t size() const { return prices.size(); }
+        bool write(const std::string& path, std::string& error) const;
+    };
+
+private:
+    MappedFile file;
+    const Header* header = nullptr;
+    const double* prices = nullptr;
+    const int32_t* quantities = nullptr;
+    const uint64_t* offsets = nullptr;
+    const uint32_t* isbnIndex = nullptr;
+    const char* heap = nullptr;
+
+public:
+    // 򿪲УļṹȫļУͼ㣩
+    bool open(const std::string& path, std::string& error);
+
+    // 㲢ȶȫļУ
+    bool verify() const;
+
+    size_t size() const { return header ? static_cast<size_t>(header->bookCount) : 0; }
+    std::string_view field(size_t index, Field f) const;
+    double price(size_t index) const { return prices[index]; }
+    int quantity(size_t index) const { return quantities[index]; }
+    Book get(size_t index) const;
+
+    // ͨǶISBNֲңͼţδҵ -1
+    long long findByISBN(std::string_view isbn) const;
+
+    //  book.txt ıʽתʱ۸ܶͬһ double ʽдسλС
+    // ٵļ۸ԭıֵȫͬ
+    static bool exportFromText(const std::string& textPath, const std::string& catalogPath);
+    static bool importToText(const std::string& catalogPath, const std::string& textPath);
+};
+
+#endif // BINARY_CATALOG_H
@@ -0,0 +1,76 @@
+#include "BookCache.h"
+
+namespace {
+
+// ڵϣڵָ뿪 64 ֽڹ
+constexpr size_t entryOverhead = sizeof(std::string) + 64;
+
+} // namespace
+
+BookCache::Handle BookCache::find(std::string_view isbn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(isbn);
+    if (it == entries.end()) {
+        ++counters.misses;
+        return nullptr;
+    }
+    ++counters.hits;
+    order.splice(order.begin(), order, it->second);
+    return it->second->book;
+}
+
+void BookCache::insert(std::string_view isbn, Handle book, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) return;
+    auto it = entries.find(isbn);
+    if (it != entries.end()) erase(it);  // δʱ󵽵һݸȵ
+
+    order.push_front(Entry{ std::string(isbn), std::move(book), bytes + entryOverhead });
+    entries.emplace(order.front().isbn, order.begin());
+    counters.memoryBytes += order.front().bytes;
+    evictOverflow();
+}
+
+void BookCache::invalidate(std::string_view isbn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(isbn);
+    if (it == entries.end()) return;
+    erase(it);
+    ++counters.invalidations;
+}
+
+void BookCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.invalidations += entries.size();
+    entries.clear();
+    order.clear();
+    counters.memoryBytes = 0;
+}
+
+void BookCache::setCapacity(size_t newCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = newCapacity;
+    evictOverflow();
+}
+
+BookCache::Metrics BookCache::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Metrics result = counters;
+    result.capacity = capacity;
+    result.entries = entries.size();
+    return result;
+}
+
+void BookCache::evictOverflow() {
+    while (entries.size() > capacity) {
+        erase(entries.find(order.back().isbn));
+        ++counters.evictions;
+    }
+}
+
+void BookCache::erase(std::unordered_map<std::string_view, std::list<Entry>::iterator>::iterator it) {
+    auto node = it->second;
+    counters.memoryBytes -= node->bytes;
+    entries.erase(it);   // ɾϣеļŽڵ ISBN
+    order.erase(node);
+}
@@ -0,0 +1,69 @@
+#ifndef BOOK_CACHE_H
+#define BOOK_CACHE_H
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
+class Book;
+
+// ͼ LRU 棺 ISBN 治ɱ Book ÷оڼ䲻̭ʧЧӰ
+// ƣڲڶֻ̼߳乲
+class BookCache {
+public:
+    using Handle = std::shared_ptr<const Book>;
+
+    // ڴռ
+    struct Metrics {
+        size_t capacity = 0;
+        size_t entries = 0;
+        size_t memoryBytes = 0;    // ͼ鼰ڵĹռ
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;      // ̭
+        size_t invalidations = 0;  // ͼ鱻޸ĻɾʧЧ
+
+        double hitRate() const { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+    };
+
+private:
+    struct Entry {
+        std::string isbn;
+        Handle book;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex;
+    std::list<Entry> order;   // ͷΪʹ
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> entries;  //  Entry е ISBN
+    size_t capacity;
+    Metrics counters;
+
+    void evictOverflow();
+    void erase(std::unordered_map<std::string_view, std::list<Entry>::iterator>::iterator it);
+
+public:
+    explicit BookCache(size_t capacity = 4096) : capacity(capacity) {}
+
+    BookCache(const BookCache&) = delete;
+    BookCache& operator=(const BookCache&) = delete;
+
+    // ҲΪʹãδʱؿվ
+    Handle find(std::string_view isbn);
+
+    // һսͼ飬bytes Ϊռ
+    void insert(std::string_view isbn, Handle book, size_t bytes);
+
+    // ͼ鱻޸Ļɾʱ
+    void invalidate(std::string_view isbn);
+    void clear();
+
+    // Ϊ 0 ʱرջ
+    void setCapacity(size_t capacity);
+
+    Metrics metrics() const;
+};
+
+#endif // BOOK_CACHE_H
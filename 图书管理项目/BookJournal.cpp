@@ -0,0 +1,287 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include "BookJournal.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    std::string toHex(uint32_t value) {
+        char buf[9];
+        std::snprintf(buf, sizeof(buf), "%08x", value);
+        return std::string(buf, 8);
+    }
+
+    // ļǰλã64 λ
+    int64_t tell(FILE* f) {
+#ifdef _WIN32
+        return _ftelli64(f);
+#else
+        return static_cast<int64_t>(ftello(f));
+#endif
+    }
+}
+
+BookJournal::BookJournal(std::string path) : path(std::move(path)) {
+}
+
+BookJournal::~BookJournal() {
+    if (file) {
+        sync();
+        std::fclose(file);
+    }
+}
+
+uint32_t BookJournal::checksum(const char* data, size_t length, uint32_t seed) {
+    uint32_t hash = seed;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void BookJournal::syncFile(FILE* f) {
+    std::fflush(f);
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+bool BookJournal::writeHeader(FILE* out, uint32_t snapshotChecksum) const {
+    std::string header = "H|" + toHex(snapshotChecksum) + "\n";
+    return std::fwrite(header.data(), 1, header.size(), out) == header.size();
+}
+
+bool BookJournal::replayFrom(std::istream& in, uint32_t snapshotChecksum, size_t& applied,
+    const std::function<void(const std::string&)>& apply) {
+    std::string line;
+    if (!std::getline(in, line) || in.eof() || line != "H|" + toHex(snapshotChecksum)) return false;
+    int64_t offset = static_cast<int64_t>(line.size() + 1);
+    validLength = offset;
+
+    std::vector<std::string> group;   // ڶȡļ¼
+    size_t groupRemaining = 0;        // ¼δ
+    size_t lines = 0;
+    while (std::getline(in, line)) {
+        // ĩβûлз˵һ¼д벻
+        if (in.eof()) {
+            std::cerr << "棺־ĩβڲȱ¼Ѷ" << std::endl;
+            break;
+        }
+        if (line.size() < recordOverhead || line[8] != ' ' ||
+            toHex(checksum(line.data() + 9, line.size() - 9)) != line.substr(0, 8)) {
+            std::cerr << "棺־¼Уʧܣ֮ļ¼Ѷ" << std::endl;
+            break;
+        }
+        offset += static_cast<int64_t>(line.size() + 1);
+        ++lines;
+
+        if (groupRemaining == 0 && line.compare(9, 2, "B|") == 0) {
+            // ͷ֮¼ȫŻط
+            size_t count = 0;
+            const char* first = line.data() + 11;
+            const char* last = line.data() + line.size();
+            auto result = std::from_chars(first, last, count);
+            if (result.ec != std::errc() || result.ptr != last) {
+                std::cerr << "棺־¼ʽ֮ļ¼Ѷ" << std::endl;
+                break;
+            }
+            group.clear();
+            groupRemaining = count;
+            if (count > 0) continue;
+        }
+        else if (groupRemaining > 0) {
+            group.push_back(line.substr(9));
+            if (--groupRemaining > 0) continue;
+            for (const std::string& record : group) apply(record);
+            applied += group.size();
+        }
+        else {
+            apply(line.substr(9));
+            ++applied;
+        }
+        records = lines;
+        validLength = offset;
+    }
+    if (groupRemaining > 0) {
+        std::cerr << "棺־ĩβļ¼鲻鶪" << std::endl;
+    }
+    return true;
+}
+
+size_t BookJournal::replay(uint32_t snapshotChecksum, const std::function<void(const std::string&)>& apply) {
+    std::lock_guard<std::mutex> lock(mutex);
+    validLength = -1;
+    records = 0;
+    replayedTemp = false;
+
+    size_t applied = 0;
+    std::ifstream in(path, std::ios::binary);
+    if (in.is_open() && replayFrom(in, snapshotChecksum, applied, apply)) return applied;
+
+    // 滻־δ滻־ʱļ
+    std::ifstream tmp(path + ".tmp", std::ios::binary);
+    if (tmp.is_open() && replayFrom(tmp, snapshotChecksum, applied, apply)) {
+        replayedTemp = true;
+        return applied;
+    }
+    if (in.is_open()) {
+        std::cerr << "棺־ļݿղƥ䣬Ѻԡ" << std::endl;
+    }
+    return 0;
+}
+
+bool BookJournal::open(uint32_t snapshotChecksum) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) return true;
+
+    std::error_code ec;
+    if (replayedTemp) {
+        std::filesystem::rename(path + ".tmp", path, ec);
+        if (ec) validLength = -1;
+        replayedTemp = false;
+    }
+    if (validLength >= 0 && std::filesystem::exists(path, ec)) {
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(validLength), ec);
+        if (!ec) {
+            file = std::fopen(path.c_str(), "ab");
+            if (file) {
+                length = validLength;
+                return true;
+            }
+        }
+    }
+
+    // ־ڻЧԵǰΪ׼´
+    records = 0;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file || !writeHeader(file, snapshotChecksum)) {
+        std::cerr << "޷־ļ " << path << "" << std::endl;
+        return false;
+    }
+    syncFile(file);
+    validLength = length = tell(file);
+    return true;
+}
+
+bool BookJournal::writeRecords(const std::string& lines, size_t count) {
+    if (!file) return false;
+    if (std::fwrite(lines.data(), 1, lines.size(), file) != lines.size()) {
+        return false;
+    }
+    // ÿ¼ϵͳ̰ύ
+    std::fflush(file);
+    length += static_cast<int64_t>(lines.size());
+    records += count;
+    pending += count;
+    return true;
+}
+
+bool BookJournal::append(const std::string& record) {
+    std::string line = toHex(checksum(record.data(), record.size()));
+    line += ' ';
+    line += record;
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!writeRecords(line, 1)) return false;
+    if (pending >= syncInterval) {
+        syncLocked();
+    }
+    return true;
+}
+
+bool BookJournal::appendGroup(const std::vector<std::string>& group) {
+    // ͷڼ¼һд
+    std::string lines;
+    auto addLine = [&lines](const std::string& record) {
+        lines += toHex(checksum(record.data(), record.size()));
+        lines += ' ';
+        lines += record;
+        lines += '\n';
+    };
+    addLine("B|" + std::to_string(group.size()));
+    for (const std::string& record : group) addLine(record);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!writeRecords(lines, group.size() + 1)) return false;
+    syncLocked();
+    return true;
+}
+
+void BookJournal::sync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    syncLocked();
+}
+
+void BookJournal::syncLocked() {
+    if (!file || pending == 0) return;
+    syncFile(file);
+    pending = 0;
+}
+
+BookJournal::Mark BookJournal::mark() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Mark{ length, records };
+}
+
+size_t BookJournal::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+bool BookJournal::rotate(uint32_t snapshotChecksum, const Mark& since, const std::function<bool()>& install) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::string tmpPath = path + ".tmp";
+    FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out) return false;
+
+    // ־¿յͷȡ֮׷ӵļ¼ѽϵͳԴļ
+    bool ok = writeHeader(out, snapshotChecksum);
+    int64_t tailLength = length - since.offset;
+    if (ok && tailLength > 0) {
+        std::ifstream in(path, std::ios::binary);
+        in.seekg(static_cast<std::streamoff>(since.offset));
+        std::vector<char> buffer(static_cast<size_t>(std::min<int64_t>(tailLength, 1 << 20)));
+        for (int64_t remaining = tailLength; ok && remaining > 0;) {
+            size_t chunk = static_cast<size_t>(std::min<int64_t>(remaining, static_cast<int64_t>(buffer.size())));
+            ok = static_cast<bool>(in.read(buffer.data(), static_cast<std::streamsize>(chunk)))
+                && std::fwrite(buffer.data(), 1, chunk, out) == chunk;
+            remaining -= static_cast<int64_t>(chunk);
+        }
+    }
+    ok = ok && !std::ferror(out);
+    syncFile(out);
+    int64_t newLength = tell(out);
+    std::fclose(out);
+
+    std::error_code ec;
+    if (!ok || !install()) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    // 滻˿жʱطŻʱ־
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) return false;   // ٽ׷ӣ޸Ļᱨдϵ־
+
+    file = std::fopen(path.c_str(), "ab");
+    length = newLength;
+    records -= std::min(records, since.records);
+    pending = 0;   // β¼ʱ־
+    return file != nullptr;
+}
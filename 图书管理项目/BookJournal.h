@@ -0,0 +1,93 @@
+#ifndef BOOK_JOURNAL_H
+#define BOOK_JOURNAL_H
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <mutex>
+
+// ͼ־׷дԤд־
+// ļʽΪ "H|<У>"֮ÿһ¼ "<У> <>"
+// Ϊ "B|<>" ļ¼ʼһ¼飬¼طʱЧ鶪
+// ڲ޸߳׷Ӽ¼ͬʱ̨߳̿л־rotate
+class BookJournal {
+public:
+    // ־еλãȡʱ£֮ǰļ¼ѰڿС
+    // ƫ볤 int64_tMSVC  long ֻ 32 λ־ 2 GB ʱ
+    struct Mark {
+        int64_t offset = 0;
+        size_t records = 0;
+    };
+
+private:
+    std::string path;          // ־ļ·
+    mutable std::mutex mutex;
+    FILE* file = nullptr;      // ׷д
+    size_t records = 0;        // ǰ־еļ¼¼ͷ
+    size_t pending = 0;        // δ̵ļ¼
+    size_t syncInterval = 8;   // ÿۼƶ¼ִһ̣ύ
+    int64_t validLength = -1;  // طʱȷЧ־ȣ-1 ʾ־
+    int64_t length = 0;        // ǰ־ļĳ
+    bool replayedTemp = false; // طŵлһµʱ־
+
+    bool writeHeader(FILE* out, uint32_t snapshotChecksum) const;
+    bool writeRecords(const std::string& lines, size_t count);
+    void syncLocked();
+
+    //  in طţͷղʱ false
+    bool replayFrom(std::istream& in, uint32_t snapshotChecksum, size_t& applied,
+        const std::function<void(const std::string&)>& apply);
+
+public:
+    explicit BookJournal(std::string path);
+    ~BookJournal();
+
+    BookJournal(const BookJournal&) = delete;
+    BookJournal& operator=(const BookJournal&) = delete;
+
+    // ط־ͷУһʱصЧ¼ȱ¼ļ¼鼴ֹͣ
+    // ־ղʱ־ʱ滻պ滻־ǰжϣطʱ־ػطŵļ¼
+    size_t replay(uint32_t snapshotChecksum, const std::function<void(const std::string&)>& apply);
+
+    // ־׷ӣصȱβ־Чʱ´
+    bool open(uint32_t snapshotChecksum);
+
+    // ׷һ¼
+    bool append(const std::string& record);
+
+    // ׷һ¼̣طʱҪôȫЧҪôȫ
+    bool appendGroup(const std::vector<std::string>& group);
+
+    // ļ¼ǿ
+    void sync();
+
+    // ǰλã֮ rotate
+    Mark mark() const;
+
+    // дúл־дʱ־ͷΪ¿յУͣ since ֮׷ӵļ¼̣
+    // ٵ install 滻ļ滻־лڼ׷ӵļ¼ȴлɣ
+    // install ʧʱԭ־ false
+    bool rotate(uint32_t snapshotChecksum, const Mark& since, const std::function<bool()>& install);
+
+    size_t recordCount() const;
+    // طʱЧ־ֽ
+    size_t replayedBytes() const { return validLength > 0 ? static_cast<size_t>(validLength) : 0; }
+    void setSyncInterval(size_t interval) { syncInterval = interval == 0 ? 1 : interval; }
+
+    // ÿ¼ļжռõֽڣ8 λʮУ͡ո뻻
+    static constexpr size_t recordOverhead = 10;
+
+    // FNV-1a У
+    static uint32_t checksum(const char* data, size_t length, uint32_t seed = 2166136261u);
+
+    // УͣУֿ֮ͣ鷽ʽ޹أɲмϲ
+    static uint32_t addSnapshotLine(uint32_t acc, const char* line, size_t length) {
+        return acc + checksum(line, length);
+    }
+
+    // ļ
+    static void syncFile(FILE* f);
+};
+
+#endif // BOOK_JOURNAL_H
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "BookStore.h"
+
+void BookStore::SlotTable::rehash(size_t bucketCount) {
+    std::vector<Bucket> old(bucketCount, Bucket{ 0, emptySlot });
+    old.swap(buckets);
+    for (const Bucket& bucket : old) {
+        if (bucket.slot == emptySlot) continue;
+        size_t i = bucket.hash & mask();
+        while (buckets[i].slot != emptySlot) i = (i + 1) & mask();
+        buckets[i] = bucket;
+    }
+}
+
+void BookStore::SlotTable::insert(uint32_t hash, uint32_t slot) {
+    if ((count + 1) * 2 > buckets.size()) rehash(std::max<size_t>(16, buckets.size() * 2));
+    size_t i = hash & mask();
+    while (buckets[i].slot != emptySlot) i = (i + 1) & mask();
+    buckets[i] = Bucket{ hash, slot };
+    ++count;
+}
+
+void BookStore::SlotTable::erase(uint32_t hash, uint32_t slot) {
+    size_t i = hash & mask();
+    while (buckets[i].slot != slot) i = (i + 1) & mask();
+    // ɾ̽ϺͰǰλĹ
+    for (size_t j = (i + 1) & mask(); buckets[j].slot != emptySlot; j = (j + 1) & mask()) {
+        size_t home = buckets[j].hash & mask();
+        bool between = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (between) continue;
+        buckets[i] = buckets[j];
+        i = j;
+    }
+    buckets[i].slot = emptySlot;
+    --count;
+}
+
+void BookStore::SlotTable::relabel(uint32_t hash, uint32_t from, uint32_t to) {
+    size_t i = hash & mask();
+    while (buckets[i].slot != from) i = (i + 1) & mask();
+    buckets[i].slot = to;
+}
+
+void BookStore::SlotTable::reserve(size_t entries) {
+    size_t bucketCount = 16;
+    while (bucketCount < entries * 2) bucketCount *= 2;
+    if (bucketCount > buckets.size()) rehash(bucketCount);
+}
+
+BookStore::StringRef BookStore::StringArena::append(std::string_view text) {
+    if (chunks.empty() || used + text.size() > chunkCapacity.back()) {
+        // ַռһ
+        size_t capacity = std::max(chunkSize, text.size());
+        chunks.emplace_back(new char[capacity]);
+        chunkCapacity.push_back(capacity);
+        totalBytes += capacity;
+        used = 0;
+    }
+    StringRef ref;
+    ref.chunk = static_cast<uint32_t>(chunks.size() - 1);
+    ref.offset = static_cast<uint32_t>(used);
+    ref.length = static_cast<uint32_t>(text.size());
+    if (!text.empty()) {
+        std::memcpy(chunks.back().get() + used, text.data(), text.size());
+    }
+    used += text.size();
+    return ref;
+}
+
+uint32_t BookStore::Dictionary::acquire(StringArena& arena, std::string_view text, size_t& deadBytes) {
+    uint32_t hash = hashOf(text);
+    uint32_t code = codes.find(hash, [&](uint32_t candidate) { return arena.view(values[candidate]) == text; });
+    if (code == UINT32_MAX) {
+        code = static_cast<uint32_t>(values.size());
+        values.push_back(arena.append(text));
+        refs.push_back(0);
+        codes.insert(hash, code);
+    }
+    else if (refs[code] == 0) {
+        deadBytes -= values[code].length;
+    }
+    if (refs[code]++ == 0) ++usedValues;
+    return code;
+}
+
+void BookStore::Dictionary::release(uint32_t code, size_t& deadBytes) {
+    if (--refs[code] == 0) {
+        deadBytes += values[code].length;
+        --usedValues;
+    }
+}
+
+size_t BookStore::Dictionary::memoryUsage() const {
+    return values.capacity() * sizeof(StringRef) + refs.capacity() * sizeof(uint32_t) + codes.memoryUsage();
+}
+
+uint32_t BookStore::hashOf(std::string_view text) {
+    uint64_t hash = std::hash<std::string_view>()(text);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+void BookStore::reserve(size_t count) {
+    isbns.reserve(count);
+    titles.reserve(count);
+    authorCodes.reserve(count);
+    publisherCodes.reserve(count);
+    publishDates.reserve(count);
+    prices.reserve(count);
+    quantities.reserve(count);
+    vacant.reserve(count);
+    isbnSlots.reserve(count);
+}
+
+size_t BookStore::find(std::string_view isbn) const {
+    uint32_t slot = isbnSlots.find(hashOf(isbn), [&](uint32_t index) { return this->isbn(index) == isbn; });
+    return slot == UINT32_MAX ? npos : slot;
+}
+
+size_t BookStore::push_back(std::string_view isbn, std::string_view title, std::string_view author,
+    std::string_view publisher, std::string_view publishDate, double price, int quantity) {
+    size_t slot = slotCount();
+    isbnSlots.insert(hashOf(isbn), static_cast<uint32_t>(slot));
+    isbns.push_back(arena.append(isbn));
+    titles.push_back(arena.append(title));
+    authorCodes.push_back(authors.acquire(arena, author, deadBytes));
+    publisherCodes.push_back(publishers.acquire(arena, publisher, deadBytes));
+    publishDates.push_back(arena.append(publishDate));
+    prices.push_back(price);
+    quantities.push_back(quantity);
+    vacant.push_back(0);
+    return slot;
+}
+
+void BookStore::set(size_t index, std::string_view isbn, std::string_view title, std::string_view author,
+    std::string_view publisher, std::string_view publishDate, double price, int quantity) {
+    // δıַԭλãı׷дλ
+    if (this->isbn(index) != isbn) {
+        isbnSlots.erase(hashOf(this->isbn(index)), static_cast<uint32_t>(index));
+        isbnSlots.insert(hashOf(isbn), static_cast<uint32_t>(index));
+        deadBytes += isbns[index].length;
+        isbns[index] = arena.append(isbn);
+    }
+    if (this->title(index) != title) {
+        deadBytes += titles[index].length;
+        titles[index] = arena.append(title);
+    }
+    if (this->publishDate(index) != publishDate) {
+        deadBytes += publishDates[index].length;
+        publishDates[index] = arena.append(publishDate);
+    }
+    // ȡ±ͷžɱ룬ȡֵδʱ
+    uint32_t authorCode = authors.acquire(arena, author, deadBytes);
+    authors.release(authorCodes[index], deadBytes);
+    authorCodes[index] = authorCode;
+    uint32_t publisherCode = publishers.acquire(arena, publisher, deadBytes);
+    publishers.release(publisherCodes[index], deadBytes);
+    publisherCodes[index] = publisherCode;
+    prices[index] = price;
+    quantities[index] = quantity;
+    compactIfNeeded();
+}
+
+void BookStore::erase(size_t index) {
+    isbnSlots.erase(hashOf(isbn(index)), static_cast<uint32_t>(index));
+    deadBytes += isbns[index].length + titles[index].length + publishDates[index].length;
+    authors.release(authorCodes[index], deadBytes);
+    publishers.release(publisherCodes[index], deadBytes);
+    vacant[index] = 1;
+    ++vacantCount;
+    compactIfNeeded();
+}
+
+std::vector<uint32_t> BookStore::compactSlots() {
+    std::vector<uint32_t> remap(slotCount(), UINT32_MAX);
+    size_t next = 0;
+    for (size_t i = 0; i < slotCount(); ++i) {
+        if (vacant[i]) continue;
+        remap[i] = static_cast<uint32_t>(next);
+        if (next != i) {
+            isbnSlots.relabel(hashOf(isbn(i)), static_cast<uint32_t>(i), static_cast<uint32_t>(next));
+            isbns[next] = isbns[i];
+            titles[next] = titles[i];
+            authorCodes[next] = authorCodes[i];
+            publisherCodes[next] = publisherCodes[i];
+            publishDates[next] = publishDates[i];
+            prices[next] = prices[i];
+            quantities[next] = quantities[i];
+        }
+        ++next;
+    }
+    isbns.resize(next);
+    titles.resize(next);
+    authorCodes.resize(next);
+    publisherCodes.resize(next);
+    publishDates.resize(next);
+    prices.resize(next);
+    quantities.resize(next);
+    vacant.assign(next, 0);
+    vacantCount = 0;
+    return remap;
+}
+
+BookStore::NumericColumns BookStore::numericColumns(std::vector<double>& priceScratch,
+    std::vector<int>& quantityScratch) const {
+    if (vacantCount == 0) return NumericColumns{ prices.data(), quantities.data(), prices.size() };
+    priceScratch.clear();
+    quantityScratch.clear();
+    priceScratch.reserve(size());
+    quantityScratch.reserve(size());
+    for (size_t i = 0; i < slotCount(); ++i) {
+        if (vacant[i]) continue;
+        priceScratch.push_back(prices[i]);
+        quantityScratch.push_back(quantities[i]);
+    }
+    return NumericColumns{ priceScratch.data(), quantityScratch.data(), priceScratch.size() };
+}
+
+BookStore::Snapshot BookStore::snapshot() const {
+    Snapshot copy;
+    copy.chunks.assign(arena.blocks().begin(), arena.blocks().end());
+    copy.authorValues = authors.allValues();
+    copy.publisherValues = publishers.allValues();
+    copy.isbns = isbns;
+    copy.titles = titles;
+    copy.authorCodes = authorCodes;
+    copy.publisherCodes = publisherCodes;
+    copy.publishDates = publishDates;
+    copy.prices = prices;
+    copy.quantities = quantities;
+    copy.vacant = vacant;
+    copy.liveCount = size();
+    return copy;
+}
+
+void BookStore::clear() {
+    // 滻Ϊմ洢к͹ϣͷһΣַذ 1MB Ŀͷ
+    *this = BookStore();
+}
+
+void BookStore::compactIfNeeded() {
+    const size_t minimum = 1 << 20;
+    if (deadBytes >= minimum && deadBytes * 2 > arena.allocatedBytes()) compact();
+}
+
+void BookStore::compact() {
+    // ISBN ұֻ±͹ϣǰ󲻱
+    StringArena fresh;
+    Dictionary freshAuthors;
+    Dictionary freshPublishers;
+    std::vector<uint32_t> authorMap(authors.codeCount(), UINT32_MAX);
+    std::vector<uint32_t> publisherMap(publishers.codeCount(), UINT32_MAX);
+    size_t freshDeadBytes = 0;
+    for (size_t i = 0; i < slotCount(); ++i) {
+        if (vacant[i]) {
+            // λþַ
+            isbns[i] = titles[i] = publishDates[i] = StringRef();
+            authorCodes[i] = publisherCodes[i] = 0;
+            continue;
+        }
+        // ͬһֶڴ
+        isbns[i] = fresh.append(arena.view(isbns[i]));
+        titles[i] = fresh.append(arena.view(titles[i]));
+        publishDates[i] = fresh.append(arena.view(publishDates[i]));
+        uint32_t& author = authorMap[authorCodes[i]];
+        if (author == UINT32_MAX) author = freshAuthors.acquire(fresh, arena.view(authors.value(authorCodes[i])), freshDeadBytes);
+        else freshAuthors.retain(author);
+        authorCodes[i] = author;
+        uint32_t& publisher = publisherMap[publisherCodes[i]];
+        if (publisher == UINT32_MAX) publisher = freshPublishers.acquire(fresh, arena.view(publishers.value(publisherCodes[i])), freshDeadBytes);
+        else freshPublishers.retain(publisher);
+        publisherCodes[i] = publisher;
+    }
+    arena = std::move(fresh);
+    authors = std::move(freshAuthors);
+    publishers = std::move(freshPublishers);
+    deadBytes = 0;
+}
+
+size_t BookStore::memoryUsage() const {
+    return arena.allocatedBytes() + isbnSlots.memoryUsage()
+        + authors.memoryUsage() + publishers.memoryUsage()
+        + (isbns.capacity() + titles.capacity() + publishDates.capacity()) * sizeof(StringRef)
+        + (authorCodes.capacity() + publisherCodes.capacity()) * sizeof(uint32_t)
+        + prices.capacity() * sizeof(double)
+        + quantities.capacity() * sizeof(int)
+        + vacant.capacity();
+}
@@ -0,0 +1,218 @@
+#ifndef BOOK_STORE_H
+#define BOOK_STORE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// ʽͼ洢۸Уֶַδڷַֿ
+// ֻ棨, ƫ, ȣظȸߣֵ롣
+// ISBN ұֵĹϣֻ±ַ꣬洢û𱾵Ķѷ䣻
+// ޸ĺɾµķֽڳַһʱһַء
+// ÿռһλλ˳УɾֻѲλΪλO(1)
+// ͼĲλ䣬λ compactSlots() ԭ˳ѹʵ
+class BookStore {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    // ַеһַ
+    struct StringRef {
+        uint32_t chunk = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    // Ѱַϣ̽⣩Ͱֻйϣֵ±꣬ıȽϽ÷
+    class SlotTable {
+    private:
+        struct Bucket {
+            uint32_t hash;
+            uint32_t slot;
+        };
+        static constexpr uint32_t emptySlot = UINT32_MAX;
+        std::vector<Bucket> buckets;   // ͰΪ 2 ݣװʲ 1/2
+        size_t count = 0;
+
+        size_t mask() const { return buckets.size() - 1; }
+        void rehash(size_t bucketCount);
+
+    public:
+        //  equal(slot) Ϊ±꣬δҵ emptySlot
+        template <typename Equal>
+        uint32_t find(uint32_t hash, Equal equal) const {
+            if (buckets.empty()) return emptySlot;
+            for (size_t i = hash & mask();; i = (i + 1) & mask()) {
+                const Bucket& bucket = buckets[i];
+                if (bucket.slot == emptySlot) return emptySlot;
+                if (bucket.hash == hash && equal(bucket.slot)) return bucket.slot;
+            }
+        }
+        void insert(uint32_t hash, uint32_t slot);
+        void erase(uint32_t hash, uint32_t slot);
+        void relabel(uint32_t hash, uint32_t from, uint32_t to);
+        void reserve(size_t entries);
+        size_t memoryUsage() const { return buckets.capacity() * sizeof(Bucket); }
+    };
+
+    // ַֿأֻ׷ӣдַַݱֲ䣻鰴üտԼбĿ
+    class StringArena {
+    private:
+        static constexpr size_t chunkSize = 1 << 20;
+        std::vector<std::shared_ptr<char[]>> chunks;
+        std::vector<size_t> chunkCapacity;
+        size_t used = 0;            // һʹõֽ
+        size_t totalBytes = 0;      // ѷֽ
+
+    public:
+        // ƺַػͬһĿв׷ӣֻƶ
+        StringArena() = default;
+        StringArena(const StringArena&) = delete;
+        StringArena& operator=(const StringArena&) = delete;
+        StringArena(StringArena&&) = default;
+        StringArena& operator=(StringArena&&) = default;
+
+        StringRef append(std::string_view text);
+        std::string_view view(StringRef ref) const {
+            return std::string_view(chunks[ref.chunk].get() + ref.offset, ref.length);
+        }
+        size_t allocatedBytes() const { return totalBytes; }
+        const std::vector<std::shared_ptr<char[]>>& blocks() const { return chunks; }
+    };
+
+    // ֵУ¼ÿȡֵٱãùȡֵֽڣַʱ
+    class Dictionary {
+    private:
+        std::vector<StringRef> values;
+        std::vector<uint32_t> refs;
+        SlotTable codes;
+        size_t usedValues = 0;   // Ϊȡֵ
+
+    public:
+        // ȡ text ı벢һãѹȡֵʱ deadBytes пۻ
+        uint32_t acquire(StringArena& arena, std::string_view text, size_t& deadBytes);
+        void retain(uint32_t code) { ++refs[code]; }   // code ǰһ
+        void release(uint32_t code, size_t& deadBytes);
+        StringRef value(uint32_t code) const { return values[code]; }
+        const std::vector<StringRef>& allValues() const { return values; }
+        size_t size() const { return usedValues; }
+        size_t codeCount() const { return values.size(); }
+        size_t memoryUsage() const;
+    };
+
+    StringArena arena;
+    Dictionary authors;
+    Dictionary publishers;
+
+    std::vector<StringRef> isbns;
+    std::vector<StringRef> titles;
+    std::vector<uint32_t> authorCodes;
+    std::vector<uint32_t> publisherCodes;
+    std::vector<StringRef> publishDates;
+    std::vector<double> prices;
+    std::vector<int> quantities;
+    std::vector<uint8_t> vacant;   // 1 ʾòλͼɾ
+    size_t vacantCount = 0;
+    SlotTable isbnSlots;    // ISBN -> λ
+
+    size_t deadBytes = 0;   // ǻɾõַֽ
+
+    static uint32_t hashOf(std::string_view text);
+    // ֽڳַһʱɴǰ޸ķ̯
+    void compactIfNeeded();
+
+public:
+    // ĳһʱ̵ֻȡúɽ̶߳ȡ֮޸ġӰ죺
+    // аֵƣÿԼ 60 ֽڣַƣ洢ַصĿ
+    class Snapshot {
+        friend class BookStore;
+
+        std::vector<std::shared_ptr<const char[]>> chunks;
+        std::vector<StringRef> authorValues;
+        std::vector<StringRef> publisherValues;
+        std::vector<StringRef> isbns;
+        std::vector<StringRef> titles;
+        std::vector<uint32_t> authorCodes;
+        std::vector<uint32_t> publisherCodes;
+        std::vector<StringRef> publishDates;
+        std::vector<double> prices;
+        std::vector<int> quantities;
+        std::vector<uint8_t> vacant;
+        size_t liveCount = 0;
+
+        std::string_view view(StringRef ref) const {
+            return std::string_view(chunks[ref.chunk].get() + ref.offset, ref.length);
+        }
+
+    public:
+        size_t size() const { return liveCount; }
+        size_t slotCount() const { return prices.size(); }
+        bool contains(size_t index) const { return !vacant[index]; }
+
+        std::string_view isbn(size_t index) const { return view(isbns[index]); }
+        std::string_view title(size_t index) const { return view(titles[index]); }
+        std::string_view author(size_t index) const { return view(authorValues[authorCodes[index]]); }
+        std::string_view publisher(size_t index) const { return view(publisherValues[publisherCodes[index]]); }
+        std::string_view publishDate(size_t index) const { return view(publishDates[index]); }
+        double price(size_t index) const { return prices[index]; }
+        int quantity(size_t index) const { return quantities[index]; }
+    };
+
+    Snapshot snapshot() const;
+
+    // ͼ
+    size_t size() const { return prices.size() - vacantCount; }
+    bool empty() const { return size() == 0; }
+    void reserve(size_t count);
+
+    // λλ [0, slotCount()) ʱ contains() λ
+    size_t slotCount() const { return prices.size(); }
+    bool contains(size_t index) const { return !vacant[index]; }
+    size_t vacantSlots() const { return vacantCount; }
+
+    // ׷һ飬Ĳλ
+    size_t push_back(std::string_view isbn, std::string_view title, std::string_view author,
+        std::string_view publisher, std::string_view publishDate, double price, int quantity);
+    void set(size_t index, std::string_view isbn, std::string_view title, std::string_view author,
+        std::string_view publisher, std::string_view publishDate, double price, int quantity);
+    void erase(size_t index);   // λΪλͼĲλ
+
+    // ԭ˳ѹʵλؾɲλ²λӳ䣨λӳΪ UINT32_MAXӳ䵥
+    std::vector<uint32_t> compactSlots();
+
+    // ͷȫͼ飺ַ黹ͷ
+    void clear();
+
+    //  ISBN ±꣬δҵ npos
+    size_t find(std::string_view isbn) const;
+
+    // ʹõַᵽµַУֽ벻õߡ
+    void compact();
+
+    // ֶηʣصͼһ޸Ĵ洢ǰЧ޸Ŀַܴ
+    std::string_view isbn(size_t index) const { return arena.view(isbns[index]); }
+    std::string_view title(size_t index) const { return arena.view(titles[index]); }
+    std::string_view author(size_t index) const { return arena.view(authors.value(authorCodes[index])); }
+    std::string_view publisher(size_t index) const { return arena.view(publishers.value(publisherCodes[index])); }
+    std::string_view publishDate(size_t index) const { return arena.view(publishDates[index]); }
+    double price(size_t index) const { return prices[index]; }
+    int quantity(size_t index) const { return quantities[index]; }
+
+    // ͼ۸Уͳɨʹã
+    // ûпλʱֱָ洢ѴֵƵ priceScratchquantityScratch 
+    struct NumericColumns {
+        const double* prices;
+        const int* quantities;
+        size_t count;
+    };
+    NumericColumns numericColumns(std::vector<double>& priceScratch, std::vector<int>& quantityScratch) const;
+
+    // ڴռãֽڣ
+    size_t memoryUsage() const;
+    size_t wastedBytes() const { return deadBytes; }
+    size_t distinctAuthors() const { return authors.size(); }
+    size_t distinctPublishers() const { return publishers.size(); }
+};
+
+#endif // BOOK_STORE_H
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "CatalogStatistics.h"
+
+const std::vector<int>& CatalogStatistics::quantityBounds() {
+    static const std::vector<int> bounds = { 0, 1, 10, 50, 100 };
+    return bounds;
+}
+
+long long CatalogStatistics::toCents(double price, int quantity) {
+    if (!std::isfinite(price) || quantity == 0) return 0;
+    //  double жϷΧΧڵĳ˻Ǿȷ
+    double cents = std::round(price * 100.0);
+    double total = cents * quantity;
+    if (total >= static_cast<double>(maxValueCents)) return maxValueCents;
+    if (total <= -static_cast<double>(maxValueCents)) return -maxValueCents;
+    return static_cast<long long>(cents) * quantity;
+}
+
+size_t CatalogStatistics::bucketOf(int quantity) {
+    const std::vector<int>& bounds = quantityBounds();
+    size_t bucket = static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), quantity) - bounds.begin());
+    return bucket == 0 ? 0 : bucket - 1;
+}
+
+size_t CatalogStatistics::targetRank(double q, size_t count) {
+    return static_cast<size_t>(q * static_cast<double>(count - 1));
+}
+
+void CatalogStatistics::settle(QuantileCursor& cursor) {
+    size_t target = targetRank(cursor.q, priceOrder->size());
+    while (cursor.rank < target) {
+        ++cursor.position;
+        ++cursor.rank;
+    }
+    while (cursor.rank > target) {
+        --cursor.position;
+        --cursor.rank;
+    }
+}
+
+void CatalogStatistics::adjust(std::unordered_map<std::string, Rollup>& rollups, std::string_view key,
+    long long copies, long long valueCents, int sign) {
+    auto it = rollups.find(std::string(key));
+    if (it == rollups.end()) {
+        if (sign < 0) return;
+        it = rollups.emplace(std::string(key), Rollup()).first;
+    }
+    Rollup& rollup = it->second;
+    rollup.books += sign;
+    rollup.copies += sign * copies;
+    rollup.valueCents += sign * valueCents;
+    if (rollup.books == 0) rollups.erase(it);
+}
+
+void CatalogStatistics::add(std::string_view isbn, std::string_view author, std::string_view publisher,
+    double price, int quantity) {
+    long long cents = toCents(price, quantity);
+    ++books;
+    copies += quantity;
+    valueCents += cents;
+    auto inserted = priceOrder->emplace(price, isbn);
+    if (inserted.second) {
+        for (QuantileCursor& cursor : cursors) {
+            if (priceOrder->size() == 1) {
+                cursor.position = inserted.first;
+                cursor.rank = 0;
+                continue;
+            }
+            // α֮ǰĽڵʹακһλ
+            if (priceOrder->key_comp()(*inserted.first, *cursor.position)) ++cursor.rank;
+            settle(cursor);
+        }
+    }
+    ++quantityBuckets[bucketOf(quantity)];
+    adjust(byPublisher, publisher, quantity, cents, 1);
+    adjust(byAuthor, author, quantity, cents, 1);
+}
+
+void CatalogStatistics::remove(std::string_view isbn, std::string_view author, std::string_view publisher,
+    double price, int quantity) {
+    long long cents = toCents(price, quantity);
+    --books;
+    copies -= quantity;
+    valueCents -= cents;
+    auto erased = priceOrder->find(std::make_pair(price, std::pmr::string(isbn)));
+    if (erased != priceOrder->end()) {
+        // α뿪ҪɾĽڵ㣨Ƶ̣β䣻ûкʱƵǰɾٹλ
+        bool last = priceOrder->size() == 1;
+        for (QuantileCursor& cursor : cursors) {
+            if (last) continue;
+            if (cursor.position == erased) {
+                if (std::next(cursor.position) != priceOrder->end()) {
+                    ++cursor.position;
+                }
+                else {
+                    --cursor.position;
+                    --cursor.rank;
+                }
+            }
+            else if (priceOrder->key_comp()(*erased, *cursor.position)) {
+                --cursor.rank;
+            }
+        }
+        priceOrder->erase(erased);
+        if (!last) {
+            for (QuantileCursor& cursor : cursors) settle(cursor);
+        }
+    }
+    --quantityBuckets[bucketOf(quantity)];
+    adjust(byPublisher, publisher, quantity, cents, -1);
+    adjust(byAuthor, author, quantity, cents, -1);
+}
+
+void CatalogStatistics::clear() {
+    *this = CatalogStatistics();
+}
+
+bool CatalogStatistics::maxPrice(double& price, std::string& isbn) const {
+    if (priceOrder->empty()) return false;
+    // ͬʱȡ ISBN Сһ
+    auto it = priceOrder->lower_bound(std::make_pair(priceOrder->rbegin()->first, std::pmr::string()));
+    price = it->first;
+    isbn.assign(it->second.data(), it->second.size());
+    return true;
+}
+
+bool CatalogStatistics::minPrice(double& price, std::string& isbn) const {
+    if (priceOrder->empty()) return false;
+    price = priceOrder->begin()->first;
+    isbn.assign(priceOrder->begin()->second.data(), priceOrder->begin()->second.size());
+    return true;
+}
+
+double CatalogStatistics::pricePercentile(double q) const {
+    size_t count = priceOrder->size();
+    if (count == 0) return 0.0;
+    q = std::min(1.0, std::max(0.0, q));
+
+    //  lo ڵ˻ĳα
+    double rank = q * static_cast<double>(count - 1);
+    size_t lo = static_cast<size_t>(rank);
+    PriceOrder::const_iterator position = priceOrder->begin();
+    size_t at = 0;
+    if (count - 1 - lo < lo) {
+        position = std::prev(priceOrder->end());
+        at = count - 1;
+    }
+    for (const QuantileCursor& cursor : cursors) {
+        size_t distance = cursor.rank > lo ? cursor.rank - lo : lo - cursor.rank;
+        size_t best = at > lo ? at - lo : lo - at;
+        if (distance < best) {
+            position = cursor.position;
+            at = cursor.rank;
+        }
+    }
+    for (; at < lo; ++at) ++position;
+    for (; at > lo; --at) --position;
+
+    // Բֵڵ lo  lo+1 ۸֮ȡֵ
+    double low = position->first;
+    if (lo + 1 >= count) return low;
+    double high = std::next(position)->first;
+    return low + (high - low) * (rank - static_cast<double>(lo));
+}
+
+bool CatalogStatistics::operator==(const CatalogStatistics& other) const {
+    return books == other.books && copies == other.copies && valueCents == other.valueCents
+        && *priceOrder == *other.priceOrder && quantityBuckets == other.quantityBuckets
+        && byPublisher == other.byPublisher && byAuthor == other.byAuthor && sameCursors(other);
+}
+
+bool CatalogStatistics::sameCursors(const CatalogStatistics& other) const {
+    if (priceOrder->empty()) return true;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (cursors[i].rank != other.cursors[i].rank || *cursors[i].position != *other.cursors[i].position) return false;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef CATALOG_STATISTICS_H
+#define CATALOG_STATISTICS_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <memory_resource>
+#include "PooledObject.h"
+
+// άͳƻ棺ɾʱ O(1)  O(log n) £ѯ۸λ P90Ϊʱ
+// ۼƣⷴӼ
+class CatalogStatistics {
+public:
+    // /߻ܵ
+    struct Rollup {
+        size_t books = 0;
+        long long copies = 0;
+        long long valueCents = 0;
+
+        bool operator==(const Rollup& other) const {
+            return books == other.books && copies == other.copies && valueCents == other.valueCents;
+        }
+    };
+
+    // ֱͼͰ½
+    static const std::vector<int>& quantityBounds();
+
+private:
+    size_t books = 0;
+    long long copies = 0;
+    long long valueCents = 0;
+    // (۸, ISBN)֧ɾǰ߼ۣÿһڵ㣬ڳԱʱͷ
+    using PriceOrder = std::pmr::set<std::pair<double, std::pmr::string>>;
+    PooledObject<PriceOrder> priceOrder;
+
+    // λα꣺position  priceOrder еĵ rank ڵ㣨 0 𣩣rank Ϊ floor(q * (n - 1))
+    // ÿɾ仯 1αֻƶһ
+    struct QuantileCursor {
+        double q = 0.0;
+        PriceOrder::const_iterator position;
+        size_t rank = 0;
+    };
+    std::array<QuantileCursor, 2> cursors = { { { 0.5, {}, 0 }, { 0.9, {}, 0 } } };
+    std::vector<size_t> quantityBuckets = std::vector<size_t>(quantityBounds().size(), 0);
+    std::unordered_map<std::string, Rollup> byPublisher;
+    std::unordered_map<std::string, Rollup> byAuthor;
+
+    static size_t bucketOf(int quantity);
+    static size_t targetRank(double q, size_t count);
+    void settle(QuantileCursor& cursor);
+    bool sameCursors(const CatalogStatistics& other) const;
+    static void adjust(std::unordered_map<std::string, Rollup>& rollups, std::string_view key,
+        long long copies, long long valueCents, int sign);
+
+public:
+    void add(std::string_view isbn, std::string_view author, std::string_view publisher, double price, int quantity);
+    void remove(std::string_view isbn, std::string_view author, std::string_view publisher, double price, int quantity);
+    void clear();
+
+    size_t bookCount() const { return books; }
+    long long totalCopies() const { return copies; }
+    double totalValue() const { return static_cast<double>(valueCents) / 100.0; }
+    long long totalValueCents() const { return valueCents; }
+
+    // ߼/ͼͼ飨ʱȡ ISBN Сߣͼʱ false
+    bool maxPrice(double& price, std::string& isbn) const;
+    bool minPrice(double& price, std::string& isbn) const;
+
+    // ۸λq ȡ 0~1۸֮Բֵͼʱ 0
+    // 0.5  0.9 ֱȡα꣬ q αƶ
+    double pricePercentile(double q) const;
+
+    const std::vector<size_t>& quantityHistogram() const { return quantityBuckets; }
+    const std::unordered_map<std::string, Rollup>& publishers() const { return byPublisher; }
+    const std::unordered_map<std::string, Rollup>& authors() const { return byAuthor; }
+
+    // һͳƣͨȫĽȶ
+    bool operator==(const CatalogStatistics& other) const;
+
+    // ͼޣ֣ 100 ԪŰ򱾴ﵽ޵ͼۼҲ long long
+    static constexpr long long maxValueCents = 1000000000000LL;
+
+    // ͼĽ֣÷У飬޵ļ۸Ϊ 0 maxValueCents ʱض
+    static long long toCents(double price, int quantity);
+};
+
+#endif // CATALOG_STATISTICS_H
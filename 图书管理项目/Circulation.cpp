@@ -0,0 +1,317 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdio>
+#include <charconv>
+#include <ctime>
+#include <bit>
+#include "Circulation.h"
+
+namespace {
+    //  1970-01-01 H. Hinnant  days_from_civil / civil_from_days
+    int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    int32_t civilFromDays(int64_t z) {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+        const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+        const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+        return static_cast<int32_t>(y * 10000 + m * 100 + d);
+    }
+
+    int64_t dayNumber(int32_t date) {
+        return daysFromCivil(date / 10000, static_cast<unsigned>(date / 100 % 100), static_cast<unsigned>(date % 100));
+    }
+
+    //  '|' з˱¼ĸ
+    std::vector<std::string_view> splitFields(std::string_view text) {
+        std::vector<std::string_view> fields;
+        size_t start = 0;
+        for (size_t sep; (sep = text.find('|', start)) != std::string_view::npos; start = sep + 1) {
+            fields.push_back(text.substr(start, sep - start));
+        }
+        fields.push_back(text.substr(start));
+        return fields;
+    }
+
+    bool parseNumber(std::string_view text, uint32_t& value) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+}
+
+Circulation::Circulation(std::string ledgerPath) : ledger(std::move(ledgerPath)) {
+}
+
+bool Circulation::parseDate(std::string_view text, int32_t& date) {
+    int32_t key = publishDateKey(text);
+    if (key <= 0) return false;
+    int month = key / 100 % 100, day = key % 100;
+    if (month == 0 || day == 0) return false;   // ֻݻ
+    // 2  30 ֮໻䵽
+    if (civilFromDays(dayNumber(key)) != key) return false;
+    date = key;
+    return true;
+}
+
+std::string Circulation::formatDate(int32_t date) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", date / 10000, date / 100 % 100, date % 100);
+    return buf;
+}
+
+int32_t Circulation::today() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+}
+
+int32_t Circulation::addDays(int32_t date, int days) {
+    return civilFromDays(dayNumber(date) + days);
+}
+
+int Circulation::daysBetween(int32_t from, int32_t to) {
+    return static_cast<int>(dayNumber(to) - dayNumber(from));
+}
+
+uint32_t Circulation::titleOf(std::string_view isbn) const {
+    auto it = titleIds.find(isbn);
+    return it == titleIds.end() ? npos : it->second;
+}
+
+uint32_t Circulation::addTitle(std::string_view isbn) {
+    uint32_t id = titleOf(isbn);
+    if (id != npos) return id;
+    id = static_cast<uint32_t>(titles.size());
+    titles.push_back(Title{ std::string(isbn), {}, 0 });
+    titleIds.emplace(titles.back().isbn, id);
+    return id;
+}
+
+Circulation::LoanInfo Circulation::infoOf(const Loan& loan) const {
+    return LoanInfo{ titles[loan.title].isbn, loan.copy, loan.patron, loan.borrowed, loan.due };
+}
+
+void Circulation::applyPatron(uint32_t patron, std::string_view name) {
+    patrons[patron].name.assign(name);
+}
+
+uint32_t Circulation::applyCheckout(uint32_t title, uint32_t copy, uint32_t patron, int32_t borrowed, int32_t due) {
+    uint32_t slot = freeLoan;
+    if (slot != npos) {
+        freeLoan = loans[slot].heldPosition;
+    }
+    else {
+        slot = static_cast<uint32_t>(loans.size());
+        loans.emplace_back();
+    }
+
+    std::vector<uint32_t>& held = patrons[patron].held;
+    loans[slot] = Loan{ title, copy, patron, static_cast<uint32_t>(held.size()), borrowed, due };
+    held.push_back(slot);
+
+    Title& state = titles[title];
+    size_t word = (copy - 1) / 64;
+    if (state.copies.size() <= word) state.copies.resize(word + 1, 0);
+    state.copies[word] |= uint64_t(1) << ((copy - 1) % 64);
+    ++state.onLoan;
+
+    loanOfCopy.emplace(copyKey(title, copy), slot);
+    dueIndex.add(due, slot);
+    ++activeLoans;
+    return slot;
+}
+
+void Circulation::applyReturn(uint32_t slot) {
+    Loan& loan = loans[slot];
+
+    // ڽбĩβĲλƵ黹λ
+    std::vector<uint32_t>& held = patrons[loan.patron].held;
+    uint32_t moved = held.back();
+    held[loan.heldPosition] = moved;
+    loans[moved].heldPosition = loan.heldPosition;
+    held.pop_back();
+
+    Title& state = titles[loan.title];
+    state.copies[(loan.copy - 1) / 64] &= ~(uint64_t(1) << ((loan.copy - 1) % 64));
+    --state.onLoan;
+
+    loanOfCopy.erase(copyKey(loan.title, loan.copy));
+    dueIndex.remove(loan.due, slot);
+    --activeLoans;
+
+    loan.patron = npos;
+    loan.heldPosition = freeLoan;
+    freeLoan = slot;
+}
+
+bool Circulation::applyRecord(const std::string& record) {
+    std::vector<std::string_view> fields = splitFields(record);
+    uint32_t patron = 0, copy = 0;
+    int32_t borrowed = 0, due = 0;
+    if (fields[0] == "P" && fields.size() == 3 && parseNumber(fields[1], patron) && !fields[2].empty()) {
+        applyPatron(patron, fields[2]);
+        return true;
+    }
+    if (fields[0] == "O" && fields.size() == 6 && parseNumber(fields[2], copy) && copy > 0
+        && parseNumber(fields[3], patron) && parseDate(fields[4], borrowed) && parseDate(fields[5], due)
+        && patrons.count(patron) > 0) {
+        uint32_t title = addTitle(fields[1]);
+        if (loanOfCopy.count(copyKey(title, copy)) > 0) return false;
+        applyCheckout(title, copy, patron, borrowed, due);
+        return true;
+    }
+    if (fields[0] == "R" && fields.size() == 4 && parseNumber(fields[2], copy)) {
+        uint32_t title = titleOf(fields[1]);
+        auto it = title == npos ? loanOfCopy.end() : loanOfCopy.find(copyKey(title, copy));
+        if (it == loanOfCopy.end()) return false;
+        applyReturn(it->second);
+        return true;
+    }
+    return false;
+}
+
+size_t Circulation::load() {
+    size_t skipped = 0;
+    size_t replayed = ledger.replay(0, [this, &skipped](const std::string& record) {
+        if (!applyRecord(record)) ++skipped;
+    });
+    if (skipped > 0) {
+        std::cerr << "棺˱ " << skipped << " ¼޷طţ" << std::endl;
+    }
+    ledger.open(0);   // ˱ûпգͷУ͹̶Ϊ 0
+    dueIndex.merge();
+    return replayed;
+}
+
+bool Circulation::record(const std::string& line, std::string& error) {
+    if (!ledger.append(line)) {
+        error = "޷д˱";
+        return false;
+    }
+    return true;
+}
+
+bool Circulation::addPatron(uint32_t patron, std::string_view name, std::string& error) {
+    if (name.empty() || name.find_first_of("|\r\n") != std::string_view::npos) {
+        error = "ΪգҲܰ '|' ";
+        return false;
+    }
+    if (!record("P|" + std::to_string(patron) + "|" + std::string(name), error)) return false;
+    applyPatron(patron, name);
+    return true;
+}
+
+bool Circulation::checkout(std::string_view isbn, int quantity, uint32_t patron, int32_t day, int32_t due,
+    LoanInfo& loan, std::string& error) {
+    if (patrons.count(patron) == 0) {
+        error = " " + std::to_string(patron) + " δǼ";
+        return false;
+    }
+    if (due < day) {
+        error = "Ӧڲڽ";
+        return false;
+    }
+
+    // λͼұСڼܸ
+    uint32_t title = titleOf(isbn);
+    uint32_t copy = 0;
+    uint32_t copies = quantity > 0 ? static_cast<uint32_t>(quantity) : 0;
+    if (title == npos) {
+        copy = copies > 0 ? 1 : 0;
+    }
+    else if (titles[title].onLoan < copies) {
+        const std::vector<uint64_t>& bits = titles[title].copies;
+        for (size_t word = 0; copy == 0 && word * 64 < copies; ++word) {
+            uint64_t taken = word < bits.size() ? bits[word] : 0;
+            uint32_t candidate = static_cast<uint32_t>(word * 64) + std::countr_one(taken) + 1;
+            if (taken != ~uint64_t(0) && candidate <= copies) copy = candidate;
+        }
+    }
+    if (copy == 0) {
+        error = "ISBN " + std::string(isbn) + " ûпɽĸ";
+        return false;
+    }
+
+    std::string line = "O|" + std::string(isbn) + "|" + std::to_string(copy) + "|" + std::to_string(patron)
+        + "|" + formatDate(day) + "|" + formatDate(due);
+    if (!record(line, error)) return false;
+    if (title == npos) title = addTitle(isbn);
+    loan = infoOf(loans[applyCheckout(title, copy, patron, day, due)]);
+    return true;
+}
+
+bool Circulation::checkin(std::string_view isbn, uint32_t copy, int32_t day, LoanInfo& loan, std::string& error) {
+    uint32_t title = titleOf(isbn);
+    auto it = title == npos ? loanOfCopy.end() : loanOfCopy.find(copyKey(title, copy));
+    if (it == loanOfCopy.end()) {
+        error = "ISBN " + std::string(isbn) + " ĸ " + std::to_string(copy) + " ڽ";
+        return false;
+    }
+    uint32_t slot = it->second;
+    if (!record("R|" + std::string(isbn) + "|" + std::to_string(copy) + "|" + formatDate(day), error)) return false;
+    loan = infoOf(loans[slot]);
+    applyReturn(slot);
+    return true;
+}
+
+uint32_t Circulation::onLoan(std::string_view isbn) const {
+    uint32_t title = titleOf(isbn);
+    return title == npos ? 0 : titles[title].onLoan;
+}
+
+const std::string* Circulation::patronName(uint32_t patron) const {
+    auto it = patrons.find(patron);
+    return it == patrons.end() ? nullptr : &it->second.name;
+}
+
+void Circulation::forEachHeld(uint32_t patron, const std::function<bool(const LoanInfo&)>& visit) const {
+    auto it = patrons.find(patron);
+    if (it == patrons.end()) return;
+    for (uint32_t slot : it->second.held) {
+        if (!visit(infoOf(loans[slot]))) return;
+    }
+}
+
+void Circulation::forEachOverdue(int32_t day, const std::function<bool(const LoanInfo&)>& visit) const {
+    dueIndex.scan(std::numeric_limits<int32_t>::min(), day - 1,
+        [this, &visit](int32_t, uint32_t slot) { return visit(infoOf(loans[slot])); });
+}
+
+size_t Circulation::overdueCount(int32_t day) const {
+    return dueIndex.count(std::numeric_limits<int32_t>::min(), day - 1);
+}
+
+size_t Circulation::memoryUsage() const {
+    // ϣڵ㰴ֵָ
+    size_t bytes = loans.capacity() * sizeof(Loan) + dueIndex.memoryUsage()
+        + loanOfCopy.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 16) + loanOfCopy.bucket_count() * sizeof(void*)
+        + titleIds.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 16) + titleIds.bucket_count() * sizeof(void*);
+    for (const Title& title : titles) {
+        bytes += sizeof(Title) + title.copies.capacity() * sizeof(uint64_t);
+        if (title.isbn.size() >= sizeof(std::string)) bytes += title.isbn.size() + 1;
+    }
+    for (const auto& [id, patron] : patrons) {
+        bytes += sizeof(id) + sizeof(Patron) + 16 + patron.held.capacity() * sizeof(uint32_t);
+        if (patron.name.size() >= sizeof(std::string)) bytes += patron.name.size() + 1;
+    }
+    return bytes;
+}
@@ -0,0 +1,136 @@
+#ifndef CIRCULATION_H
+#define CIRCULATION_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include "BookJournal.h"
+#include "OrderedIndex.h"
+
+// ͨߵǼǡ黹
+// ÿĸ 1.. ţ״̬ÿһλͼеÿһռһλ
+// ͬʱϣ(, ) ұߵڽбӦ
+// 黹ǳιϣһ޸ģO(log n)
+// 軹¼׷д˱ļ¼ʽ־ͬպѹʱطؽȫ״̬
+//   P|<ߺ>|<>  ǼǶ
+//   O|<ISBN>|<>|<ߺ>|<>|<Ӧ>  
+//   R|<ISBN>|<>|<黹>  黹
+// ھΪ yyyymmdd ʽͬ˱д yyyy-mm-dd
+class Circulation {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr int defaultLoanDays = 30;   // δָӦʱĽ
+
+    // һеͼ
+    struct LoanInfo {
+        std::string_view isbn;
+        uint32_t copy = 0;       // ţ 1 ʼ
+        uint32_t patron = 0;     // ߺ
+        int32_t borrowed = 0;    // 
+        int32_t due = 0;         // Ӧ
+    };
+
+private:
+    // һͨ״̬ĿֻISBN ɾ޸ĺȻ
+    struct Title {
+        std::string isbn;
+        std::vector<uint64_t> copies;   // λͼ i λӦ i+1
+        uint32_t onLoan = 0;            // 
+    };
+
+    // λλ patron Ϊ nposheldPosition λеһλ
+    struct Loan {
+        uint32_t title;
+        uint32_t copy;
+        uint32_t patron;
+        uint32_t heldPosition;   // ڶڽбеλã黹ʱĩβɾ
+        int32_t borrowed;
+        int32_t due;
+    };
+
+    struct Patron {
+        std::string name;
+        std::vector<uint32_t> held;   // ڽĲλ
+    };
+
+    BookJournal ledger;
+    std::deque<Title> titles;                                // ˫˶вԪأұļе ISBN
+    std::unordered_map<std::string_view, uint32_t> titleIds; // ISBN -> Ŀ
+    std::vector<Loan> loans;
+    uint32_t freeLoan = npos;                                // λͷ
+    size_t activeLoans = 0;
+    std::unordered_map<uint64_t, uint32_t> loanOfCopy;       // (Ŀ << 32 | ) -> λ
+    std::unordered_map<uint32_t, Patron> patrons;
+    OrderedIndex<int32_t> dueIndex;                          // Ӧ -> λ
+
+    static uint64_t copyKey(uint32_t title, uint32_t copy) { return (uint64_t(title) << 32) | copy; }
+
+    uint32_t titleOf(std::string_view isbn) const;
+    uint32_t addTitle(std::string_view isbn);
+    LoanInfo infoOf(const Loan& loan) const;
+
+    // ֻ޸ڴ棨طµĽ軹ãǰУ
+    void applyPatron(uint32_t patron, std::string_view name);
+    uint32_t applyCheckout(uint32_t title, uint32_t copy, uint32_t patron, int32_t borrowed, int32_t due);
+    void applyReturn(uint32_t slot);
+
+    // طһ˱¼ʽ뵱ǰ״̬ìʱ false
+    bool applyRecord(const std::string& record);
+
+    // д˱޸ڴ֮ǰã
+    bool record(const std::string& line, std::string& error);
+
+public:
+    explicit Circulation(std::string ledgerPath);
+
+    Circulation(const Circulation&) = delete;
+    Circulation& operator=(const Circulation&) = delete;
+
+    // ط˱׷ӣػطŵļ¼
+    size_t load();
+
+    // ǼǶ߻޸Ϊգܺ '|' 뻻
+    bool addPatron(uint32_t patron, std::string_view name, std::string& error);
+
+    // һ᣺ 1..quantity ȡСڼܸд˱
+    // quantity ΪݲزBook::quantitydue  day
+    bool checkout(std::string_view isbn, int quantity, uint32_t patron, int32_t day, int32_t due,
+        LoanInfo& loan, std::string& error);
+
+    // 黹һᣬloan ع黹ǰĽϢ
+    bool checkin(std::string_view isbn, uint32_t copy, int32_t day, LoanInfo& loan, std::string& error);
+
+    // ISBN ĽɽΪݲزȥ
+    uint32_t onLoan(std::string_view isbn) const;
+
+    // δǼʱؿָ
+    const std::string* patronName(uint32_t patron) const;
+
+    // ڽͼ飨Ⱥ󣬹黹˳򣩣visit  false ʱֹͣ
+    void forEachHeld(uint32_t patron, const std::function<bool(const LoanInfo&)>& visit) const;
+
+    //  day ڣӦ dayͼ飬Ӧvisit  false ʱֹͣ
+    void forEachOverdue(int32_t day, const std::function<bool(const LoanInfo&)>& visit) const;
+    size_t overdueCount(int32_t day) const;
+
+    size_t loanCount() const { return activeLoans; }
+    size_t patronCount() const { return patrons.size(); }
+    size_t ledgerRecords() const { return ledger.recordCount(); }
+    size_t memoryUsage() const;
+
+    // ˱
+    void sync() { ledger.sync(); }
+    void setSyncInterval(size_t interval) { ledger.setSyncInterval(interval); }
+
+    // ڣգдͬڣڣӼ
+    static bool parseDate(std::string_view text, int32_t& date);
+    static std::string formatDate(int32_t date);
+    static int32_t today();
+    static int32_t addDays(int32_t date, int days);
+    static int daysBetween(int32_t from, int32_t to);
+};
+
+#endif // CIRCULATION_H
@@ -0,0 +1,381 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <charconv>
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include "CommandProtocol.h"
+#include "LibraryManagement.h"
+#include "QueryEngine.h"
+
+namespace {
+
+// 
+void splitCommand(std::string_view line, std::string& command, std::string& args) {
+    size_t sep = line.find('|');
+    command.assign(line.substr(0, sep));
+    if (sep == std::string_view::npos) args.clear();
+    else args.assign(line.substr(sep + 1));
+}
+
+bool fail(std::ostream& out, const std::string& reason) {
+    out << "error\t" << reason << '\n';
+    return false;
+}
+
+// ѯд뻺壬Ա״̬
+bool emit(std::ostream& out, const std::ostringstream& results, size_t count) {
+    out << "ok\t" << count << '\n' << results.str();
+    return true;
+}
+
+bool parseSize(const std::string& text, size_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// ͳժҪһ JSON
+void writeStatistics(const Library& library, std::ostream& out) {
+    LibraryMetrics::Span span(library.getMetrics(), LibraryMetrics::Statistics);
+    const CatalogStatistics& stats = library.getStatistics();
+    double averagePrice = stats.totalCopies() > 0 ? stats.totalValue() / stats.totalCopies() : 0.0;
+    double maxPrice = 0.0, minPrice = 0.0;
+    std::string isbn;
+    stats.maxPrice(maxPrice, isbn);
+    stats.minPrice(minPrice, isbn);
+
+    std::ostringstream json;   // Ķ out ĸʽ
+    json << std::fixed << std::setprecision(2)
+        << "{\"books\":" << stats.bookCount()
+        << ",\"copies\":" << stats.totalCopies()
+        << ",\"totalValue\":" << stats.totalValue()
+        << ",\"averagePrice\":" << averagePrice
+        << ",\"minPrice\":" << minPrice
+        << ",\"maxPrice\":" << maxPrice
+        << ",\"medianPrice\":" << stats.pricePercentile(0.5)
+        << ",\"p90Price\":" << stats.pricePercentile(0.9)
+        << ",\"publishers\":" << stats.publishers().size()
+        << ",\"authors\":" << stats.authors().size()
+        << ",\"quantityHistogram\":[";
+    const std::vector<size_t>& histogram = stats.quantityHistogram();
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        json << (i == 0 ? "" : ",") << histogram[i];
+    }
+    BookCache::Metrics cache = library.getCacheMetrics();
+    json << "],\"cache\":{\"capacity\":" << cache.capacity
+        << ",\"entries\":" << cache.entries
+        << ",\"memoryBytes\":" << cache.memoryBytes
+        << ",\"hits\":" << cache.hits
+        << ",\"misses\":" << cache.misses
+        << ",\"hitRate\":" << std::setprecision(4) << cache.hitRate()
+        << ",\"evictions\":" << cache.evictions
+        << ",\"invalidations\":" << cache.invalidations
+        << "}}\n";
+    out << json.str();
+}
+
+// metrics[|json|prometheus[|<·>]]·ʱдļӦ
+bool writeMetrics(const Library& library, const std::string& args, std::ostream& out) {
+    size_t pathSep = args.find('|');
+    std::string format = args.substr(0, pathSep);
+    if (format.empty()) format = "json";
+    if (format != "json" && format != "prometheus") return fail(out, "Чָʽ " + format);
+    bool prometheus = format == "prometheus";
+    if (!prometheus && !LibraryMetrics::enabled) return fail(out, "ܼδãʱѹرգ");
+
+    if (pathSep != std::string::npos) {
+        std::string path = args.substr(pathSep + 1);
+        if (path.empty()) return fail(out, "ȱļ·");
+        if (!library.writeMetricsFile(path, prometheus)) return fail(out, "޷д " + path);
+        out << "ok\n";
+        return true;
+    }
+
+    std::ostringstream text;
+    library.writeMetrics(text, prometheus);
+    std::string result = text.str();
+    out << "ok\t" << std::count(result.begin(), result.end(), '\n') << '\n' << result;
+    return true;
+}
+
+// trace|start  trace|stop[|<·>]ֹͣʱ·д Chrome trace JSON
+bool controlTrace(const Library& library, const std::string& args, std::ostream& out) {
+    if (!LibraryMetrics::enabled) return fail(out, "ܼδãʱѹرգ");
+    LibraryMetrics& metrics = library.getMetrics();
+    size_t pathSep = args.find('|');
+    std::string action = args.substr(0, pathSep);
+    if (action == "start" && pathSep == std::string::npos) {
+        metrics.startTrace();
+        out << "ok\n";
+        return true;
+    }
+    if (action != "stop") return fail(out, "Чĸٲ " + action);
+
+    metrics.stopTrace();
+    if (pathSep != std::string::npos) {
+        std::string path = args.substr(pathSep + 1);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        metrics.writeChromeTrace(file);
+        file.close();
+        if (!file) return fail(out, "޷д " + path);
+    }
+    out << "ok\n";
+    return true;
+}
+
+bool parseId(const std::string& text, uint32_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// һļ¼һ JSONasOf Ϊ 0 ʱϽڵ
+void appendLoan(const Library& library, const Circulation::LoanInfo& loan, int32_t asOf, std::string& json) {
+    const std::string* name = library.getCirculation().patronName(loan.patron);
+    json += "{\"isbn\":";
+    ResultSink::appendJsonString(json, loan.isbn);
+    json += ",\"copy\":" + std::to_string(loan.copy) + ",\"patron\":" + std::to_string(loan.patron) + ",\"name\":";
+    ResultSink::appendJsonString(json, name ? *name : std::string());
+    json += ",\"borrowed\":\"" + Circulation::formatDate(loan.borrowed) + "\",\"due\":\""
+        + Circulation::formatDate(loan.due) + "\"";
+    if (asOf != 0) {
+        json += ",\"overdueDays\":" + std::to_string(std::max(0, Circulation::daysBetween(loan.due, asOf)));
+    }
+    json += "}\n";
+}
+
+// patron / borrow / return '|' пɹʱļ¼
+bool executeCirculation(Library& library, const std::string& command, const std::string& args, std::ostream& out) {
+    std::vector<std::string> fields;
+    for (size_t start = 0;;) {
+        size_t sep = args.find('|', start);
+        fields.push_back(args.substr(start, sep - start));
+        if (sep == std::string::npos) break;
+        start = sep + 1;
+    }
+
+    std::string error;
+    uint32_t number = 0;
+    if (command == "patron") {
+        if (fields.size() != 2 || !parseId(fields[0], number)) return fail(out, "ʽӦΪ patron|<ߺ>|<>");
+        if (!library.addPatron(number, fields[1], error)) return fail(out, error);
+        out << "ok\n";
+        return true;
+    }
+
+    Circulation::LoanInfo loan;
+    std::string json;
+    if (command == "borrow") {
+        if (fields.size() < 2 || fields.size() > 3 || !parseId(fields[1], number)) {
+            return fail(out, "ʽӦΪ borrow|<ISBN>|<ߺ>[|<Ӧ>]");
+        }
+        int32_t due = Circulation::addDays(Circulation::today(), Circulation::defaultLoanDays);
+        if (fields.size() == 3 && !Circulation::parseDate(fields[2], due)) return fail(out, "Ч " + fields[2]);
+        if (!library.borrowBook(fields[0], number, due, loan, error)) return fail(out, error);
+        appendLoan(library, loan, 0, json);
+    }
+    else {
+        if (fields.size() != 2 || !parseId(fields[1], number)) return fail(out, "ʽӦΪ return|<ISBN>|<>");
+        if (!library.returnBook(fields[0], number, loan, error)) return fail(out, error);
+        appendLoan(library, loan, Circulation::today(), json);
+    }
+    out << "ok\t1\n" << json;
+    return true;
+}
+
+} // namespace
+
+CommandProtocol::Access CommandProtocol::access(std::string_view line) {
+    std::string_view command = line.substr(0, line.find('|'));
+    if (command == "add" || command == "update" || command == "delete" || command == "clear" || command == "save"
+        || command == "flush" || command == "patron" || command == "borrow" || command == "return") {
+        return Write;
+    }
+    return Read;
+}
+
+bool CommandProtocol::execute(Library& library, std::string_view line, std::ostream& out) {
+    if (access(line) == Read) return executeRead(library, line, out);
+
+    std::string command, args;
+    splitCommand(line, command, args);
+
+    if (command == "add" || command == "update" || command == "delete") {
+        BookOperation operation;
+        std::string error;
+        if (!BookOperation::tryParse(std::string(1, static_cast<char>(std::toupper(command[0]))) + "|" + args,
+            operation, error)) {
+            return fail(out, error);
+        }
+        // Уͻ鶼 Library ɣʧԭԭ
+        bool ok = false;
+        switch (operation.type) {
+        case BookOperation::Add:
+            ok = library.addBook(operation.book, error);
+            break;
+        case BookOperation::Update:
+            ok = library.updateBook(operation.isbn, operation.book, error);
+            break;
+        case BookOperation::Delete:
+            ok = library.deleteBook(operation.isbn, error);
+            break;
+        }
+        if (!ok) return fail(out, error);
+        out << "ok\n";
+        return true;
+    }
+    if (command == "patron" || command == "borrow" || command == "return") {
+        return executeCirculation(library, command, args, out);
+    }
+    if (command == "clear") {
+        std::string error;
+        if (!library.clearAllBooks(error)) return fail(out, error);
+        out << "ok\n";
+        return true;
+    }
+    if (command == "flush") {
+        if (!library.flush()) return fail(out, "̨дʧ");
+        out << "ok\n";
+        return true;
+    }
+    // save
+    if (!library.persist()) return fail(out, "ʧ");
+    out << "ok\n";
+    return true;
+}
+
+bool CommandProtocol::executeRead(const Library& library, std::string_view line, std::ostream& out) {
+    std::string command, args;
+    splitCommand(line, command, args);
+
+    if (command == "get") {
+        std::ostringstream results;
+        ResultSink sink(results, ResultSink::JsonLines);
+        library.searchBookByISBN(args, sink);
+        sink.flush();
+        return emit(out, results, sink.written());
+    }
+    if (command == "search") {
+        size_t fieldEnd = args.find('|');
+        if (fieldEnd == std::string::npos) return fail(out, "ȱؼ");
+        std::string field = args.substr(0, fieldEnd);
+        std::string keyword = args.substr(fieldEnd + 1);
+        std::ostringstream results;
+        ResultSink sink(results, ResultSink::JsonLines);
+        if (field == "title") library.searchBookByTitle(keyword, sink);
+        else if (field == "author") library.searchBookByAuthor(keyword, sink);
+        else if (field == "publisher") library.searchBookByPublisher(keyword, sink);
+        else return fail(out, "Чֶ " + field);
+        sink.flush();
+        return emit(out, results, sink.written());
+    }
+    if (command == "fuzzy") {
+        // fuzzy|<ֶ>|<ؼ>[|<>]ͼֶβ '|'ؼ֮һΪ
+        size_t fieldEnd = args.find('|');
+        if (fieldEnd == std::string::npos) return fail(out, "ȱؼ");
+        TextIndex::Field field;
+        if (!TextIndex::parseField(args.substr(0, fieldEnd), field)) {
+            return fail(out, "Чֶ " + args.substr(0, fieldEnd));
+        }
+        std::string keyword = args.substr(fieldEnd + 1);
+        size_t limit = 20;
+        size_t limitSep = keyword.rfind('|');
+        if (limitSep != std::string::npos) {
+            if (!parseSize(keyword.substr(limitSep + 1), limit)) return fail(out, "Ч");
+            keyword.resize(limitSep);
+        }
+        std::ostringstream results;
+        ResultSink sink(results, ResultSink::JsonLines);
+        library.searchRanked(field, keyword, sink, limit);
+        sink.flush();
+        return emit(out, results, sink.written());
+    }
+    if (command == "query") {
+        Query query;
+        std::string error;
+        if (!Query::parse(args, query, error)) return fail(out, error);
+        std::ostringstream results;
+        ResultSink sink(results, ResultSink::JsonLines);
+        QueryEngine(library).execute(query, sink);
+        sink.flush();
+        return emit(out, results, sink.written());
+    }
+    if (command == "list") {
+        // list  list|<offset>|<limit>
+        size_t offset = 0, limit = std::numeric_limits<size_t>::max();
+        if (!args.empty()) {
+            size_t limitSep = args.find('|');
+            bool ok = parseSize(args.substr(0, limitSep), offset);
+            if (ok && limitSep != std::string::npos) ok = parseSize(args.substr(limitSep + 1), limit);
+            if (!ok) return fail(out, "Чķҳ");
+        }
+        std::ostringstream results;
+        ResultSink sink(results, ResultSink::JsonLines, offset, limit);
+        library.displayAllBooks(sink);
+        sink.flush();
+        return emit(out, results, sink.written());
+    }
+    if (command == "count") {
+        out << "ok\t" << library.getTotalBooksCount() << '\n';
+        return true;
+    }
+    if (command == "stats") {
+        out << "ok\t1\n";
+        writeStatistics(library, out);
+        return true;
+    }
+    if (command == "loans") {
+        uint32_t patron = 0;
+        if (!parseId(args, patron)) return fail(out, "ЧĶߺ");
+        const Circulation& circulation = library.getCirculation();
+        if (!circulation.patronName(patron)) return fail(out, " " + args + " δǼ");
+        std::string json;
+        size_t count = 0;
+        int32_t today = Circulation::today();
+        circulation.forEachHeld(patron, [&](const Circulation::LoanInfo& loan) {
+            appendLoan(library, loan, today, json);
+            ++count;
+            return true;
+        });
+        out << "ok\t" << count << '\n' << json;
+        return true;
+    }
+    if (command == "overdue") {
+        // overdue[|<>[|<>]]ӦڸڣĬϽ죩ĽģӦ
+        size_t dateEnd = args.find('|');
+        std::string date = args.substr(0, dateEnd);
+        int32_t asOf = Circulation::today();
+        size_t limit = std::numeric_limits<size_t>::max();
+        if (!date.empty() && !Circulation::parseDate(date, asOf)) return fail(out, "Ч " + date);
+        if (dateEnd != std::string::npos && !parseSize(args.substr(dateEnd + 1), limit)) return fail(out, "Ч");
+        std::string json;
+        size_t count = 0;
+        library.getCirculation().forEachOverdue(asOf, [&](const Circulation::LoanInfo& loan) {
+            if (count == limit) return false;
+            appendLoan(library, loan, asOf, json);
+            ++count;
+            return true;
+        });
+        out << "ok\t" << count << '\n' << json;
+        return true;
+    }
+    if (command == "available") {
+        int available = library.getAvailableCopies(args);
+        if (available < 0) return fail(out, "δҵISBN " + args + " ͼ");
+        std::string json = "{\"isbn\":";
+        ResultSink::appendJsonString(json, args);
+        json += ",\"onLoan\":" + std::to_string(library.getCirculation().onLoan(args))
+            + ",\"available\":" + std::to_string(available) + "}\n";
+        out << "ok\t1\n" << json;
+        return true;
+    }
+    if (command == "metrics") {
+        return writeMetrics(library, args, out);
+    }
+    if (command == "trace") {
+        return controlTrace(library, args, out);
+    }
+    return fail(out, "δ֪ " + command);
+}
@@ -0,0 +1,31 @@
+#ifndef COMMAND_PROTOCOL_H
+#define COMMAND_PROTOCOL_H
+#include <string_view>
+#include <ostream>
+
+class Library;
+
+// ıЭ飺űģʽѯ
+// ÿһ '|' ָɾĵĲʽ book.txt ͬ
+//   add|<ͼ>  update|<ԭISBN>|<ͼ>  delete|<ISBN>  clear  save  flush
+//   get|<ISBN>  search|title|author|publisher|<ؼ>  fuzzy|title|author|publisher|<ؼ>[|<>]
+//   query|<>  list[|offset|limit]  count  stats
+//   patron|<ߺ>|<>  borrow|<ISBN>|<ߺ>[|<Ӧ>]  return|<ISBN>|<>ͨ
+//   loans|<ߺ>  overdue[|<>[|<>]]  available|<ISBN>
+//   metrics[|json|prometheus[|<·>]]  trace|start  trace|stop[|<·>]ܼ Chrome trace
+// ÿһ״̬ok / ok<TAB> / error<TAB>ԭ򣩣ѯ JSON 
+class CommandProtocol {
+public:
+    enum Access { Read, Write };
+
+    // ֻǻ޸ݣδ֪ִֻʱ
+    static Access access(std::string_view line);
+
+    // ִһɹ true
+    static bool execute(Library& library, std::string_view line, std::ostream& out);
+
+    // ִһֻֻ
+    static bool executeRead(const Library& library, std::string_view line, std::ostream& out);
+};
+
+#endif // COMMAND_PROTOCOL_H
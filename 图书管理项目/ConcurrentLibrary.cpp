@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include "ConcurrentLibrary.h"
+
+ConcurrentLibrary::ConcurrentLibrary(size_t shardCount) {
+    shardCount = std::max<size_t>(1, shardCount);
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+
+    library.forEachBook([this](const Book& book) {
+        shardFor(book.getISBN()).books.emplace(book.getISBN(), std::make_shared<const Book>(book));
+        ++bookCount;
+    });
+
+    writer = std::thread(&ConcurrentLibrary::writerLoop, this);
+}
+
+ConcurrentLibrary::~ConcurrentLibrary() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    writer.join();
+}
+
+ConcurrentLibrary::Shard& ConcurrentLibrary::shardFor(const std::string& isbn) const {
+    return *shards[std::hash<std::string>()(isbn) % shards.size()];
+}
+
+void ConcurrentLibrary::enqueue(Operation operation) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(std::move(operation));
+    }
+    queueChanged.notify_all();
+}
+
+void ConcurrentLibrary::writerLoop() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueChanged.wait(lock, [this] { return stopping || !pending.empty() || syncDone < syncRequested; });
+        if (pending.empty() && syncDone == syncRequested) break;  // ڶպ˳
+
+        // ȡд־ʱж
+        std::deque<Operation> batch;
+        batch.swap(pending);
+        inFlight = batch.size();
+        uint64_t sync = syncRequested;
+        lock.unlock();
+        size_t failed = 0;
+        for (const auto& op : batch) {
+            bool ok = false;
+            switch (op.type) {
+            case Operation::Add:
+                ok = library.addBook(*op.book);
+                break;
+            case Operation::Update:
+                ok = library.updateBook(op.isbn, *op.book);
+                break;
+            case Operation::Delete:
+                ok = library.deleteBook(op.isbn);
+                break;
+            }
+            if (!ok) ++failed;
+        }
+        //  flush ڵȴ־̲ȽеĿд
+        if (sync > syncDone && !library.flush()) ++failed;
+        lock.lock();
+        inFlight = 0;
+        failedWrites += failed;
+        syncDone = std::max(syncDone, sync);
+        queueChanged.notify_all();
+    }
+}
+
+bool ConcurrentLibrary::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    uint64_t ticket = ++syncRequested;
+    queueChanged.notify_all();
+    queueChanged.wait(lock, [this, ticket] { return pending.empty() && inFlight == 0 && syncDone >= ticket; });
+    return std::exchange(failedWrites, 0) == 0;
+}
+
+bool ConcurrentLibrary::conflictsWithLoans(const std::string& isbn, const BookHandle& newBookInfo) const {
+    // ״̬ڹʱ˱룬ֻ֮಻軹ڵֱ߳Ӽ飻
+    // ûнʱͼ
+    if (library.getCirculation().onLoan(isbn) == 0) return false;
+    BookOperation operation{ newBookInfo ? BookOperation::Update : BookOperation::Delete, isbn };
+    if (newBookInfo) operation.book = *newBookInfo;
+    return !library.circulationConflict(operation).empty();
+}
+
+ConcurrentLibrary::BookHandle ConcurrentLibrary::findBook(const std::string& isbn) const {
+    Shard& shard = shardFor(isbn);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.books.find(isbn);
+    return it == shard.books.end() ? nullptr : it->second;
+}
+
+bool ConcurrentLibrary::isISBNExists(const std::string& isbn) const {
+    return findBook(isbn) != nullptr;
+}
+
+std::vector<ConcurrentLibrary::BookHandle> ConcurrentLibrary::scanShards(
+    const std::function<bool(const Book&)>& match) const {
+    // Ƭֹɨ裬ͬʱסƬ
+    std::vector<BookHandle> result;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        for (const auto& entry : shard->books) {
+            if (match(*entry.second)) result.push_back(entry.second);
+        }
+    }
+    return result;
+}
+
+std::vector<ConcurrentLibrary::BookHandle> ConcurrentLibrary::searchBookByTitle(const std::string& keyword) const {
+    return scanShards([&keyword](const Book& book) { return TextIndex::containsText(book.getTitle(), keyword); });
+}
+
+std::vector<ConcurrentLibrary::BookHandle> ConcurrentLibrary::searchBookByAuthor(const std::string& keyword) const {
+    return scanShards([&keyword](const Book& book) { return TextIndex::containsText(book.getAuthor(), keyword); });
+}
+
+bool ConcurrentLibrary::addBook(const Book& book) {
+    return addBook(Book(book));
+}
+
+bool ConcurrentLibrary::addBook(Book&& book) {
+    std::string error;
+    if (!book.validate(error)) return false;
+    auto handle = std::make_shared<const Book>(std::move(book));
+    const std::string& isbn = handle->getISBN();
+    Shard& shard = shardFor(isbn);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (!shard.books.emplace(isbn, handle).second) {
+        return false;
+    }
+    ++bookCount;
+    // ڷƬӣ֤ͬһISBNĲ޸˳д־
+    enqueue({ Operation::Add, isbn, handle });
+    return true;
+}
+
+bool ConcurrentLibrary::updateBook(const std::string& isbn, const Book& newBookInfo) {
+    return updateBook(isbn, Book(newBookInfo));
+}
+
+bool ConcurrentLibrary::updateBook(const std::string& isbn, Book&& newBookInfo) {
+    std::string error;
+    if (!newBookInfo.validate(error)) return false;
+    auto handle = std::make_shared<const Book>(std::move(newBookInfo));
+    if (conflictsWithLoans(isbn, handle)) return false;
+    const std::string& newISBN = handle->getISBN();
+    Shard& oldShard = shardFor(isbn);
+    Shard& newShard = shardFor(newISBN);
+
+    if (&oldShard == &newShard) {
+        std::unique_lock<std::shared_mutex> lock(oldShard.mutex);
+        auto it = oldShard.books.find(isbn);
+        if (it == oldShard.books.end()) return false;
+        if (newISBN != isbn) {
+            if (oldShard.books.count(newISBN)) return false;
+            oldShard.books.erase(it);
+            oldShard.books.emplace(newISBN, handle);
+        }
+        else {
+            it->second = handle;
+        }
+        enqueue({ Operation::Update, isbn, handle });
+        return true;
+    }
+
+    // ISBN Ƭַ˳
+    Shard* first = &oldShard < &newShard ? &oldShard : &newShard;
+    Shard* second = &oldShard < &newShard ? &newShard : &oldShard;
+    std::unique_lock<std::shared_mutex> lock1(first->mutex);
+    std::unique_lock<std::shared_mutex> lock2(second->mutex);
+    auto it = oldShard.books.find(isbn);
+    if (it == oldShard.books.end() || newShard.books.count(newISBN)) return false;
+    oldShard.books.erase(it);
+    newShard.books.emplace(newISBN, handle);
+    enqueue({ Operation::Update, isbn, handle });
+    return true;
+}
+
+bool ConcurrentLibrary::deleteBook(const std::string& isbn) {
+    if (conflictsWithLoans(isbn, nullptr)) return false;
+    Shard& shard = shardFor(isbn);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (shard.books.erase(isbn) == 0) return false;
+    --bookCount;
+    enqueue({ Operation::Delete, isbn, nullptr });
+    return true;
+}
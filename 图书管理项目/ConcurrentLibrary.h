@@ -0,0 +1,85 @@
+#ifndef CONCURRENT_LIBRARY_H
+#define CONCURRENT_LIBRARY_H
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include "LibraryManagement.h"
+
+// ̰߳ȫͼݣ ISBN ϣƬÿƬһѶд
+// ֻзƬõɱ Book ͷţ
+// дڷƬռ޸ڴ沢ӣɺ̨߳д Library Ĳ־дȴ
+class ConcurrentLibrary {
+public:
+    using BookHandle = Library::BookHandle;
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, BookHandle> books;
+    };
+
+    // ־ûĲ
+    struct Operation {
+        enum Type { Add, Update, Delete } type;
+        std::string isbn;   // /ɾĿISBN
+        BookHandle book;    // /ºͼ
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> bookCount{ 0 };
+
+    Library library{ nullptr };    // ־ûɺ̷̨߳ʣ״̬ʾ
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Operation> pending;
+    size_t inFlight = 0;    // ѳӵδдĲ
+    size_t failedWrites = 0;    // ϴ flush δдĲ
+    uint64_t syncRequested = 0; // flush ţ̴̨߳ syncDone
+    uint64_t syncDone = 0;
+    bool stopping = false;
+    std::thread writer;
+
+    Shard& shardFor(const std::string& isbn) const;
+    std::vector<BookHandle> scanShards(const std::function<bool(const Book&)>& match) const;
+    void enqueue(Operation operation);
+    bool conflictsWithLoans(const std::string& isbn, const BookHandle& newBookInfo) const;
+    void writerLoop();
+
+public:
+    explicit ConcurrentLibrary(size_t shardCount = 16);
+    ~ConcurrentLibrary();
+
+    ConcurrentLibrary(const ConcurrentLibrary&) = delete;
+    ConcurrentLibrary& operator=(const ConcurrentLibrary&) = delete;
+
+    // ѯɲã
+    BookHandle findBook(const std::string& isbn) const;
+    bool isISBNExists(const std::string& isbn) const;
+    std::vector<BookHandle> searchBookByTitle(const std::string& keyword) const;
+    std::vector<BookHandle> searchBookByAuthor(const std::string& keyword) const;
+    size_t size() const { return bookCount.load(std::memory_order_relaxed); }
+
+    // ޸ģͬһƬڴУֵʱͼֱ빲ֶΡ
+    // ֶβϷеĸͻ Library::circulationConflictʱ޸ķƬ false
+    bool addBook(const Book& book);
+    bool addBook(Book&& book);
+    bool updateBook(const std::string& isbn, const Book& newBookInfo);
+    bool updateBook(const std::string& isbn, Book&& newBookInfo);
+    bool deleteBook(const std::string& isbn);
+
+    // ȴǰ޸ȫд־̣еĿҲд꣬غ¼ book.txt Եõͬͼ飻
+    // ϴ flush вδд루̴ʱ falseЩѷӳڷƬУ־һ
+    bool flush();
+};
+
+#endif // CONCURRENT_LIBRARY_H
@@ -6,40 +6,50 @@
 #include <limits>
 #include <fstream>
 #include <sstream>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <cstring>
+#include <charconv>
+#include <thread>
+#include <cassert>
+#include <cmath>
+#include <cctype>
 #include "LibraryManagement.h"
+#include "MappedFile.h"
+#include "StatsKernels.h"
+#include "QueryEngine.h"
+#include "CommandProtocol.h"
 
 // Bookʵ
 Book::Book(std::string isbn, std::string title, std::string author,
     std::string publisher, std::string publishDate, double price, int quantity)
-    : isbn(isbn), title(title), author(author), publisher(publisher),
-    publishDate(publishDate), price(price), quantity(quantity) {
+    : isbn(std::move(isbn)), title(std::move(title)), author(std::move(author)), publisher(std::move(publisher)),
+    publishDate(std::move(publishDate)), price(price), quantity(quantity) {
 }
 
-std::string Book::getISBN() const { return isbn; }
-std::string Book::getTitle() const { return title; }
-std::string Book::getAuthor() const { return author; }
-std::string Book::getPublisher() const { return publisher; }
-std::string Book::getPublishDate() const { return publishDate; }
+const std::string& Book::getISBN() const { return isbn; }
+const std::string& Book::getTitle() const { return title; }
+const std::string& Book::getAuthor() const { return author; }
+const std::string& Book::getPublisher() const { return publisher; }
+const std::string& Book::getPublishDate() const { return publishDate; }
 double Book::getPrice() const { return price; }
 int Book::getQuantity() const { return quantity; }
 
-void Book::setTitle(std::string title) { this->title = title; }
-void Book::setAuthor(std::string author) { this->author = author; }
-void Book::setPublisher(std::string publisher) { this->publisher = publisher; }
-void Book::setPublishDate(std::string publishDate) { this->publishDate = publishDate; }
+void Book::setTitle(std::string title) { this->title = std::move(title); }
+void Book::setAuthor(std::string author) { this->author = std::move(author); }
+void Book::setPublisher(std::string publisher) { this->publisher = std::move(publisher); }
+void Book::setPublishDate(std::string publishDate) { this->publishDate = std::move(publishDate); }
 void Book::setPrice(double price) { this->price = price; }
 void Book::setQuantity(int quantity) { this->quantity = quantity; }
 
+BookRecord Book::record() const {
+    return BookRecord{ isbn, title, author, publisher, publishDate, price, quantity };
+}
+
 void Book::displayInfo() const {
-    std::cout << "================================" << std::endl;
-    std::cout << "ISBN: " << isbn << std::endl;
-    std::cout << ": " << title << std::endl;
-    std::cout << ": " << author << std::endl;
-    std::cout << ": " << publisher << std::endl;
-    std::cout << ": " << publishDate << std::endl;
-    std::cout << "۸: " << std::fixed << std::setprecision(2) << price << "Ԫ" << std::endl;
-    std::cout << ": " << quantity << "" << std::endl;
-    std::cout << "================================" << std::endl;
+    ResultSink sink(std::cout);
+    sink.write(record());
 }
 
 std::string Book::toString() const {
@@ -55,205 +65,1104 @@ std::string Book::toString() const {
 }
 
 Book Book::fromString(const std::string& str) {
-    std::istringstream iss(str);
-    std::string isbn, title, author, publisher, publishDate, priceStr, quantityStr;
+    Book book("", "", "", "", "", 0.0, 0);
+    std::string error;
+    if (!tryParse(str, book, error)) {
+        throw std::invalid_argument(error);
+    }
+    return book;
+}
+
+bool Book::tryParse(std::string_view line, Book& out, std::string& error) {
+    BookRecord record;
+    if (!tryParse(line, record, error)) return false;
+    out = Book(std::string(record.isbn), std::string(record.title), std::string(record.author),
+        std::string(record.publisher), std::string(record.publishDate), record.price, record.quantity);
+    return true;
+}
+
+bool Book::tryParse(std::string_view line, BookRecord& out, std::string& error) {
+    //  '|' ԭз֣memchr ɱ׼ɨ
+    std::string_view fields[7];
+    size_t count = 0;
+    const char* p = line.data();
+    const char* end = p + line.size();
+    while (count < 7) {
+        const char* sep = static_cast<const char*>(std::memchr(p, '|', static_cast<size_t>(end - p)));
+        if (!sep) {
+            fields[count++] = std::string_view(p, static_cast<size_t>(end - p));
+            break;
+        }
+        fields[count++] = std::string_view(p, static_cast<size_t>(sep - p));
+        p = sep + 1;
+        if (count == 7) {
+            error = "ֶι";
+            return false;
+        }
+    }
+    if (count != 7) {
+        error = "ֶ";
+        return false;
+    }
+
+    double price = 0.0;
+    auto priceResult = std::from_chars(fields[5].data(), fields[5].data() + fields[5].size(), price);
+    if (priceResult.ec != std::errc() || priceResult.ptr != fields[5].data() + fields[5].size()) {
+        error = "۸ʽ";
+        return false;
+    }
+    // from_chars  naninf 븺ͳһܾء־طͬһ
+    if (!std::isfinite(price) || price < 0) {
+        error = "۸ǷǸ";
+        return false;
+    }
+    int quantity = 0;
+    auto quantityResult = std::from_chars(fields[6].data(), fields[6].data() + fields[6].size(), quantity);
+    if (quantityResult.ec != std::errc() || quantityResult.ptr != fields[6].data() + fields[6].size()) {
+        error = "ʽ";
+        return false;
+    }
+    if (quantity < 0) {
+        error = "Ϊ";
+        return false;
+    }
+
+    out = BookRecord{ fields[0], fields[1], fields[2], fields[3], fields[4], price, quantity };
+    return true;
+}
+
+bool Book::validate(std::string& error) const {
+    if (!isValidISBN(isbn)) {
+        error = "ISBN " + isbn + " ʽЧ";
+        return false;
+    }
+    if (!std::isfinite(price) || price < 0) {
+        error = "۸ǷǸ";
+        return false;
+    }
+    if (quantity < 0) {
+        error = "Ϊ";
+        return false;
+    }
+    return true;
+}
 
-    std::getline(iss, isbn, '|');
-    std::getline(iss, title, '|');
-    std::getline(iss, author, '|');
-    std::getline(iss, publisher, '|');
-    std::getline(iss, publishDate, '|');
-    std::getline(iss, priceStr, '|');
-    std::getline(iss, quantityStr, '|');
+bool Book::isValidISBN(std::string_view isbn) {
+    // 򵥵ISBN֤ʵӦӦʹøϸ֤
+    if (isbn.length() < 10 || isbn.length() > 13) return false;
 
-    double price = std::stod(priceStr);
-    int quantity = std::stoi(quantityStr);
+    // Ƿַֺֻ
+    for (char c : isbn) {
+        if (!std::isdigit(static_cast<unsigned char>(c)) && c != '-') {
+            return false;
+        }
+    }
+    return true;
+}
 
-    return Book(isbn, title, author, publisher, publishDate, price, quantity);
+std::string BookOperation::toString() const {
+    switch (type) {
+    case Add:
+        return "A|" + book.toString();
+    case Update:
+        return "U|" + isbn + "|" + book.toString();
+    default:
+        return "D|" + isbn;
+    }
+}
+
+bool BookOperation::tryParse(std::string_view line, BookOperation& out, std::string& error) {
+    if (line.size() < 2 || line[1] != '|') {
+        error = "ʹ";
+        return false;
+    }
+    std::string_view body = line.substr(2);
+    switch (line[0]) {
+    case 'A':
+        out.type = Add;
+        if (!Book::tryParse(body, out.book, error)) return false;
+        out.isbn = out.book.getISBN();
+        return true;
+    case 'U': {
+        size_t sep = body.find('|');
+        if (sep == std::string_view::npos) {
+            error = "ֶ";
+            return false;
+        }
+        out.type = Update;
+        out.isbn = std::string(body.substr(0, sep));
+        return Book::tryParse(body.substr(sep + 1), out.book, error);
+    }
+    case 'D':
+        out.type = Delete;
+        out.isbn = std::string(body);
+        return true;
+    default:
+        error = "ʹ";
+        return false;
+    }
 }
 
 // Libraryʵ
-Library::Library() {
+Library::Library(std::ostream* messageStream) : messageStream(messageStream) {
     loadBooks();  // ʱԶ
 }
 
+Library::~Library() {
+    persist();
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshotStopping = true;
+    }
+    snapshotChanged.notify_all();
+    if (snapshotWriter.joinable()) snapshotWriter.join();
+}
+
+namespace {
+    // ݿĽֶӳеļ
+    struct ParsedChunk {
+        std::vector<BookRecord> books;
+        std::vector<size_t> lineNumbers;   // ÿڿڵк
+        std::vector<std::pair<size_t, std::string>> warnings;  // к -> 
+        size_t lineCount = 0;
+        uint32_t checksum = 0;
+    };
+
+    void parseChunk(const char* p, const char* end, ParsedChunk& chunk) {
+        chunk.books.reserve(static_cast<size_t>(end - p) / 64);
+        BookRecord book;
+        std::string error;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            const char* lineEnd = nl ? nl : end;
+            std::string_view line(p, static_cast<size_t>(lineEnd - p));
+            p = nl ? nl + 1 : end;
+            ++chunk.lineCount;
+
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty()) continue;
+            chunk.checksum = BookJournal::addSnapshotLine(chunk.checksum, line.data(), line.size());
+
+            if (!Book::tryParse(line, book, error)) {
+                chunk.warnings.emplace_back(chunk.lineCount, error);
+                continue;
+            }
+            chunk.books.push_back(book);
+            chunk.lineNumbers.push_back(chunk.lineCount);
+        }
+    }
+
+    // ззݣСļֵÿ߳
+    std::vector<std::pair<const char*, const char*>> splitChunks(const char* begin, const char* end) {
+        const size_t minChunkSize = 1 << 20;
+        size_t size = static_cast<size_t>(end - begin);
+        size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        size_t count = std::max<size_t>(1, std::min(threads, size / minChunkSize));
+
+        std::vector<std::pair<const char*, const char*>> chunks;
+        const char* p = begin;
+        for (size_t i = 1; i < count && p < end; ++i) {
+            const char* target = begin + size * i / count;
+            if (target < p) continue;
+            const char* nl = static_cast<const char*>(std::memchr(target, '\n', static_cast<size_t>(end - target)));
+            if (!nl) break;
+            chunks.emplace_back(p, nl + 1);
+            p = nl + 1;
+        }
+        if (p < end) chunks.emplace_back(p, end);
+        return chunks;
+    }
+}
+
 void Library::loadBooks() {
-    std::ifstream file(dataFile);
-    if (!file.is_open()) {
-        std::cout << "״Уڴµͼݿ..." << std::endl;
-        return;
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Load);
+    uint32_t snapshotChecksum = 0;
+    MappedFile file;
+    if (!file.open(dataFile)) {
+        messages() << "״Уڴµͼݿ..." << std::endl;
     }
+    else {
+        metrics.addBytesRead(file.size());
+        // 鲢нÿ߳дԵĻ
+        auto ranges = splitChunks(file.data(), file.data() + file.size());
+        std::vector<ParsedChunk> chunks(ranges.size());
+        if (ranges.size() == 1) {
+            parseChunk(ranges[0].first, ranges[0].second, chunks[0]);
+        }
+        else {
+            std::vector<std::thread> workers;
+            workers.reserve(ranges.size());
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                workers.emplace_back(parseChunk, ranges[i].first, ranges[i].second, std::ref(chunks[i]));
+            }
+            for (auto& worker : workers) worker.join();
+        }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        try {
-            Book book = Book::fromString(line);
-            books.push_back(book);
+        // ļ˳ϲϲʱظISBN
+        size_t total = 0;
+        for (const auto& chunk : chunks) total += chunk.books.size();
+        books.reserve(books.slotCount() + total);
+
+        std::vector<std::pair<size_t, std::string>> warnings;
+        size_t first = books.slotCount();
+        size_t lineBase = 0;
+        for (auto& chunk : chunks) {
+            snapshotChecksum += chunk.checksum;
+            for (auto& warning : chunk.warnings) {
+                warnings.emplace_back(lineBase + warning.first, std::move(warning.second));
+            }
+            for (size_t i = 0; i < chunk.books.size(); ++i) {
+                const BookRecord& book = chunk.books[i];
+                if (isISBNExists(book.isbn)) {
+                    warnings.emplace_back(lineBase + chunk.lineNumbers[i], "ISBN " + std::string(book.isbn) + " ظ");
+                    continue;
+                }
+                applyAdd(book, TextFields);
+            }
+            chunk.books.clear();
+            chunk.books.shrink_to_fit();
+            lineBase += chunk.lineCount;
         }
-        catch (...) {
-            std::cerr << "棺޷ݣС" << std::endl;
+        buildOrderedIndexes(first);
+
+        // ͳһ
+        if (!warnings.empty()) {
+            std::sort(warnings.begin(), warnings.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+            const size_t maxShown = 10;
+            for (size_t i = 0; i < warnings.size() && i < maxShown; ++i) {
+                std::cerr << "棺 " << warnings[i].first << " " << warnings[i].second << "С" << std::endl;
+            }
+            if (warnings.size() > maxShown) {
+                std::cerr << "棺 " << warnings.size() - maxShown << " ޷أ" << std::endl;
+            }
         }
     }
 
-    file.close();
-    std::cout << "ɹ " << books.size() << " ͼݡ" << std::endl;
+    // طſ֮Ĳ־
+    size_t replayed = journal.replay(snapshotChecksum,
+        [this](const std::string& record) { applyJournalRecord(record); });
+    metrics.addBytesRead(journal.replayedBytes());
+    journal.open(snapshotChecksum);
+    circulation.load();
+
+    messages() << "ɹ " << books.size() << " ͼ";
+    if (replayed > 0) {
+        messages() << "ط־ " << replayed << " ";
+    }
+    if (circulation.loanCount() > 0) {
+        messages() << "δ " << circulation.loanCount() << " ";
+    }
+    messages() << "" << std::endl;
+    assert(verifyStatistics());
+}
+
+bool Library::startSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (snapshotJob) return false;
+    if (snapshotFailed) {
+        // һûдɣ־ȻƳٳ־ûڼ޸Ҫһд
+        snapshotFailed = false;
+        unsavedChanges = true;
+    }
+    if (!snapshotWriter.joinable()) {
+        snapshotWriter = std::thread(&Library::snapshotLoop, this);
+    }
+    snapshotJob = SnapshotJob{ books.snapshot(), journal.mark() };
+    unsavedChanges = false;
+    snapshotChanged.notify_all();
+    return true;
 }
 
-void Library::saveBooks() const {
-    std::ofstream file(dataFile);
-    if (!file.is_open()) {
+void Library::snapshotLoop() {
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    while (true) {
+        snapshotChanged.wait(lock, [this] { return snapshotStopping || snapshotJob; });
+        if (!snapshotJob) return;
+
+        // дڼ䲻ύֻǷڣĶ
+        lock.unlock();
+        bool ok = writeSnapshot(*snapshotJob);
+        lock.lock();
+        if (!ok) snapshotFailed = true;
+        snapshotJob.reset();
+        snapshotChanged.notify_all();
+    }
+}
+
+namespace {
+    //  Book::toString() ͬиʽ
+    void appendBookLine(std::string& out, const BookStore::Snapshot& snapshot, size_t index) {
+        char number[64];
+        out += snapshot.isbn(index);
+        out += '|';
+        out += snapshot.title(index);
+        out += '|';
+        out += snapshot.author(index);
+        out += '|';
+        out += snapshot.publisher(index);
+        out += '|';
+        out += snapshot.publishDate(index);
+        out += '|';
+        out.append(number, std::to_chars(number, number + sizeof(number), snapshot.price(index),
+            std::chars_format::fixed, 2).ptr);
+        out += '|';
+        out.append(number, std::to_chars(number, number + sizeof(number), snapshot.quantity(index)).ptr);
+    }
+}
+
+bool Library::writeSnapshot(const SnapshotJob& job) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Save);
+    const std::string tmpFile = dataFile + ".tmp";
+    FILE* file = std::fopen(tmpFile.c_str(), "wb");
+    if (!file) {
         std::cerr << "޷ļб档" << std::endl;
-        return;
+        return false;
     }
 
-    for (const auto& book : books) {
-        file << book.toString() << std::endl;
+    // дʱգ滻ʽļд;ʧܻж϶ƻԭ
+    const size_t blockSize = 1 << 20;
+    const BookStore::Snapshot& snapshot = job.snapshot;
+    uint32_t snapshotChecksum = 0;
+    uint64_t written = 0;
+    std::string block;
+    block.reserve(blockSize + 4096);
+    for (size_t i = 0; i < snapshot.slotCount(); ++i) {
+        if (!snapshot.contains(i)) continue;
+        size_t lineStart = block.size();
+        appendBookLine(block, snapshot, i);
+        snapshotChecksum = BookJournal::addSnapshotLine(snapshotChecksum, block.data() + lineStart, block.size() - lineStart);
+        block += '\n';
+        if (block.size() >= blockSize) {
+            written += std::fwrite(block.data(), 1, block.size(), file);
+            block.clear();
+        }
+    }
+    written += std::fwrite(block.data(), 1, block.size(), file);
+    metrics.addBytesWritten(written);
+    bool ok = !std::ferror(file);
+    BookJournal::syncFile(file);
+    std::fclose(file);
+
+    std::error_code ec;
+    if (!ok) {
+        std::cerr << "дݿʧܡ" << std::endl;
+        std::filesystem::remove(tmpFile, ec);
+        return false;
     }
+    // ־֮滻գ滻л־ǰжʱʱط־ʱļ
+    bool replaced = false;
+    bool rotated = journal.rotate(snapshotChecksum, job.journalMark, [&] {
+        std::filesystem::rename(tmpFile, dataFile, ec);
+        replaced = !ec;
+        return replaced;
+    });
+    if (!replaced) {
+        std::cerr << "޷滻ļ " << dataFile << "" << std::endl;
+        std::filesystem::remove(tmpFile, ec);
+        return false;
+    }
+    if (!rotated) {
+        std::cerr << "޷л־ļ֮޸Ľ޷档" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Book Library::bookAt(size_t index) const {
+    return Book(std::string(books.isbn(index)), std::string(books.title(index)),
+        std::string(books.author(index)), std::string(books.publisher(index)),
+        std::string(books.publishDate(index)), books.price(index), books.quantity(index));
+}
+
+void Library::indexBook(size_t index, unsigned fields) {
+    uint32_t slot = static_cast<uint32_t>(index);
+    if (fields & TitleField) textIndex.add(slot, TextIndex::Title, books.title(index));
+    if (fields & AuthorField) textIndex.add(slot, TextIndex::Author, books.author(index));
+    if (fields & PublisherField) textIndex.add(slot, TextIndex::Publisher, books.publisher(index));
+    if (fields & PriceField) priceIndex.add(books.price(index), slot);
+    if (fields & QuantityField) quantityIndex.add(books.quantity(index), slot);
+    if (fields & DateField) {
+        int32_t dateKey = publishDateKey(books.publishDate(index));
+        if (dateKey >= 0) dateIndex.add(dateKey, slot);
+    }
+}
+
+void Library::unindexBook(size_t index, unsigned fields) {
+    uint32_t slot = static_cast<uint32_t>(index);
+    if (fields & TitleField) textIndex.remove(slot, TextIndex::Title, books.title(index));
+    if (fields & AuthorField) textIndex.remove(slot, TextIndex::Author, books.author(index));
+    if (fields & PublisherField) textIndex.remove(slot, TextIndex::Publisher, books.publisher(index));
+    if (fields & PriceField) priceIndex.remove(books.price(index), slot);
+    if (fields & QuantityField) quantityIndex.remove(books.quantity(index), slot);
+    if (fields & DateField) {
+        int32_t dateKey = publishDateKey(books.publishDate(index));
+        if (dateKey >= 0) dateIndex.remove(dateKey, slot);
+    }
+}
+
+void Library::clearIndexes() {
+    textIndex.clear();
+    priceIndex.clear();
+    quantityIndex.clear();
+    dateIndex.clear();
+}
+
+void Library::buildOrderedIndexes(size_t first) {
+    for (size_t i = first; i < books.slotCount(); ++i) {
+        uint32_t slot = static_cast<uint32_t>(i);
+        priceIndex.bulkAdd(books.price(i), slot);
+        quantityIndex.bulkAdd(books.quantity(i), slot);
+        int32_t dateKey = publishDateKey(books.publishDate(i));
+        if (dateKey >= 0) dateIndex.bulkAdd(dateKey, slot);
+    }
+    priceIndex.finishBulkLoad();
+    quantityIndex.finishBulkLoad();
+    dateIndex.finishBulkLoad();
+}
+
+void Library::applyAdd(const Book& book) {
+    applyAdd(book.record());
+}
 
-    file.close();
-    std::cout << "ͼѱ浽 " << dataFile << "" << std::endl;
+void Library::applyAdd(const BookRecord& book, unsigned indexedFields) {
+    size_t index = books.push_back(book.isbn, book.title, book.author, book.publisher, book.publishDate,
+        book.price, book.quantity);
+    indexBook(index, indexedFields);
+    stats.add(book.isbn, book.author, book.publisher, book.price, book.quantity);
 }
 
-int Library::findBookIndex(const std::string& isbn) const {
-    for (size_t i = 0; i < books.size(); ++i) {
-        if (books[i].getISBN() == isbn) {
-            return static_cast<int>(i);
+void Library::applyUpdate(size_t index, const Book& newBookInfo) {
+    const std::string& newISBN = newBookInfo.getISBN();
+    cache.invalidate(books.isbn(index));
+    // ֻؽб仯ֶεĸļۡĿ治ű
+    unsigned changed = 0;
+    if (books.title(index) != newBookInfo.getTitle()) changed |= TitleField;
+    if (books.author(index) != newBookInfo.getAuthor()) changed |= AuthorField;
+    if (books.publisher(index) != newBookInfo.getPublisher()) changed |= PublisherField;
+    if (books.price(index) != newBookInfo.getPrice()) changed |= PriceField;
+    if (books.quantity(index) != newBookInfo.getQuantity()) changed |= QuantityField;
+    if (books.publishDate(index) != newBookInfo.getPublishDate()) changed |= DateField;
+    unindexBook(index, changed);
+    stats.remove(books.isbn(index), books.author(index), books.publisher(index), books.price(index), books.quantity(index));
+    books.set(index, newISBN, newBookInfo.getTitle(), newBookInfo.getAuthor(), newBookInfo.getPublisher(),
+        newBookInfo.getPublishDate(), newBookInfo.getPrice(), newBookInfo.getQuantity());
+    indexBook(index, changed);
+    stats.add(newISBN, newBookInfo.getAuthor(), newBookInfo.getPublisher(), newBookInfo.getPrice(), newBookInfo.getQuantity());
+}
+
+void Library::applyClear() {
+    books.clear();
+    clearIndexes();
+    cache.clear();
+    stats.clear();
+}
+
+void Library::applyDelete(size_t index) {
+    cache.invalidate(books.isbn(index));
+    unindexBook(index);
+    stats.remove(books.isbn(index), books.author(index), books.publisher(index), books.price(index), books.quantity(index));
+    books.erase(index);
+
+    // ͼĲλ䣬ĶλڴͼʱѹʵһΣ
+    // ɴǰɾ̯
+    if (books.vacantSlots() >= std::max<size_t>(1024, books.size())) {
+        compactSlots();
+    }
+}
+
+void Library::compactSlots() {
+    std::vector<uint32_t> newSlots = books.compactSlots();
+    textIndex.remap(newSlots);
+    priceIndex.remap(newSlots);
+    quantityIndex.remap(newSlots);
+    dateIndex.remap(newSlots);
+}
+
+void Library::applyOperation(const BookOperation& operation) {
+    switch (operation.type) {
+    case BookOperation::Add:
+        applyAdd(operation.book);
+        break;
+    case BookOperation::Update:
+        applyUpdate(static_cast<size_t>(findBookIndex(operation.isbn)), operation.book);
+        break;
+    case BookOperation::Delete:
+        applyDelete(static_cast<size_t>(findBookIndex(operation.isbn)));
+        break;
+    }
+}
+
+void Library::applyJournalRecord(const std::string& record) {
+    if (record == "C") {
+        applyClear();
+        return;
+    }
+    BookOperation operation;
+    std::string error;
+    bool valid = BookOperation::tryParse(record, operation, error);
+    if (valid) {
+        bool targetExists = isISBNExists(operation.isbn);
+        switch (operation.type) {
+        case BookOperation::Add:
+            valid = !targetExists;
+            break;
+        case BookOperation::Update:
+            valid = targetExists && (operation.book.getISBN() == operation.isbn
+                || !isISBNExists(operation.book.getISBN()));
+            break;
+        case BookOperation::Delete:
+            valid = targetExists;
+            break;
         }
     }
-    return -1;
+    if (!valid) {
+        std::cerr << "棺޷ط־¼" << std::endl;
+        return;
+    }
+    applyOperation(operation);
+}
+
+bool Library::logMutation(const std::string& record) {
+    if (persistenceDeferred) {
+        unsavedChanges = true;  // Ƴٵ persist() ʱд
+        return true;
+    }
+    LibraryMetrics::Span span(metrics, LibraryMetrics::JournalAppend);
+    if (!journal.append(record)) return false;
+    metrics.addBytesWritten(record.size() + BookJournal::recordOverhead);
+    return true;
+}
+
+bool Library::logMutationGroup(const std::vector<std::string>& records) {
+    if (persistenceDeferred) {
+        unsavedChanges = true;
+        return true;
+    }
+    LibraryMetrics::Span span(metrics, LibraryMetrics::JournalAppend);
+    if (!journal.appendGroup(records)) return false;
+    uint64_t bytes = 0;
+    for (const std::string& record : records) bytes += record.size() + BookJournal::recordOverhead;
+    metrics.addBytesWritten(bytes);
+    return true;
+}
+
+void Library::compactJournalIfNeeded() {
+    if (persistenceDeferred) return;
+    // ֵͼ֤ÿ޸ķ̯ѹΪ
+    // һݿջдʱ֮޸Ļٴδڼ޸ĺϲͬһݿ
+    if (journal.recordCount() >= std::max(journalCompactThreshold, books.size())) {
+        startSnapshot();
+    }
+}
+
+std::ostream& Library::messages() const {
+    static std::ostream discard(nullptr);
+    return messageStream ? *messageStream : discard;
+}
+
+bool Library::reportError(const std::string& error) const {
+    messages() << "" << error << "" << std::endl;
+    return false;
+}
+
+void Library::setMessageStream(std::ostream* stream) {
+    messageStream = stream;
+}
+
+void Library::forEachBook(const std::function<void(const Book&)>& visit) const {
+    for (size_t i = 0; i < books.slotCount(); ++i) {
+        if (books.contains(i)) visit(bookAt(i));
+    }
+}
+
+void Library::setJournalSyncInterval(size_t interval) {
+    journal.setSyncInterval(interval);
+    circulation.setSyncInterval(interval);
 }
 
-bool Library::getBook(const std::string& isbn, Book& outBook) const {
+void Library::setJournalCompactThreshold(size_t threshold) {
+    journalCompactThreshold = threshold;
+}
+
+bool Library::setPersistenceDeferred(bool deferred) {
+    // رǰȱ棺֮־¼ڰЩ޸ĵĿ
+    bool ok = deferred || persist();
+    persistenceDeferred = deferred;
+    return ok;
+}
+
+bool Library::persist() {
+    flush();   // ȵȽед룻ʧʱд
+    if (!unsavedChanges && journal.recordCount() == 0) return true;
+    startSnapshot();
+    if (!flush()) return false;
+    messages() << "ͼѱ浽 " << dataFile << "" << std::endl;
+    return true;
+}
+
+bool Library::flush() {
+    journal.sync();
+    circulation.sync();
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    snapshotChanged.wait(lock, [this] { return !snapshotJob; });
+    if (!snapshotFailed) return true;
+    snapshotFailed = false;
+    unsavedChanges = true;
+    return false;
+}
+
+int Library::findBookIndex(std::string_view isbn) const {
+    size_t index = books.find(isbn);
+    if (index == BookStore::npos) return -1;
+    return static_cast<int>(index);
+}
+
+bool Library::getBook(std::string_view isbn, Book& outBook) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Lookup);
     int index = findBookIndex(isbn);
     if (index == -1) return false;
-    outBook = books[static_cast<size_t>(index)];
+    outBook = bookAt(static_cast<size_t>(index));
     return true;
 }
 
+Library::BookHandle Library::findBook(std::string_view isbn) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Lookup);
+    if (BookHandle cached = cache.find(isbn)) return cached;
+    int index = findBookIndex(isbn);
+    if (index == -1) return nullptr;
+
+    auto book = std::make_shared<const Book>(bookAt(static_cast<size_t>(index)));
+    // ռãӸֶڶϵַ
+    size_t bytes = sizeof(Book);
+    for (std::string_view field : { books.isbn(index), books.title(index), books.author(index),
+        books.publisher(index), books.publishDate(index) }) {
+        if (field.size() >= sizeof(std::string)) bytes += field.size() + 1;
+    }
+    cache.insert(isbn, book, bytes);
+    return book;
+}
+
+BookCache::Metrics Library::getCacheMetrics() const {
+    return cache.metrics();
+}
+
+void Library::setCacheCapacity(size_t capacity) {
+    cache.setCapacity(capacity);
+}
+
 bool Library::addBook(const Book& book) {
+    std::string error;
+    return addBook(book, error) || reportError(error);
+}
+
+bool Library::addBook(const Book& book, std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Add);
+    if (!book.validate(error)) return false;
     if (isISBNExists(book.getISBN())) {
-        std::cout << "ISBN " << book.getISBN() << " Ѵڡ" << std::endl;
+        error = "ISBN " + book.getISBN() + " Ѵ";
         return false;
     }
 
-    books.push_back(book);
-    saveBooks();  // ӺԶ
-    std::cout << "ɹͼ飺" << book.getTitle() << std::endl;
+    // д־޸
+    if (!logMutation("A|" + book.toString())) {
+        error = "޷д־ļδִ";
+        return false;
+    }
+    applyAdd(book);
+    messages() << "ɹͼ飺" << book.getTitle() << std::endl;
+    compactJournalIfNeeded();
     return true;
 }
 
 bool Library::updateBook(const std::string& isbn, const Book& newBookInfo) {
+    std::string error;
+    return updateBook(isbn, newBookInfo, error) || reportError(error);
+}
+
+bool Library::updateBook(const std::string& isbn, const Book& newBookInfo, std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Update);
     int index = findBookIndex(isbn);
     if (index == -1) {
-        std::cout << "δҵISBN " << isbn << " ͼ顣" << std::endl;
+        error = "δҵISBN " + isbn + " ͼ";
         return false;
     }
+    if (!newBookInfo.validate(error)) return false;
 
     // µISBNǷͼͻ
     if (newBookInfo.getISBN() != isbn && isISBNExists(newBookInfo.getISBN())) {
-        std::cout << "µISBN " << newBookInfo.getISBN() << " Ѵڡ" << std::endl;
+        error = "µISBN " + newBookInfo.getISBN() + " Ѵ";
         return false;
     }
+    error = circulationConflict(BookOperation{ BookOperation::Update, isbn, newBookInfo });
+    if (!error.empty()) return false;
 
-    books[index] = newBookInfo;
-    saveBooks();  // ºԶ
-    std::cout << "ɹͼϢ" << std::endl;
+    if (!logMutation("U|" + isbn + "|" + newBookInfo.toString())) {
+        error = "޷д־ļδִ";
+        return false;
+    }
+    applyUpdate(static_cast<size_t>(index), newBookInfo);
+    messages() << "ɹͼϢ" << std::endl;
+    compactJournalIfNeeded();
     return true;
 }
 
+bool Library::updateBook(const std::string& isbn, const BookPatch& patch) {
+    std::string error;
+    return updateBook(isbn, patch, error) || reportError(error);
+}
+
+bool Library::updateBook(const std::string& isbn, const BookPatch& patch, std::string& error) {
+    int index = findBookIndex(isbn);
+    if (index == -1) {
+        error = "δҵISBN " + isbn + " ͼ";
+        return false;
+    }
+
+    // δֶԭֵ־Լ¼ͼ
+    size_t i = static_cast<size_t>(index);
+    auto pick = [](const std::optional<std::string>& value, std::string_view current) {
+        return value ? *value : std::string(current);
+    };
+    Book newBookInfo(pick(patch.isbn, books.isbn(i)), pick(patch.title, books.title(i)),
+        pick(patch.author, books.author(i)), pick(patch.publisher, books.publisher(i)),
+        pick(patch.publishDate, books.publishDate(i)),
+        patch.price.value_or(books.price(i)), patch.quantity.value_or(books.quantity(i)));
+    return updateBook(isbn, newBookInfo, error);
+}
+
 bool Library::deleteBook(const std::string& isbn) {
+    std::string error;
+    return deleteBook(isbn, error) || reportError(error);
+}
+
+bool Library::deleteBook(const std::string& isbn, std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Delete);
     int index = findBookIndex(isbn);
     if (index == -1) {
-        std::cout << "δҵISBN " << isbn << " ͼ顣" << std::endl;
+        error = "δҵISBN " + isbn + " ͼ";
+        return false;
+    }
+    error = circulationConflict(BookOperation{ BookOperation::Delete, isbn });
+    if (!error.empty()) return false;
+
+    if (!logMutation("D|" + isbn)) {
+        error = "޷д־ļδִ";
         return false;
     }
+    std::string title(books.title(index));
+    applyDelete(static_cast<size_t>(index));
+    messages() << "ɹɾͼ飺" << title << std::endl;
+    compactJournalIfNeeded();
+    return true;
+}
+
+bool Library::applyBatch(const std::vector<BookOperation>& operations) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Batch);
+    // һУ飺ڸĶISBN¼ڹϣУtrue ʾִе˴ʱڣ
+    std::unordered_map<std::string, bool> touched;
+    touched.reserve(operations.size());
+    auto exists = [this, &touched](const std::string& isbn) {
+        auto it = touched.find(isbn);
+        return it != touched.end() ? it->second : isISBNExists(isbn);
+    };
+
+    auto reject = [this](size_t i, const std::string& error) {
+        messages() << "󣺵 " << i + 1 << " ʧܣ" << error << "δִС" << std::endl;
+        return false;
+    };
+
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const BookOperation& op = operations[i];
+        std::string error;
+        if (op.type != BookOperation::Delete && !op.book.validate(error)) return reject(i, error);
+        if (op.type == BookOperation::Add) {
+            if (exists(op.book.getISBN())) error = "ISBN " + op.book.getISBN() + " Ѵ";
+            else touched[op.book.getISBN()] = true;
+        }
+        else if (!exists(op.isbn)) {
+            error = "δҵISBN " + op.isbn + " ͼ";
+        }
+        else if (op.type == BookOperation::Update) {
+            const std::string& newISBN = op.book.getISBN();
+            if (newISBN != op.isbn && exists(newISBN)) {
+                error = "µISBN " + newISBN + " Ѵ";
+            }
+            else {
+                touched[op.isbn] = false;
+                touched[newISBN] = true;
+            }
+        }
+        else {
+            touched[op.isbn] = false;
+        }
+        if (error.empty() && op.type != BookOperation::Add) error = circulationConflict(op);
 
-    std::string title = books[index].getTitle();
-    books.erase(books.begin() + index);
-    saveBooks();  // ɾԶ
-    std::cout << "ɹɾͼ飺" << title << std::endl;
+        if (!error.empty()) return reject(i, error);
+    }
+
+    // Уȫͨдһ¼飨̺޸ڴ棩طʱҪôȫЧҪôȫЧ
+    std::vector<std::string> records;
+    records.reserve(operations.size());
+    for (const auto& op : operations) {
+        records.push_back(op.toString());
+    }
+    if (!logMutationGroup(records)) {
+        messages() << "޷д־ļδִС" << std::endl;
+        return false;
+    }
+    for (const auto& op : operations) {
+        applyOperation(op);
+    }
+    messages() << "ɹִ " << operations.size() << " " << std::endl;
+    compactJournalIfNeeded();
+    assert(verifyStatistics());
     return true;
 }
 
-bool Library::searchBookByISBN(const std::string& isbn) const {
+BookRecord Library::recordAt(size_t index) const {
+    return BookRecord{ books.isbn(index), books.title(index), books.author(index), books.publisher(index),
+        books.publishDate(index), books.price(index), books.quantity(index) };
+}
+
+bool Library::searchBookByISBN(std::string_view isbn, ResultSink& sink) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Lookup);
     int index = findBookIndex(isbn);
     if (index == -1) {
-        std::cout << "δҵISBN " << isbn << " ͼ顣" << std::endl;
+        sink.heading({ "δҵISBN ", isbn, " ͼ顣" });
         return false;
     }
 
-    books[index].displayInfo();
+    sink.write(recordAt(static_cast<size_t>(index)));
     return true;
 }
 
-void Library::searchBookByTitle(const std::string& title) const {
-    bool found = false;
-    std::cout << "\n===  ===" << std::endl;
-    for (const auto& book : books) {
-        if (book.getTitle().find(title) != std::string::npos) {
-            book.displayInfo();
-            found = true;
+void Library::searchText(TextIndex::Field field, std::string_view keyword, ResultSink& sink) const {
+    LibraryMetrics::Span span(metrics, field == TextIndex::Title ? LibraryMetrics::SearchTitle
+        : field == TextIndex::Author ? LibraryMetrics::SearchAuthor : LibraryMetrics::SearchPublisher);
+    size_t scanned = 0, matchedBefore = sink.matched();
+
+    // ű󽻵õѡַٰ߽У飻ѡ󽻱У飬м
+    auto check = [this, field, keyword, &sink, &scanned](uint32_t slot) {
+        ++scanned;
+        std::string_view text = field == TextIndex::Title ? books.title(slot)
+            : field == TextIndex::Author ? books.author(slot) : books.publisher(slot);
+        return !TextIndex::containsText(text, keyword) || sink.write(recordAt(slot));  // false ʾ limit
+    };
+    if (!textIndex.forEachCandidate(field, keyword, check)) {
+        // ؼΪգ޷СΧ
+        for (size_t i = 0; i < books.slotCount(); ++i) {
+            if (books.contains(i) && !check(static_cast<uint32_t>(i))) break;
         }
     }
-    if (!found) {
-        std::cout << "δҵ \"" << title << "\" ͼ顣" << std::endl;
+    span.rows(scanned, sink.matched() - matchedBefore);
+}
+
+void Library::searchBookByTitle(std::string_view title, ResultSink& sink) const {
+    sink.heading("\n===  ===");
+    searchText(TextIndex::Title, title, sink);
+    if (sink.matched() == 0) {
+        sink.heading({ "δҵ \"", title, "\" ͼ顣" });
     }
 }
 
-void Library::searchBookByAuthor(const std::string& author) const {
-    bool found = false;
-    std::cout << "\n===  ===" << std::endl;
-    for (const auto& book : books) {
-        if (book.getAuthor().find(author) != std::string::npos) {
-            book.displayInfo();
-            found = true;
-        }
+void Library::searchBookByAuthor(std::string_view author, ResultSink& sink) const {
+    sink.heading("\n===  ===");
+    searchText(TextIndex::Author, author, sink);
+    if (sink.matched() == 0) {
+        sink.heading({ "δҵ߰ \"", author, "\" ͼ顣" });
     }
-    if (!found) {
-        std::cout << "δҵ߰ \"" << author << "\" ͼ顣" << std::endl;
+}
+
+void Library::searchBookByPublisher(std::string_view publisher, ResultSink& sink) const {
+    sink.heading("\n===  ===");
+    searchText(TextIndex::Publisher, publisher, sink);
+    if (sink.matched() == 0) {
+        sink.heading({ "δҵ \"", publisher, "\" ͼ顣" });
     }
 }
 
-void Library::displayAllBooks() const {
-    if (books.empty()) {
-        std::cout << "ͼûͼ顣" << std::endl;
+namespace {
+    // ༭СǰֶؼʳȽӽǰٰ洢˳
+    struct RankedHit {
+        size_t distance;
+        size_t lengthGap;
+        uint32_t slot;
+
+        bool operator<(const RankedHit& other) const {
+            if (distance != other.distance) return distance < other.distance;
+            if (lengthGap != other.lengthGap) return lengthGap < other.lengthGap;
+            return slot < other.slot;
+        }
+    };
+}
+
+void Library::searchRanked(TextIndex::Field field, std::string_view keyword, ResultSink& sink, size_t limit) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::SearchFuzzy);
+    sink.heading(field == TextIndex::Title ? "\n=== ģƶ ==="
+        : field == TextIndex::Author ? "\n=== ģƶ ===" : "\n=== ģƶ ===");
+    std::vector<uint32_t> pattern;
+    TextIndex::foldChars(keyword, pattern);
+    if (pattern.size() > TextIndex::maxFuzzyChars) pattern.resize(TextIndex::maxFuzzyChars);
+    if (pattern.empty() || limit == 0) {
+        sink.heading({ "δҵ \"", keyword, "\" ͼ顣" });
         return;
     }
 
-    std::cout << "\n=== ͼͼб ===" << std::endl;
-    std::cout << "ܹ " << books.size() << " ͼ" << std::endl;
-    std::cout << "------------------------" << std::endl;
-    for (const auto& book : books) {
-        std::cout << "ISBN: " << book.getISBN() << std::endl;
-        std::cout << ": " << book.getTitle() << std::endl;
-        std::cout << ": " << book.getAuthor() << std::endl;
-        std::cout << "۸: " << std::fixed << std::setprecision(2) << book.getPrice() << "Ԫ" << std::endl;
-        std::cout << ": " << book.getQuantity() << "" << std::endl;
-        std::cout << "------------------------" << std::endl;
+    // ű˳ѡ𱾼ضϵı༭룻Ѷǵǰ limit 
+    // ֻҲͼ飬ضϾ֮ս
+    size_t bound = TextIndex::fuzzyEditBudget(pattern.size());
+    TextIndex::FuzzyCandidates candidates;
+    textIndex.fuzzyCandidates(field, pattern, bound, candidates);
+    std::vector<RankedHit> best;
+    best.reserve(std::min(limit, books.size()) + 1);
+    std::vector<uint32_t> text;
+    size_t scanned = 0;
+    auto verify = [&](uint32_t slot) {
+        ++scanned;
+        TextIndex::foldChars(field == TextIndex::Title ? books.title(slot)
+            : field == TextIndex::Author ? books.author(slot) : books.publisher(slot), text);
+        if (text.size() + bound < pattern.size()) return;
+        size_t distance = TextIndex::substringDistance(pattern.data(), pattern.size(), text.data(), text.size(), bound);
+        if (distance > bound) return;
+        size_t gap = text.size() > pattern.size() ? text.size() - pattern.size() : pattern.size() - text.size();
+        RankedHit hit{ distance, gap, slot };
+        if (best.size() == limit) {
+            if (!(hit < best.front())) return;
+            std::pop_heap(best.begin(), best.end());
+            best.back() = hit;
+        }
+        else {
+            best.push_back(hit);
+        }
+        std::push_heap(best.begin(), best.end());
+        if (best.size() == limit) bound = best.front().distance;
+    };
+    if (candidates.filtered) {
+        // ѡеļӶൽУǰ limit սضϾ󣬼ѡУ
+        for (size_t i = 0; i < candidates.slots.size(); ++i) {
+            if (candidates.shared[i] < candidates.required(bound)) break;
+            verify(candidates.slots[i]);
+        }
+    }
+    else {
+        for (size_t i = 0; i < books.slotCount(); ++i) {
+            if (books.contains(i)) verify(static_cast<uint32_t>(i));
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (const RankedHit& hit : best) {
+        if (!sink.write(recordAt(hit.slot))) break;
+    }
+    span.rows(scanned, best.size());
+    if (best.empty()) {
+        sink.heading({ "δҵ \"", keyword, "\" ͼ顣" });
     }
 }
 
-void Library::clearAllBooks() {
+void Library::displayAllBooks(ResultSink& sink) const {
     if (books.empty()) {
-        std::cout << "ͼѾǿյġ" << std::endl;
+        sink.heading("ͼûͼ顣");
         return;
     }
 
-    std::cout << "棺ȷҪɾͼ¼(y/n): ";
-    char confirm;
-    std::cin >> confirm;
-    if (confirm == 'y' || confirm == 'Y') {
-        books.clear();
-        saveBooks();  // պԶ
-        std::cout << "ɹɾͼ¼" << std::endl;
+    sink.heading("\n=== ͼͼб ===");
+    sink.heading("ܹ " + std::to_string(books.size()) + " ͼ");
+    sink.heading("------------------------");
+    LibraryMetrics::Span span(metrics, LibraryMetrics::List);
+    size_t matchedBefore = sink.matched();
+    for (size_t i = 0; i < books.slotCount(); ++i) {
+        if (books.contains(i) && !sink.write(recordAt(i))) break;
     }
-    else {
-        std::cout << "ȡ" << std::endl;
+    span.rows(sink.matched() - matchedBefore, sink.matched() - matchedBefore);
+}
+
+void Library::findBooksByPrice(double low, double high, ResultSink& sink, bool descending) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::RangeScan);
+    size_t matchedBefore = sink.matched();
+    priceIndex.scan(low, high, [this, &sink](double, uint32_t slot) { return sink.write(recordAt(slot)); }, descending);
+    span.rows(sink.matched() - matchedBefore, sink.matched() - matchedBefore);   // ڵж
+}
+
+void Library::findBooksByQuantity(int low, int high, ResultSink& sink, bool descending) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::RangeScan);
+    size_t matchedBefore = sink.matched();
+    quantityIndex.scan(low, high, [this, &sink](int, uint32_t slot) { return sink.write(recordAt(slot)); }, descending);
+    span.rows(sink.matched() - matchedBefore, sink.matched() - matchedBefore);
+}
+
+void Library::findBooksByPublishDate(int32_t lowKey, int32_t highKey, ResultSink& sink, bool descending) const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::RangeScan);
+    size_t matchedBefore = sink.matched();
+    dateIndex.scan(lowKey, highKey, [this, &sink](int32_t, uint32_t slot) { return sink.write(recordAt(slot)); }, descending);
+    span.rows(sink.matched() - matchedBefore, sink.matched() - matchedBefore);
+}
+
+bool Library::clearAllBooks() {
+    std::string error;
+    return clearAllBooks(error) || reportError(error);
+}
+
+bool Library::clearAllBooks(std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Clear);
+    if (circulation.loanCount() > 0) {
+        error = " " + std::to_string(circulation.loanCount()) + " ͼδ";
+        return false;
+    }
+    if (!logMutation("C")) {
+        error = "޷д־ļδִ";
+        return false;
     }
+    journal.sync();
+    applyClear();
+    messages() << "ɹɾͼ¼" << std::endl;
+    // տյĴۺС˳ϲǰ־
+    if (!persistenceDeferred) startSnapshot();
+    return true;
+}
+
+bool Library::addPatron(uint32_t patron, std::string_view name, std::string& error) {
+    return circulation.addPatron(patron, name, error);
+}
+
+bool Library::borrowBook(std::string_view isbn, uint32_t patron, int32_t due, Circulation::LoanInfo& loan,
+    std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Borrow);
+    int index = findBookIndex(isbn);
+    if (index == -1) {
+        error = "δҵISBN " + std::string(isbn) + " ͼ";
+        return false;
+    }
+    return circulation.checkout(isbn, books.quantity(static_cast<size_t>(index)), patron, Circulation::today(), due,
+        loan, error);
+}
+
+bool Library::returnBook(std::string_view isbn, uint32_t copy, Circulation::LoanInfo& loan, std::string& error) {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Return);
+    return circulation.checkin(isbn, copy, Circulation::today(), loan, error);
+}
+
+int Library::getAvailableCopies(std::string_view isbn) const {
+    int index = findBookIndex(isbn);
+    if (index == -1) return -1;
+    int onLoan = static_cast<int>(circulation.onLoan(isbn));
+    return std::max(0, books.quantity(static_cast<size_t>(index)) - onLoan);
+}
+
+std::string Library::circulationConflict(const BookOperation& operation) const {
+    if (operation.type == BookOperation::Add) return "";
+    uint32_t onLoan = circulation.onLoan(operation.isbn);
+    if (onLoan == 0) return "";
+    std::string prefix = "ISBN " + operation.isbn + "  " + std::to_string(onLoan) + " δ";
+    if (operation.type == BookOperation::Delete) return prefix + "ɾ";
+    if (operation.book.getISBN() != operation.isbn) return prefix + "޸ISBN";
+    if (operation.book.getQuantity() < static_cast<int>(onLoan)) return prefix + "ڽ";
+    return "";
 }
 
 void Library::generateStatistics() const {
+    LibraryMetrics::Span span(metrics, LibraryMetrics::Statistics);
     if (books.empty()) {
         std::cout << "ͼûͼ飬޷ͳϢ" << std::endl;
         return;
@@ -261,39 +1170,57 @@ void Library::generateStatistics() const {
 
     std::cout << "\n=== ͼͳϢ ===" << std::endl;
 
-    int bookTypes = static_cast<int>(books.size());
-    int totalCopies = 0;
-    double totalValue = 0.0;
-    double maxPrice = -1.0;
-    std::string maxPriceTitle;
+    // ֱֵȡάĻ
+    double averagePrice = stats.totalCopies() > 0 ? stats.totalValue() / stats.totalCopies() : 0.0;
+    std::cout << "ͼĿ: " << stats.bookCount() << " " << std::endl;
+    std::cout << "ͼֵܼ: " << std::fixed << std::setprecision(2) << stats.totalValue() << " Ԫ" << std::endl;
+    std::cout << "ƽ۸: " << std::fixed << std::setprecision(2) << averagePrice << " Ԫ" << std::endl;
 
-    for (const auto& book : books) {
-        int qty = book.getQuantity();
-        double price = book.getPrice();
+    double price = 0.0;
+    std::string isbn;
+    if (stats.maxPrice(price, isbn)) {
+        std::cout << "۸ߵͼ: " << books.title(static_cast<size_t>(findBookIndex(isbn))) << " (" << std::fixed << std::setprecision(2) << price << "Ԫ)" << std::endl;
+    }
+    if (stats.minPrice(price, isbn)) {
+        std::cout << "۸͵ͼ: " << books.title(static_cast<size_t>(findBookIndex(isbn))) << " (" << std::fixed << std::setprecision(2) << price << "Ԫ)" << std::endl;
+    }
 
-        totalCopies += qty;
-        totalValue += price * qty;
+    std::cout << "۸λ: " << std::fixed << std::setprecision(2) << stats.pricePercentile(0.5) << " Ԫ" << std::endl;
+    std::cout << "P90 ۸: " << std::fixed << std::setprecision(2) << stats.pricePercentile(0.9) << " Ԫ" << std::endl;
+    std::cout << ": " << stats.totalCopies() << " " << std::endl;
 
-        if (price > maxPrice) {
-            maxPrice = price;
-            maxPriceTitle = book.getTitle();
-        }
+    const char* labels[] = { "0 ", "1-9 ", "10-49 ", "50-99 ", "100 " };
+    const std::vector<size_t>& histogram = stats.quantityHistogram();
+    std::cout << "ֲ:" << std::endl;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        std::cout << "  " << labels[i] << ": " << histogram[i] << " " << std::endl;
     }
 
-    double averagePrice = totalCopies > 0 ? totalValue / totalCopies : 0.0;
-
-    std::cout << "ͼĿ: " << bookTypes << " " << std::endl;
-    std::cout << "ͼֵܼ: " << std::fixed << std::setprecision(2) << totalValue << " Ԫ" << std::endl;
-    std::cout << "ƽ۸: " << std::fixed << std::setprecision(2) << averagePrice << " Ԫ" << std::endl;
-    if (!maxPriceTitle.empty()) {
-        std::cout << "۸ߵͼ: " << maxPriceTitle << " (" << std::fixed << std::setprecision(2) << maxPrice << "Ԫ)" << std::endl;
-    } else {
-        std::cout << "۸ߵͼ: " << std::endl;
+    // ֵгǰҳ
+    using PublisherEntry = std::pair<const std::string*, const CatalogStatistics::Rollup*>;
+    std::vector<PublisherEntry> publishers;
+    publishers.reserve(stats.publishers().size());
+    for (const auto& entry : stats.publishers()) {
+        publishers.emplace_back(&entry.first, &entry.second);
+    }
+    size_t shown = std::min<size_t>(5, publishers.size());
+    std::partial_sort(publishers.begin(), publishers.begin() + shown, publishers.end(),
+        [](const PublisherEntry& a, const PublisherEntry& b) { return a.second->valueCents > b.second->valueCents; });
+    std::cout << ": " << stats.publishers().size() << " ң: " << stats.authors().size() << " λ" << std::endl;
+    for (size_t i = 0; i < shown; ++i) {
+        std::cout << "  " << *publishers[i].first << ": " << publishers[i].second->books << " , "
+            << publishers[i].second->copies << " , " << std::fixed << std::setprecision(2)
+            << publishers[i].second->valueCents / 100.0 << " Ԫ" << std::endl;
     }
-    std::cout << ": " << totalCopies << " " << std::endl;
+
+    BookCache::Metrics cacheMetrics = cache.metrics();
+    std::cout << "ͼ黺: " << cacheMetrics.entries << "/" << cacheMetrics.capacity << " Լ "
+        << (cacheMetrics.memoryBytes + 1023) / 1024 << " KB " << std::fixed << std::setprecision(1)
+        << cacheMetrics.hitRate() * 100.0 << "% " << cacheMetrics.hits << " Σδ "
+        << cacheMetrics.misses << " Σ" << std::endl;
 }
 
-bool Library::isISBNExists(const std::string& isbn) const {
+bool Library::isISBNExists(std::string_view isbn) const {
     return findBookIndex(isbn) != -1;
 }
 
@@ -302,11 +1229,86 @@ int Library::getTotalBooksCount() const {
 }
 
 double Library::getTotalValue() const {
-    double total = 0.0;
-    for (const auto& book : books) {
-        total += book.getPrice() * book.getQuantity();
+    return stats.totalValue();
+}
+
+double Library::getPricePercentile(double q) const {
+    return stats.pricePercentile(q);
+}
+
+bool Library::verifyStatistics() const {
+    CatalogStatistics recomputed;
+    for (size_t i = 0; i < books.slotCount(); ++i) {
+        if (!books.contains(i)) continue;
+        recomputed.add(books.isbn(i), books.author(i), books.publisher(i), books.price(i), books.quantity(i));
+    }
+    if (!(recomputed == stats)) return false;
+
+    // ں˵ɨȶ
+    std::vector<double> priceScratch;
+    std::vector<int> quantityScratch;
+    BookStore::NumericColumns columns = books.numericColumns(priceScratch, quantityScratch);
+    for (double q : { 0.5, 0.9 }) {
+        if (StatsKernels::pricePercentile(columns.prices, columns.count, q) != stats.pricePercentile(q)) return false;
     }
-    return total;
+    PriceSummary summary = StatsKernels::summarize(columns.prices, columns.quantities, columns.count,
+        columns.count >= StatsKernels::parallelThreshold);
+    double price = 0.0;
+    std::string isbn;
+    if (stats.minPrice(price, isbn) && price != summary.minPrice) return false;
+    if (stats.maxPrice(price, isbn) && price != summary.maxPrice) return false;
+    return summary.totalCopies == stats.totalCopies() && summary.valueCents == stats.totalValueCents();
+}
+
+size_t Library::getMemoryUsage() const {
+    return books.memoryUsage() + circulation.memoryUsage();
+}
+
+void Library::writeMetrics(std::ostream& out, bool prometheus) const {
+    if (!prometheus) {
+        metrics.writeJson(out);
+        return;
+    }
+    metrics.writePrometheus(out);
+
+    // ǰֵͼڴռá־뻺
+    BookCache::Metrics cacheMetrics = cache.metrics();
+    std::ostringstream gauges;
+    gauges << "# HELP library_books Books in the catalog.\n# TYPE library_books gauge\n"
+        << "library_books " << books.size() << '\n'
+        << "# HELP library_memory_bytes Estimated memory used by the book store.\n# TYPE library_memory_bytes gauge\n"
+        << "library_memory_bytes " << books.memoryUsage() << '\n'
+        << "# HELP library_journal_records Records in the journal since the last snapshot.\n"
+        << "# TYPE library_journal_records gauge\n"
+        << "library_journal_records " << journal.recordCount() << '\n'
+        << "# HELP library_cache_entries Books held by the lookup cache.\n# TYPE library_cache_entries gauge\n"
+        << "library_cache_entries " << cacheMetrics.entries << '\n'
+        << "# HELP library_cache_hits_total Lookup cache hits.\n# TYPE library_cache_hits_total counter\n"
+        << "library_cache_hits_total " << cacheMetrics.hits << '\n'
+        << "# HELP library_cache_misses_total Lookup cache misses.\n# TYPE library_cache_misses_total counter\n"
+        << "library_cache_misses_total " << cacheMetrics.misses << '\n'
+        << "# HELP library_loans Copies currently on loan.\n# TYPE library_loans gauge\n"
+        << "library_loans " << circulation.loanCount() << '\n'
+        << "# HELP library_loans_overdue Copies on loan past their due date.\n# TYPE library_loans_overdue gauge\n"
+        << "library_loans_overdue " << circulation.overdueCount(Circulation::today()) << '\n'
+        << "# HELP library_patrons Registered patrons.\n# TYPE library_patrons gauge\n"
+        << "library_patrons " << circulation.patronCount() << '\n';
+    out << gauges.str();
+}
+
+bool Library::writeMetricsFile(const std::string& path, bool prometheus) const {
+    const std::string tmpFile = path + ".tmp";
+    std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+    writeMetrics(out, prometheus);
+    out.close();
+
+    std::error_code ec;
+    if (!out) {
+        std::filesystem::remove(tmpFile, ec);
+        return false;
+    }
+    std::filesystem::rename(tmpFile, path, ec);
+    return !ec;
 }
 
 // LibraryUIʵ
@@ -321,9 +1323,22 @@ void LibraryUI::displayMainMenu() const {
     std::cout << "5. ʾͼ" << std::endl;
     std::cout << "6. ͳϢ" << std::endl;
     std::cout << "7. м¼" << std::endl;
+    std::cout << "8. Ĺ" << std::endl;
     std::cout << "0. ˳ϵͳ" << std::endl;
     std::cout << "================================" << std::endl;
-    std::cout << "ѡ (0-7): ";
+    std::cout << "ѡ (0-8): ";
+}
+
+void LibraryUI::displayCirculationMenu() const {
+    std::cout << "\n=== Ĺ ===" << std::endl;
+    std::cout << "1. ǼǶ" << std::endl;
+    std::cout << "2. " << std::endl;
+    std::cout << "3. " << std::endl;
+    std::cout << "4. ѯڽͼ" << std::endl;
+    std::cout << "5. δ嵥" << std::endl;
+    std::cout << "6. ѯɽ" << std::endl;
+    std::cout << "0. ˵" << std::endl;
+    std::cout << "ѡ (0-6): ";
 }
 
 void LibraryUI::displaySearchMenu() const {
@@ -331,26 +1346,22 @@ void LibraryUI::displaySearchMenu() const {
     std::cout << "1. ISBN" << std::endl;
     std::cout << "2. " << std::endl;
     std::cout << "3. " << std::endl;
+    std::cout << "4. " << std::endl;
+    std::cout << "5. ۸" << std::endl;
+    std::cout << "6. ѯ治ͼ" << std::endl;
+    std::cout << "7. " << std::endl;
+    std::cout << "8. ѯ" << std::endl;
+    std::cout << "9. ģ֣ƶ" << std::endl;
     std::cout << "0. ˵" << std::endl;
-    std::cout << "ѡʽ (0-3): ";
+    std::cout << "ѡʽ (0-9): ";
 }
 
 bool LibraryUI::isValidISBN(const std::string& isbn) const {
-    // 򵥵ISBN֤ʵӦӦʹøϸ֤
-    if (isbn.empty()) return false;
-    if (isbn.length() < 10 || isbn.length() > 13) return false;
-
-    // Ƿַֺֻ
-    for (char c : isbn) {
-        if (!isdigit(c) && c != '-') {
-            return false;
-        }
-    }
-    return true;
+    return Book::isValidISBN(isbn);
 }
 
 bool LibraryUI::isValidPrice(double price) const {
-    return price >= 0.0;
+    return std::isfinite(price) && price >= 0.0;
 }
 
 bool LibraryUI::isValidQuantity(int quantity) const {
@@ -449,7 +1460,7 @@ void LibraryUI::handleAddBook() {
 
     double price = getDoubleInput("۸: ");
     while (!isValidPrice(price)) {
-        std::cout << "۸Ϊ" << std::endl;
+        std::cout << "۸ΪǸ" << std::endl;
         price = getDoubleInput("۸: ");
     }
 
@@ -467,42 +1478,34 @@ void LibraryUI::handleUpdateBook() {
     std::cout << "\n=== ޸ͼϢ ===" << std::endl;
     std::string isbn = getStringInput("Ҫ޸ĵͼISBN: ");
 
-    if (!library.isISBNExists(isbn)) {
+    // һβͬʱɴԼȡԭͼϢ
+    Library::BookHandle oldBook = library.findBook(isbn);
+    if (!oldBook) {
         std::cout << "δҵISBN " << isbn << " ͼ飡" << std::endl;
         return;
     }
-
-    // ȡԭͼϢ
-    Book oldBook("", "", "", "", "", 0.0, 0);
-    if (!library.getBook(isbn, oldBook)) {
-        std::cout << "޷ȡԭͼϢ" << std::endl;
-        return;
-    }
     std::cout << "ԭʼϢ" << std::endl;
-    oldBook.displayInfo();
+    oldBook->displayInfo();
     std::cout << "\nµͼϢسԭϢ" << std::endl;
 
-    std::string newISBN = getStringInput("ISBN: ");
-    std::string newTitle = getStringInput(": ");
-    std::string newAuthor = getStringInput(": ");
-    std::string newPublisher = getStringInput("³: ");
-    std::string newPublishDate = getStringInput("³: ");
-
-    double newPrice = oldBook.getPrice();
-    int newQuantity = oldBook.getQuantity();
-    // ѡ루ձʾԭֵ
-    getOptionalDoubleInput("¼۸", newPrice);
-    getOptionalIntInput("", newQuantity);
-
-    // ֶΪգԭֵ
-    if (newISBN.empty()) newISBN = oldBook.getISBN();
-    if (newTitle.empty()) newTitle = oldBook.getTitle();
-    if (newAuthor.empty()) newAuthor = oldBook.getAuthor();
-    if (newPublisher.empty()) newPublisher = oldBook.getPublisher();
-    if (newPublishDate.empty()) newPublishDate = oldBook.getPublishDate();
-
-    Book updatedBook(newISBN, newTitle, newAuthor, newPublisher, newPublishDate, newPrice, newQuantity);
-    library.updateBook(isbn, updatedBook);
+    // ֻ޸ֵֶΣյֶαԭֵ
+    BookPatch patch;
+    auto readField = [this](const std::string& prompt, std::optional<std::string>& field) {
+        std::string value = getStringInput(prompt);
+        if (!value.empty()) field = std::move(value);
+    };
+    readField("ISBN: ", patch.isbn);
+    readField(": ", patch.title);
+    readField(": ", patch.author);
+    readField("³: ", patch.publisher);
+    readField("³: ", patch.publishDate);
+
+    double newPrice = 0.0;
+    int newQuantity = 0;
+    if (getOptionalDoubleInput("¼۸", newPrice)) patch.price = newPrice;
+    if (getOptionalIntInput("", newQuantity)) patch.quantity = newQuantity;
+
+    library.updateBook(isbn, patch);
 }
 
 void LibraryUI::handleDeleteBook() {
@@ -537,17 +1540,88 @@ void LibraryUI::handleSearchBook() {
         switch (choice) {
         case 1: {
             std::string isbn = getStringInput("ISBN: ");
-            library.searchBookByISBN(isbn);
+            ResultSink sink(std::cout);
+            library.searchBookByISBN(isbn, sink);
             break;
         }
         case 2: {
             std::string title = getStringInput("ؼ: ");
-            library.searchBookByTitle(title);
+            ResultSink sink(std::cout);
+            library.searchBookByTitle(title, sink);
             break;
         }
         case 3: {
             std::string author = getStringInput("߹ؼ: ");
-            library.searchBookByAuthor(author);
+            ResultSink sink(std::cout);
+            library.searchBookByAuthor(author, sink);
+            break;
+        }
+        case 4: {
+            std::string publisher = getStringInput("ؼ: ");
+            ResultSink sink(std::cout);
+            library.searchBookByPublisher(publisher, sink);
+            break;
+        }
+        case 5: {
+            double low = getDoubleInput("ͼ۸: ");
+            double high = getDoubleInput("߼۸: ");
+            ResultSink sink(std::cout);
+            sink.heading("\n=== ۸۸ӵ͵ߣ ===");
+            library.findBooksByPrice(low, high, sink);
+            sink.heading("ҵ " + std::to_string(sink.matched()) + " ͼ顣");
+            break;
+        }
+        case 6: {
+            int threshold = getIntInput("벹ֵгڸֵͼ飩: ");
+            ResultSink sink(std::cout);
+            sink.heading("\n===  " + std::to_string(threshold) + " ͼ飨ٵࣩ ===");
+            library.findBooksByQuantity(std::numeric_limits<int>::min(), threshold - 1, sink);
+            sink.heading("ҵ " + std::to_string(sink.matched()) + " ͼ顣");
+            break;
+        }
+        case 7: {
+            std::string from = getStringInput("ʼڣ 1990  1990-05-01: ");
+            std::string to = getStringInput("ֹڣ 2000  2000-12-31: ");
+            int32_t lowKey = publishDateKey(from);
+            int32_t highKey = publishDateUpperKey(to);
+            if (lowKey < 0 || highKey < 0) {
+                std::cout << "޷ʶڸʽ" << std::endl;
+                break;
+            }
+            ResultSink sink(std::cout);
+            sink.heading("\n=== 絽 ===");
+            library.findBooksByPublishDate(lowKey, highKey, sink);
+            sink.heading("ҵ " + std::to_string(sink.matched()) + " ͼ顣");
+            break;
+        }
+        case 8: {
+            std::cout << "ʾauthor contains \"໪\" AND price < 30 AND quantity > 0" << std::endl;
+            std::string text = getStringInput("ѯ: ");
+            Query query;
+            std::string error;
+            if (!Query::parse(text, query, error)) {
+                std::cout << "ѯ" << error << "" << std::endl;
+                break;
+            }
+            QueryEngine::Trace trace;
+            {
+                ResultSink sink(std::cout);
+                sink.heading("\n=== ϲѯ" + query.toString() + " ===");
+                trace = QueryEngine(library).execute(query, sink);
+                sink.heading("ҵ " + std::to_string(sink.matched()) + " ͼ顣");
+            }
+            std::cout << trace.toString();
+            break;
+        }
+        case 9: {
+            int field = getIntInput("ֶΣ1.   2.   3. 磩: ");
+            if (field < 1 || field > 3) {
+                std::cout << "Чѡ" << std::endl;
+                break;
+            }
+            std::string keyword = getStringInput("ؼ: ");
+            ResultSink sink(std::cout);
+            library.searchRanked(static_cast<TextIndex::Field>(field - 1), keyword, sink);
             break;
         }
         case 0:
@@ -566,19 +1640,146 @@ void LibraryUI::handleSearchBook() {
 }
 
 void LibraryUI::handleDisplayAllBooks() {
-    library.displayAllBooks();
+    {
+        ResultSink sink(std::cout, ResultSink::Brief);
+        library.displayAllBooks(sink);
+    }
     std::cout << "\nس...";
     std::string dummy;
     std::getline(std::cin >> std::ws, dummy);
 }
 
 void LibraryUI::handleClearAllBooks() {
-    library.clearAllBooks();
+    if (library.getTotalBooksCount() == 0) {
+        std::cout << "ͼѾǿյġ" << std::endl;
+    }
+    else {
+        std::cout << "棺ȷҪɾͼ¼(y/n): ";
+        char confirm;
+        std::cin >> confirm;
+        if (confirm == 'y' || confirm == 'Y') {
+            library.clearAllBooks();
+        }
+        else {
+            std::cout << "ȡ" << std::endl;
+        }
+    }
     std::cout << "\nس...";
     std::string dummy;
     std::getline(std::cin >> std::ws, dummy);
 }
 
+namespace {
+    // һĵ˵asOf Ϊ 0 ʱ
+    void printLoan(const Library& library, const Circulation::LoanInfo& loan, int32_t asOf) {
+        Library::BookHandle book = library.findBook(loan.isbn);
+        const std::string* name = library.getCirculation().patronName(loan.patron);
+        std::cout << "" << (book ? book->getTitle() : std::string("ѲڹݲУ")) << " ISBN " << loan.isbn
+            << "  " << loan.copy << "   " << loan.patron << (name ? " " + *name : std::string())
+            << "   " << Circulation::formatDate(loan.borrowed) << "  Ӧ " << Circulation::formatDate(loan.due);
+        int late = asOf != 0 ? Circulation::daysBetween(loan.due, asOf) : 0;
+        if (late > 0) std::cout << "   " << late << " ";
+        std::cout << std::endl;
+    }
+}
+
+void LibraryUI::handleCirculation() {
+    int choice;
+    do {
+        displayCirculationMenu();
+        std::cin >> choice;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+        std::string error;
+        Circulation::LoanInfo loan;
+        int32_t today = Circulation::today();
+        switch (choice) {
+        case 1: {
+            int patron = getIntInput("ߺ: ");
+            std::string name = getStringInput(": ");
+            if (patron < 0) {
+                std::cout << "󣺶ߺŲΪ" << std::endl;
+            }
+            else if (!library.addPatron(static_cast<uint32_t>(patron), name, error)) {
+                std::cout << "" << error << "" << std::endl;
+            }
+            else {
+                std::cout << "ѵǼǶ " << patron << " " << name << "" << std::endl;
+            }
+            break;
+        }
+        case 2: {
+            std::string isbn = getStringInput("ISBN: ");
+            int patron = getIntInput("ߺ: ");
+            int days = getIntInput("0 ʾĬϵ " + std::to_string(Circulation::defaultLoanDays) + " 죩: ");
+            if (patron < 0 || days < 0) {
+                std::cout << "󣺶ߺڲΪ" << std::endl;
+                break;
+            }
+            int32_t due = Circulation::addDays(today, days == 0 ? Circulation::defaultLoanDays : days);
+            if (!library.borrowBook(isbn, static_cast<uint32_t>(patron), due, loan, error)) {
+                std::cout << "" << error << "" << std::endl;
+                break;
+            }
+            std::cout << "ɹ";
+            printLoan(library, loan, 0);
+            break;
+        }
+        case 3: {
+            std::string isbn = getStringInput("ISBN: ");
+            int copy = getIntInput("븱: ");
+            if (copy <= 0 || !library.returnBook(isbn, static_cast<uint32_t>(copy), loan, error)) {
+                std::cout << "" << (copy <= 0 ? std::string("Ŵ 1 ʼ") : error) << "" << std::endl;
+                break;
+            }
+            std::cout << "ɹ";
+            printLoan(library, loan, today);
+            break;
+        }
+        case 4: {
+            int patron = getIntInput("ߺ: ");
+            if (patron < 0 || !library.getCirculation().patronName(static_cast<uint32_t>(patron))) {
+                std::cout << "󣺶 " << patron << " δǼǡ" << std::endl;
+                break;
+            }
+            size_t count = 0;
+            library.getCirculation().forEachHeld(static_cast<uint32_t>(patron), [&](const Circulation::LoanInfo& held) {
+                printLoan(library, held, today);
+                ++count;
+                return true;
+            });
+            std::cout << " " << patron << "  " << count << " ᡣ" << std::endl;
+            break;
+        }
+        case 5: {
+            size_t count = 0;
+            library.getCirculation().forEachOverdue(today, [&](const Circulation::LoanInfo& overdue) {
+                printLoan(library, overdue, today);
+                ++count;
+                return true;
+            });
+            std::cout << "칲 " << count << " δ" << std::endl;
+            break;
+        }
+        case 6: {
+            std::string isbn = getStringInput("ISBN: ");
+            int available = library.getAvailableCopies(isbn);
+            if (available < 0) {
+                std::cout << "δҵISBN " << isbn << " ͼ飡" << std::endl;
+                break;
+            }
+            std::cout << " " << library.getCirculation().onLoan(isbn) << " ᣬɽ " << available << " ᡣ" << std::endl;
+            break;
+        }
+        case 0:
+            std::cout << "˵..." << std::endl;
+            break;
+        default:
+            std::cout << "Чѡ룡" << std::endl;
+        }
+    } while (choice != 0);
+}
+
 void LibraryUI::handleGenerateStatistics() {
     library.generateStatistics();
     std::cout << "\nس...";
@@ -591,6 +1792,7 @@ void LibraryUI::run() {
     do {
         displayMainMenu();
         if (!(std::cin >> choice)) {
+            if (std::cin.eof()) break;  // ѽֱܵ꣩˳
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             std::cout << "Чѡ룡" << std::endl;
@@ -598,6 +1800,11 @@ void LibraryUI::run() {
         }
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
+        // ÿ˵ڸмΪһ䣨ȴʱ䣩
+        static const char* const actionNames[] = { "ui.exit", "ui.add_book", "ui.update_book", "ui.delete_book",
+            "ui.search_book", "ui.display_all_books", "ui.statistics", "ui.clear_all_books", "ui.circulation" };
+        LibraryMetrics::Span span(library.getMetrics(),
+            choice >= 0 && choice <= 8 ? actionNames[choice] : "ui.invalid_choice", "ui");
         switch (choice) {
         case 1:
             handleAddBook();
@@ -620,6 +1827,9 @@ void LibraryUI::run() {
         case 7:
             handleClearAllBooks();
             break;
+        case 8:
+            handleCirculation();
+            break;
         case 0:
             std::cout << "лʹͼݹϵͳټ" << std::endl;
             break;
@@ -627,4 +1837,27 @@ void LibraryUI::run() {
             std::cout << "Чѡ룡" << std::endl;
         }
     } while (choice != 0);
+}
+
+int LibraryUI::runScript(std::istream& in, std::ostream& out) {
+    library.setPersistenceDeferred(true);
+
+    size_t succeeded = 0, failed = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;  // ע
+        if (CommandProtocol::execute(library, line, out)) ++succeeded;
+        else ++failed;
+    }
+
+    // ʱһԱ
+    bool saved = library.setPersistenceDeferred(false);
+    if (!saved) {
+        out << "error\tʧ\n";
+        ++failed;
+    }
+    out << "done\t" << succeeded << '\t' << failed << '\n';
+    out.flush();
+    return failed == 0 ? 0 : 1;
 }
\ No newline at end of file
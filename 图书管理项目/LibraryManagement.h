@@ -1,13 +1,30 @@
 #ifndef LIBRARY_MANAGEMENT_SYSTEM_H
 #define LIBRARY_MANAGEMENT_SYSTEM_H
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 #include <algorithm>
 #include <ctime>
 #include <fstream>
 #include <sstream>
 #include <limits>
+#include <functional>
+#include <optional>
+#include <initializer_list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "BookJournal.h"
+#include "TextIndex.h"
+#include "OrderedIndex.h"
+#include "BookStore.h"
+#include "CatalogStatistics.h"
+#include "ResultSink.h"
+#include "BookCache.h"
+#include "LibraryMetrics.h"
+#include "Circulation.h"
 
 // ͼ
 class Book {
@@ -21,19 +38,22 @@ private:
     int quantity;              // 
 
 public:
-    // 캯
+    // 캯ֵƶԱֵʱƣ
     Book(std::string isbn, std::string title, std::string author,
         std::string publisher, std::string publishDate, double price, int quantity);
 
-    // ȡ
-    std::string getISBN() const;
-    std::string getTitle() const;
-    std::string getAuthor() const;
-    std::string getPublisher() const;
-    std::string getPublishDate() const;
+    // ȡԣãƣ
+    const std::string& getISBN() const;
+    const std::string& getTitle() const;
+    const std::string& getAuthor() const;
+    const std::string& getPublisher() const;
+    const std::string& getPublishDate() const;
     double getPrice() const;
     int getQuantity() const;
 
+    // ֶεã
+    BookRecord record() const;
+
     // 
     void setTitle(std::string title);
     void setAuthor(std::string author);
@@ -50,44 +70,259 @@ public:
 
     // ַļȡ
     static Book fromString(const std::string& str);
+
+    // һݣ쳣ʧʱͨ error ԭ򣻼۸Ϊ޵ķǸΪ
+    static bool tryParse(std::string_view line, Book& out, std::string& error);
+
+    // ͬϣֱֶ line еַ
+    static bool tryParse(std::string_view line, BookRecord& out, std::string& error);
+
+    // ޸ǰͳһУ飨湲ãISBN Ϸ۸Ϊ޵ķǸΪ
+    bool validate(std::string& error) const;
+
+    // ISBN Ϊ 10-13 λַֻ
+    static bool isValidISBN(std::string_view isbn);
+};
+
+// еһıʽ־¼ͬ
+//   A|<ͼ>      U|<ԭISBN>|<ͼ>      D|<ISBN>  ɾ
+struct BookOperation {
+    enum Type { Add, Update, Delete };
+
+    Type type = Add;
+    std::string isbn;    // /ɾĿISBNʱΪͼ鱾ISBN
+    Book book{ "", "", "", "", "", 0.0, 0 };  // /ºͼ
+
+    std::string toString() const;
+    static bool tryParse(std::string_view line, BookOperation& out, std::string& error);
+};
+
+// ֶμ޸ģֻĶֵֶΣౣԭ
+struct BookPatch {
+    std::optional<std::string> isbn;
+    std::optional<std::string> title;
+    std::optional<std::string> author;
+    std::optional<std::string> publisher;
+    std::optional<std::string> publishDate;
+    std::optional<double> price;
+    std::optional<int> quantity;
+
+    bool empty() const {
+        return !isbn && !title && !author && !publisher && !publishDate && !price && !quantity;
+    }
 };
 
 // ͼϵͳ
 class Library {
+    friend class QueryEngine;  // ѯֱӷʸ
+
+public:
+    using BookHandle = BookCache::Handle;   // ɱͼ
+
 private:
-    std::vector<Book> books;   // ͼ鼯
+    BookStore books;           // ͼ鼯ϣʽ洢Դ ISBN ұ
+    TextIndex textIndex;       // //絹
+    OrderedIndex<double> priceIndex;       // ۸
+    OrderedIndex<int> quantityIndex;       // 
+    OrderedIndex<int32_t> dateIndex;       // Ϊ yyyymmdd޷ʶڲ
+    CatalogStatistics stats;   // άͳƻ
+    mutable BookCache cache;   // ISBNѯȵͼ飬޸ĻɾʱʧЧ
+    mutable LibraryMetrics metrics;  // Ĵʱֲɨдֽ
     const std::string dataFile = "book.txt";  // ļ·
+    BookJournal journal{ dataFile + ".journal" };  // ־
+    Circulation circulation{ dataFile + ".loans" };  // ͨߡеĸ軹˱
+    size_t journalCompactThreshold = 1024;    // ־¼ﵽֵҲͼʱѹΪ
+    bool persistenceDeferred = false;  // Ƴٳ־û޸ֻڴ
+    bool unsavedChanges = false;       // δдջ־޸
+    std::ostream* messageStream = &std::cout;  // ״̬ʾλãΪʱ
+
+    // ̨дգ޸ֻ߳ȡô洢ĿգO(1) η붨еĸƣ־λã
+    // д̸߳ʽдʱļ滻 book.txt л־ͬһʱдһݣ
+    // дڼ޸ճд־һݿһϲ
+    struct SnapshotJob {
+        BookStore::Snapshot snapshot;
+        BookJournal::Mark journalMark;
+    };
+    std::mutex snapshotMutex;
+    std::condition_variable snapshotChanged;
+    std::optional<SnapshotJob> snapshotJob;   // ύδдĿ
+    bool snapshotFailed = false;   // һдʧܣδ
+    bool snapshotStopping = false;
+    std::thread snapshotWriter;    // һύʱ
+
+    // ״̬ʾ
+    std::ostream& messages() const;
+    // ʧԭд״̬ʾ false error ʹ
+    bool reportError(const std::string& error) const;
 
     // ͼ
-    int findBookIndex(const std::string& isbn) const;
+    int findBookIndex(std::string_view isbn) const;
 
-    // ͼ
+    // ͼݣ + ־طţ
     void loadBooks();
 
-    // ͼ
-    void saveBooks() const;
+    // ύһݿսд̣߳һδдʱύ false
+    bool startSnapshot();
+
+    // д̣߳д
+    void snapshotLoop();
+    bool writeSnapshot(const SnapshotJob& job);
+
+    // ȡ index Ϣ
+    Book bookAt(size_t index) const;
+
+    // ֶΣֻؽб仯Ĳ
+    enum IndexedFields : unsigned {
+        TitleField = 1, AuthorField = 2, PublisherField = 4,
+        PriceField = 8, QuantityField = 16, DateField = 32, AllFields = 63,
+        TextFields = TitleField | AuthorField | PublisherField
+    };
+
+    // ά
+    void indexBook(size_t index, unsigned fields = AllFields);
+    void unindexBook(size_t index, unsigned fields = AllFields);
+    void clearIndexes();
+
+    // ʱΪ first ֮ͼ彨׷Ӻһ
+    void buildOrderedIndexes(size_t first);
+
+    //  index ֶã
+    BookRecord recordAt(size_t index) const;
+
+    // ͨƥͼ鲢д sink
+    void searchText(TextIndex::Field field, std::string_view keyword, ResultSink& sink) const;
+
+    // ڴеɾģд־
+    void applyAdd(const Book& book);
+    void applyAdd(const BookRecord& book, unsigned indexedFields = AllFields);
+    void applyUpdate(size_t index, const Book& newBookInfo);
+    void applyDelete(size_t index);
+    void applyClear();
+
+    // ѹʵ洢ɾµĿλ²λд
+    void compactSlots();
+
+    // ڴִһУĲ
+    void applyOperation(const BookOperation& operation);
+
+    // طһ־¼
+    void applyJournalRecord(const std::string& record);
+
+    // д־޸ڴ֮ǰãʧʱʾɵ÷ԭһ¼̣طʱЧ
+    bool logMutation(const std::string& record);
+    bool logMutationGroup(const std::vector<std::string>& records);
+
+    // ־ʱں̨ѹΪ
+    void compactJournalIfNeeded();
 
 public:
-    // 캯
-    Library();
+    // 캯عе״̬ʾд messageStreamΪʱ
+    explicit Library(std::ostream* messageStream = &std::cout);
+
+    // ʱ־ϲգ֤˳ book.txt 
+    ~Library();
 
-    // ͼ
+    Library(const Library&) = delete;
+    Library& operator=(const Library&) = delete;
+
+    // ͼܣ error ʧʱֻͨ error ԭذԭд״̬ʾ
     bool addBook(const Book& book);
+    bool addBook(const Book& book, std::string& error);
     bool updateBook(const std::string& isbn, const Book& newBookInfo);
+    bool updateBook(const std::string& isbn, const Book& newBookInfo, std::string& error);
+    bool updateBook(const std::string& isbn, const BookPatch& patch);   // ֻ޸ patch иֶ
+    bool updateBook(const std::string& isbn, const BookPatch& patch, std::string& error);
     bool deleteBook(const std::string& isbn);
-    bool searchBookByISBN(const std::string& isbn) const;
-    void searchBookByTitle(const std::string& title) const;
-    void searchBookByAuthor(const std::string& author) const;
-    void displayAllBooks() const;
-    void clearAllBooks();
+    bool deleteBook(const std::string& isbn, std::string& error);
+
+    // ɾģУ飬ȫͨΪһ¼д־̣ڴִУ
+    // һУʧܻд־ʧʱκ޸
+    bool applyBatch(const std::vector<BookOperation>& operations);
+
+    // ѯд sink sink ʽҳƥ̲ڴ
+    bool searchBookByISBN(std::string_view isbn, ResultSink& sink) const;
+    void searchBookByTitle(std::string_view title, ResultSink& sink) const;
+    void searchBookByAuthor(std::string_view author, ResultSink& sink) const;
+    void searchBookByPublisher(std::string_view publisher, ResultSink& sink) const;
+    void displayAllBooks(ResultSink& sink) const;
+
+    // ģ֡©ַ֣֡ȫǡСдԿոţ
+    // ؼʿֶֻεһ֡ƶӽ limit ༭Сǰͬʱֶζǰ
+    void searchRanked(TextIndex::Field field, std::string_view keyword, ResultSink& sink, size_t limit = 20) const;
+
+    // ϵķΧѯ low..highˣڵͼ飬descending ʱ
+    //  sink ﵽ limit ʱֹͣ limit Ϊ top-k
+    void findBooksByPrice(double low, double high, ResultSink& sink, bool descending = false) const;
+    void findBooksByQuantity(int low, int high, ResultSink& sink, bool descending = false) const;
+    void findBooksByPublishDate(int32_t lowKey, int32_t highKey, ResultSink& sink, bool descending = false) const;
+
+    // ȫͼ飨ȷϣȷɽ渺𣩣нδͼʱܾ
+    bool clearAllBooks();
+    bool clearAllBooks(std::string& error);
     void generateStatistics() const;
 
+    // ͨ軹¼ֱ׷ӵ˱ book.txt.loansƳٳ־ûӰ죻ʧʱͨ error ԭ
+    // ȡСڼܸΪ죻黹 ISBN 븱
+    bool addPatron(uint32_t patron, std::string_view name, std::string& error);
+    bool borrowBook(std::string_view isbn, uint32_t patron, int32_t due, Circulation::LoanInfo& loan, std::string& error);
+    bool returnBook(std::string_view isbn, uint32_t copy, Circulation::LoanInfo& loan, std::string& error);
+
+    // ɽݲزȥ 0δҵͼʱ -1
+    int getAvailableCopies(std::string_view isbn) const;
+    const Circulation& getCirculation() const { return circulation; }
+
+    // ޸ĻɾýеĸʧȥӦͼ飨ɾ ISBNڽʱԭ򣬷򷵻ؿմ
+    std::string circulationConflict(const BookOperation& operation) const;
+
     // 
-    bool isISBNExists(const std::string& isbn) const;
+    bool isISBNExists(std::string_view isbn) const;
     int getTotalBooksCount() const;
     double getTotalValue() const;
+    double getPricePercentile(double q) const;   // q ȡ 0~1
+    const CatalogStatistics& getStatistics() const { return stats; }
+    size_t getMemoryUsage() const;
+
+    // ȫĽУͳƻ
+    bool verifyStatistics() const;
 
-    bool getBook(const std::string& isbn, Book& outBook) const;
+    // һͼϢ outBook
+    bool getBook(std::string_view isbn, Book& outBook) const;
+
+    // ISBNȡͼֶΣδҵʱؿգȵͼ LRU ṩ
+    BookHandle findBook(std::string_view isbn) const;
+
+    // ͼ黺ڴռãΪ 0 ʱرջ
+    BookCache::Metrics getCacheMetrics() const;
+    void setCacheCapacity(size_t capacity);
+
+    // ֻܼҲ¼ڲΪԭӲڶֻ̼߳乲
+    LibraryMetrics& getMetrics() const { return metrics; }
+
+    // ܼһ JSON Prometheus ıʽͼڴռ뻺ȵǰֵ
+    void writeMetrics(std::ostream& out, bool prometheus) const;
+
+    // дļдʱļ滻ȡдһ
+    bool writeMetricsFile(const std::string& path, bool prometheus) const;
+
+    // ȫͼ飨洢˳
+    void forEachBook(const std::function<void(const Book&)>& visit) const;
+
+    // ״̬ʾء桢ɾĽ nullptr رʾ
+    void setMessageStream(std::ostream* stream);
+
+    // ־ã̼ͬʱڽ˱
+    void setJournalSyncInterval(size_t interval);
+    void setJournalCompactThreshold(size_t threshold);
+
+    // Ƴٳ־ûɾĲд־ֻ޸ڴ棬ʺϽűִУ
+    // رʱ persist() ʱʱһд
+    bool setPersistenceDeferred(bool deferred);
+
+    // δ޸дգд󷵻
+    bool persist();
+
+    // ϣд־޸軹¼ọ̈̄ȴ̨дĿдꣻдʧʱ false
+    bool flush();
 };
 
 // û
@@ -98,6 +333,7 @@ private:
     // ˵ʾ
     void displayMainMenu() const;
     void displaySearchMenu() const;
+    void displayCirculationMenu() const;
 
     // ֤
     bool isValidISBN(const std::string& isbn) const;
@@ -121,10 +357,19 @@ private:
     void handleDisplayAllBooks();
     void handleClearAllBooks();
     void handleGenerateStatistics();
+    void handleCirculation();
 
 public:
+    // عе״̬ʾд messageStreamΪʱ
+    explicit LibraryUI(std::ostream* messageStream = &std::cout) : library(messageStream) {}
+
     // ϵͳ
     void run();
+
+    // ǽĽűģʽÿһʾ˵ʾ޸ڽʱһԱ棻
+    // ÿһ״̬ok / ok<TAB> / error<TAB>ԭ򣩣ѯ JSON 
+    // ȫɹ 0򷵻 1
+    int runScript(std::istream& in, std::ostream& out);
 };
 
 #endif // LIBRARY_MANAGEMENT_SYSTEM_H
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "LibraryMetrics.h"
+
+namespace {
+
+const char* const operationNames[] = {
+    "load", "save", "journal_append",
+    "lookup", "search_title", "search_author", "search_publisher", "search_fuzzy", "range_scan", "query", "list", "statistics",
+    "add", "update", "delete", "batch", "clear", "borrow", "return"
+};
+static_assert(sizeof(operationNames) / sizeof(operationNames[0]) == LibraryMetrics::OperationCount,
+    "ÿֲҪ");
+
+#if LIBRARY_METRICS
+// ķλ
+const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+// ֵͳһ %.9g ʽӰ
+std::string number(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+std::string& defaultTraceFile() {
+    static std::string path;
+    return path;
+}
+
+// е̺߳ţ״γֵ˳ţ std::thread::id ȶ
+uint32_t currentThread() {
+    static std::atomic<uint32_t> next{ 1 };
+    thread_local uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+#endif
+
+} // namespace
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t seen = maximum.load(std::memory_order_relaxed);
+    while (value > seen && !maximum.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::clear() {
+    for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t recorded = 0;
+    for (const auto& bucket : counts) recorded += bucket.load(std::memory_order_relaxed);
+    return recorded;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    // ȡڼв¼ǽֵ
+    uint64_t recorded = count();
+    if (recorded == 0) return 0;
+
+    q = q < 0.0 ? 0.0 : q > 1.0 ? 1.0 : q;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(recorded) + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        seen += counts[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) return std::min(bucketHigh(bucket), max());
+    }
+    return max();
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < subBuckets) return static_cast<size_t>(value);
+    unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;   // С subBucketBits
+    unsigned shift = exponent - subBucketBits;
+    return (static_cast<size_t>(shift + 1) << subBucketBits) | static_cast<size_t>((value >> shift) & (subBuckets - 1));
+}
+
+uint64_t LatencyHistogram::bucketLow(size_t bucket) {
+    if (bucket < subBuckets) return bucket;
+    unsigned shift = static_cast<unsigned>(bucket >> subBucketBits) - 1;
+    return (subBuckets | (bucket & (subBuckets - 1))) << shift;
+}
+
+uint64_t LatencyHistogram::bucketHigh(size_t bucket) {
+    if (bucket < subBuckets) return bucket;
+    unsigned shift = static_cast<unsigned>(bucket >> subBucketBits) - 1;
+    return bucketLow(bucket) + ((uint64_t(1) << shift) - 1);
+}
+
+const char* LibraryMetrics::operationName(Operation operation) {
+    return operation < OperationCount ? operationNames[operation] : "unknown";
+}
+
+#if LIBRARY_METRICS
+
+LibraryMetrics::LibraryMetrics() : traceFile(defaultTraceFile()) {
+    if (!traceFile.empty()) startTrace();
+}
+
+LibraryMetrics::~LibraryMetrics() {
+    if (traceFile.empty()) return;
+    std::ofstream out(traceFile, std::ios::binary | std::ios::trunc);
+    writeChromeTrace(out);
+    if (!out) std::cerr << "޷дļ " << traceFile << "" << std::endl;
+}
+
+void LibraryMetrics::traceToFile(std::string path) {
+    defaultTraceFile() = std::move(path);
+}
+
+void LibraryMetrics::finish(const Span& span, Clock::time_point end) {
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - span.start).count();
+    if (span.operation < OperationCount) {
+        OperationStats& stats = operations[span.operation];
+        stats.latency.record(elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0);
+        if (span.scanned != 0) stats.rowsScanned.fetch_add(span.scanned, std::memory_order_relaxed);
+        if (span.returned != 0) stats.rowsReturned.fetch_add(span.returned, std::memory_order_relaxed);
+    }
+    if (!isTracing()) return;
+
+    int64_t start = std::chrono::duration_cast<std::chrono::nanoseconds>(span.start - epoch).count();
+    uint32_t thread = currentThread();
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (traceEvents.size() >= maxTraceEvents) {
+        ++droppedEvents;
+        return;
+    }
+    traceEvents.push_back(TraceEvent{ span.name ? span.name : operationNames[span.operation], span.category,
+        start, elapsed, thread });
+}
+
+void LibraryMetrics::startTrace() {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceEvents.clear();
+    droppedEvents = 0;
+    tracing.store(true);
+}
+
+void LibraryMetrics::stopTrace() {
+    tracing.store(false);
+}
+
+void LibraryMetrics::reset() {
+    for (auto& stats : operations) {
+        stats.latency.clear();
+        stats.rowsScanned.store(0, std::memory_order_relaxed);
+        stats.rowsReturned.store(0, std::memory_order_relaxed);
+    }
+    bytesRead.store(0, std::memory_order_relaxed);
+    bytesWritten.store(0, std::memory_order_relaxed);
+}
+
+void LibraryMetrics::writeJson(std::ostream& out) const {
+    // ʱ΢ΪλûзĲ
+    std::string json = "{\"bytesRead\":" + std::to_string(bytesRead.load())
+        + ",\"bytesWritten\":" + std::to_string(bytesWritten.load()) + ",\"operations\":{";
+    bool first = true;
+    for (size_t i = 0; i < OperationCount; ++i) {
+        const OperationStats& stats = operations[i];
+        uint64_t count = stats.latency.count();
+        if (count == 0) continue;
+        json += first ? "\"" : ",\"";
+        first = false;
+        json += operationNames[i];
+        json += "\":{\"count\":" + std::to_string(count)
+            + ",\"totalUs\":" + number(stats.latency.totalValue() / 1e3)
+            + ",\"meanUs\":" + number(stats.latency.totalValue() / 1e3 / static_cast<double>(count))
+            + ",\"p50Us\":" + number(stats.latency.percentile(0.5) / 1e3)
+            + ",\"p90Us\":" + number(stats.latency.percentile(0.9) / 1e3)
+            + ",\"p99Us\":" + number(stats.latency.percentile(0.99) / 1e3)
+            + ",\"p999Us\":" + number(stats.latency.percentile(0.999) / 1e3)
+            + ",\"maxUs\":" + number(stats.latency.max() / 1e3)
+            + ",\"rowsScanned\":" + std::to_string(stats.rowsScanned.load())
+            + ",\"rowsReturned\":" + std::to_string(stats.rowsReturned.load()) + "}";
+    }
+    size_t events = 0, dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        events = traceEvents.size();
+        dropped = droppedEvents;
+    }
+    json += "},\"trace\":{\"enabled\":" + std::string(isTracing() ? "true" : "false")
+        + ",\"events\":" + std::to_string(events) + ",\"dropped\":" + std::to_string(dropped) + "}}\n";
+    out << json;
+}
+
+void LibraryMetrics::writePrometheus(std::ostream& out) const {
+    std::string text =
+        "# HELP library_operation_seconds Latency of library operations.\n"
+        "# TYPE library_operation_seconds summary\n";
+    for (size_t i = 0; i < OperationCount; ++i) {
+        const LatencyHistogram& latency = operations[i].latency;
+        std::string label = std::string("operation=\"") + operationNames[i] + "\"";
+        for (double q : quantiles) {
+            text += "library_operation_seconds{" + label + ",quantile=\"" + number(q) + "\"} "
+                + number(latency.percentile(q) / 1e9) + "\n";
+        }
+        text += "library_operation_seconds_sum{" + label + "} " + number(latency.totalValue() / 1e9) + "\n";
+        text += "library_operation_seconds_count{" + label + "} " + std::to_string(latency.count()) + "\n";
+    }
+
+    // ֻѯ
+    const Operation searches[] = { SearchTitle, SearchAuthor, SearchPublisher, SearchFuzzy, RangeScan, Query, List };
+    text += "# HELP library_rows_scanned_total Rows examined by searches and queries.\n"
+        "# TYPE library_rows_scanned_total counter\n";
+    for (Operation op : searches) {
+        text += std::string("library_rows_scanned_total{operation=\"") + operationNames[op] + "\"} "
+            + std::to_string(operations[op].rowsScanned.load()) + "\n";
+    }
+    text += "# HELP library_rows_returned_total Rows returned by searches and queries.\n"
+        "# TYPE library_rows_returned_total counter\n";
+    for (Operation op : searches) {
+        text += std::string("library_rows_returned_total{operation=\"") + operationNames[op] + "\"} "
+            + std::to_string(operations[op].rowsReturned.load()) + "\n";
+    }
+
+    text += "# HELP library_read_bytes_total Bytes read from the snapshot and journal.\n"
+        "# TYPE library_read_bytes_total counter\n"
+        "library_read_bytes_total " + std::to_string(bytesRead.load()) + "\n"
+        "# HELP library_written_bytes_total Bytes written to snapshots and the journal.\n"
+        "# TYPE library_written_bytes_total counter\n"
+        "library_written_bytes_total " + std::to_string(bytesWritten.load()) + "\n";
+    out << text;
+}
+
+void LibraryMetrics::writeChromeTrace(std::ostream& out) const {
+    // Trace Event ʽ¼ph Ϊ Xʱ΢Ϊλ
+    std::lock_guard<std::mutex> lock(traceMutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const TraceEvent& event : traceEvents) {
+        out << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+            << "\",\"ph\":\"X\",\"ts\":" << number(event.start / 1e3) << ",\"dur\":" << number(event.duration / 1e3)
+            << ",\"pid\":1,\"tid\":" << event.thread << "}";
+        first = false;
+    }
+    out << "\n],\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}\n";
+}
+
+#endif
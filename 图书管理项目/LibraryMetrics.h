@@ -0,0 +1,174 @@
+#ifndef LIBRARY_METRICS_H
+#define LIBRARY_METRICS_H
+#include <string>
+#include <vector>
+#include <ostream>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// ʱأ LIBRARY_METRICS=0 ʱʱȫΪղ
+#ifndef LIBRARY_METRICS
+#define LIBRARY_METRICS 1
+#endif
+
+// ӳٷֲHDR ĶͰ16 ÿֵһͰ֮ÿ 2 ȷΪ 16 Ͱ
+//  1/16¼ֻԭӼӣͰܺͣڶ̼߳乲
+class LatencyHistogram {
+public:
+    static constexpr unsigned subBucketBits = 4;
+    static constexpr size_t subBuckets = size_t(1) << subBucketBits;
+    static constexpr size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+private:
+    std::atomic<uint64_t> counts[bucketCount] = {};
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> maximum{ 0 };
+
+public:
+    void record(uint64_t value);
+    void clear();
+
+    uint64_t count() const;
+    uint64_t totalValue() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maximum.load(std::memory_order_relaxed); }
+
+    // q λq ȡ 0~1ͰϽ磨ֵûм¼ʱ 0
+    uint64_t percentile(double q) const;
+
+    // ֵڵͰͰȡֵΧ
+    static size_t bucketOf(uint64_t value);
+    static uint64_t bucketLow(size_t bucket);
+    static uint64_t bucketHigh(size_t bucket);
+};
+
+// ͼݵܼĴʱֲɨ/صдֽ
+// ɵΪһ JSONPrometheus ıʽʱ Chrome trace 䣨chrome://tracingPerfetto ɴ򿪣
+class LibraryMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Operation {
+        Load, Save, JournalAppend,
+        Lookup, SearchTitle, SearchAuthor, SearchPublisher, SearchFuzzy, RangeScan, Query, List, Statistics,
+        Add, Update, Delete, Batch, Clear, Borrow, Return,
+        OperationCount
+    };
+
+    static constexpr bool enabled = LIBRARY_METRICS != 0;
+
+    // Сд»ߣ JSON  Prometheus ǩ
+    static const char* operationName(Operation operation);
+
+    class Span;
+
+#if LIBRARY_METRICS
+private:
+    struct OperationStats {
+        LatencyHistogram latency;              // 
+        std::atomic<uint64_t> rowsScanned{ 0 };
+        std::atomic<uint64_t> rowsReturned{ 0 };
+    };
+
+    struct TraceEvent {
+        const char* name;
+        const char* category;
+        int64_t start;       //  epoch 
+        int64_t duration;
+        uint32_t thread;
+    };
+
+    static constexpr size_t maxTraceEvents = 1 << 20;   // ٻޣֻ
+
+    OperationStats operations[OperationCount];
+    std::atomic<uint64_t> bytesRead{ 0 };
+    std::atomic<uint64_t> bytesWritten{ 0 };
+
+    Clock::time_point epoch = Clock::now();
+    std::atomic<bool> tracing{ false };
+    mutable std::mutex traceMutex;
+    std::vector<TraceEvent> traceEvents;
+    size_t droppedEvents = 0;
+    std::string traceFile;     // ǿʱǰѸдļ
+
+    void finish(const Span& span, Clock::time_point end);
+
+public:
+    LibraryMetrics();
+    ~LibraryMetrics();
+
+    void addBytesRead(uint64_t bytes) { bytesRead.fetch_add(bytes, std::memory_order_relaxed); }
+    void addBytesWritten(uint64_t bytes) { bytesWritten.fetch_add(bytes, std::memory_order_relaxed); }
+
+    // ʼ¼٣մǰ䣩ֹͣ󻺳屣ʱд
+    void startTrace();
+    void stopTrace();
+    bool isTracing() const { return tracing.load(std::memory_order_relaxed); }
+
+    // ȫӰ٣
+    void reset();
+
+    void writeJson(std::ostream& out) const;
+    void writePrometheus(std::ostream& out) const;
+    void writeChromeTrace(std::ostream& out) const;
+
+    // ֮ʵӹ¼٣ʱд path --trace ʹã
+    static void traceToFile(std::string path);
+#else
+public:
+    void addBytesRead(uint64_t) {}
+    void addBytesWritten(uint64_t) {}
+    void startTrace() {}
+    void stopTrace() {}
+    bool isTracing() const { return false; }
+    void reset() {}
+    void writeJson(std::ostream&) const {}
+    void writePrometheus(std::ostream&) const {}
+    void writeChromeTrace(std::ostream&) const {}
+    static void traceToFile(std::string) {}
+#endif
+};
+
+// ʱ䣺ʱʼʱʱĺʱֲʱͬʱһ
+class LibraryMetrics::Span {
+#if LIBRARY_METRICS
+    friend class LibraryMetrics;
+
+    LibraryMetrics& metrics;
+    Operation operation;       // OperationCount ʾֻǸ
+    const char* name;          // Ϊʱȡ
+    const char* category;
+    Clock::time_point start;
+    uint64_t scanned = 0;
+    uint64_t returned = 0;
+
+public:
+    Span(LibraryMetrics& metrics, Operation operation)
+        : metrics(metrics), operation(operation), name(nullptr), category("library"), start(Clock::now()) {
+    }
+
+    // ͳơֻڸе䣨Σname Ϊַ
+    Span(LibraryMetrics& metrics, const char* name, const char* category)
+        : metrics(metrics), operation(OperationCount), name(name), category(category), start(Clock::now()) {
+    }
+
+    ~Span() { metrics.finish(*this, Clock::now()); }
+
+    // ɨ뷵ص
+    void rows(uint64_t scannedRows, uint64_t returnedRows) {
+        scanned += scannedRows;
+        returned += returnedRows;
+    }
+#else
+public:
+    Span(LibraryMetrics&, Operation) {}
+    Span(LibraryMetrics&, const char*, const char*) {}
+    void rows(uint64_t, uint64_t) {}
+#endif
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+};
+
+#endif // LIBRARY_METRICS_H
@@ -0,0 +1,441 @@
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "LibraryServer.h"
+#include "LibraryManagement.h"
+#include "CommandProtocol.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <charconv>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t listenKey = 0;
+constexpr uint64_t wakeKey = 1;
+constexpr size_t readChunk = 64 * 1024;
+constexpr size_t maxLineLength = 1 << 20;    // ޣʱϿ
+constexpr size_t maxPendingOutput = 4 << 20; // ѹӦֵʱͣȡ
+
+std::string systemError(const std::string& what) {
+    return what + "" + std::strerror(errno);
+}
+
+} // namespace
+
+LibraryServer::~LibraryServer() {
+    shutdown();
+}
+
+bool LibraryServer::listenOn(const std::string& address, std::string& error) {
+    auto failWith = [this, &error](const std::string& message) {
+        error = message;
+        if (listenFd != -1) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    };
+
+    if (address.compare(0, 5, "unix:") == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) return failWith("Ч׽· " + path);
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        // ɾϴ׽ļֻɾ׽֣ɾͨļ
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) ::unlink(path.c_str());
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) return failWith(systemError("޷׽"));
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            return failWith(systemError("޷ " + path));
+        }
+        unixPath = path;
+    }
+    else {
+        std::string host = "127.0.0.1";
+        std::string port = address;
+        size_t colon = address.rfind(':');
+        if (colon != std::string::npos) {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+        if (host == "localhost") host = "127.0.0.1";
+
+        unsigned number = 0;
+        auto result = std::from_chars(port.data(), port.data() + port.size(), number);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        if (result.ec != std::errc() || result.ptr != port.data() + port.size() || number == 0 || number > 65535 ||
+            ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            return failWith("Чļַ " + address);
+        }
+        addr.sin_port = htons(static_cast<uint16_t>(number));
+
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) return failWith(systemError("޷׽"));
+        int reuse = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            return failWith(systemError("޷ " + address));
+        }
+    }
+
+    if (::listen(listenFd, SOMAXCONN) != 0) return failWith(systemError("޷ " + address));
+    return true;
+}
+
+bool LibraryServer::start(const Options& serverOptions, std::string& error) {
+    if (listenFd != -1) {
+        error = "Ѿ";
+        return false;
+    }
+    options = serverOptions;
+    options.maxBatch = std::max<size_t>(1, options.maxBatch);
+    if (!listenOn(options.address, error)) return false;
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        error = systemError("޷¼ѭ");
+        shutdown();
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = listenKey;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = wakeKey;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    size_t count = options.workers != 0 ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back(&LibraryServer::workerLoop, this);
+    }
+    return true;
+}
+
+void LibraryServer::wake() {
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    (void)written;  // ѷʱдʧҲ޷¼ѭܻᱻ
+}
+
+void LibraryServer::stop() {
+    stopping.store(true);
+    if (wakeFd != -1) wake();
+}
+
+void LibraryServer::run() {
+    using Clock = std::chrono::steady_clock;
+    bool exporting = !options.metricsFile.empty();
+    auto interval = std::chrono::seconds(std::max<size_t>(1, options.metricsInterval));
+    Clock::time_point nextExport = Clock::now() + interval;
+
+    std::vector<epoll_event> events(256);
+    while (!stopping.load()) {
+        // ָļʱȴ´дʱ
+        int timeout = -1;
+        if (exporting) {
+            Clock::time_point now = Clock::now();
+            if (now >= nextExport) {
+                exportMetrics();
+                nextExport = now + interval;
+            }
+            timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(nextExport - now).count());
+        }
+        int count = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeout);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == listenKey) {
+                acceptConnections();
+                continue;
+            }
+            if (id == wakeKey) {
+                uint64_t value;
+                ssize_t received = ::read(wakeFd, &value, sizeof(value));
+                (void)received;
+                drainCompletions();
+                continue;
+            }
+
+            auto it = connections.find(id);
+            if (it == connections.end()) continue;  // ѹر
+            Connection& connection = *it->second;
+            uint32_t ready = events[i].events;
+            // ԶȫرջӦ޴дֱӹر
+            if ((ready & (EPOLLERR | EPOLLHUP)) ||
+                ((ready & EPOLLOUT) && !writeTo(connection)) ||
+                ((ready & EPOLLIN) && !readFrom(connection))) {
+                closeConnection(id);
+                continue;
+            }
+            dispatch(id, connection);
+            updateConnection(id, connection);
+        }
+    }
+    shutdown();
+    if (exporting) exportMetrics();  // ӵζִУдռ
+}
+
+void LibraryServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return;  // EAGAINļľȴ󣺵´οɶʱ
+        }
+        if (unixPath.empty()) {
+            // ˮϵСӦȴϲ
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        uint64_t id = nextConnectionId++;
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->events = EPOLLIN;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        connections.emplace(id, std::move(connection));
+    }
+}
+
+bool LibraryServer::readFrom(Connection& connection) {
+    char buffer[readChunk];
+    ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (received < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    if (received == 0) {
+        // Զ˲ٷͣһûлзʱҲΪһ
+        connection.readClosed = true;
+        if (!connection.input.empty() && connection.input.back() == '\r') connection.input.pop_back();
+        if (!connection.input.empty() && connection.input[0] != '#') {
+            connection.requests.push_back(std::move(connection.input));
+        }
+        connection.input.clear();
+        return true;
+    }
+
+    // з֣עͺ
+    connection.input.append(buffer, static_cast<size_t>(received));
+    size_t start = 0, end;
+    while ((end = connection.input.find('\n', start)) != std::string::npos) {
+        size_t length = end - start;
+        if (length > 0 && connection.input[end - 1] == '\r') --length;
+        if (length > 0 && connection.input[start] != '#') {
+            connection.requests.emplace_back(connection.input, start, length);
+        }
+        start = end + 1;
+    }
+    connection.input.erase(0, start);
+    return connection.input.size() <= maxLineLength;
+}
+
+bool LibraryServer::writeTo(Connection& connection) {
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+            connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        connection.outputOffset += static_cast<size_t>(sent);
+    }
+    if (connection.outputOffset == connection.output.size()) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+    }
+    else if (connection.outputOffset >= readChunk && connection.outputOffset * 2 >= connection.output.size()) {
+        // дĲֹʱ⻺ֻ
+        connection.output.erase(0, connection.outputOffset);
+        connection.outputOffset = 0;
+    }
+    return true;
+}
+
+void LibraryServer::dispatch(uint64_t id, Connection& connection) {
+    // ÿͬʱֻһִУ֤Ӧ˳˳һ
+    if (connection.busy || connection.requests.empty()) return;
+    Task task{ id, {} };
+    size_t count = std::min(options.maxBatch, connection.requests.size());
+    task.lines.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        task.lines.push_back(std::move(connection.requests.front()));
+        connection.requests.pop_front();
+    }
+    connection.busy = true;
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
+}
+
+void LibraryServer::drainCompletions() {
+    std::vector<Completion> finished;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        finished.swap(completions);
+    }
+    for (Completion& completion : finished) {
+        auto it = connections.find(completion.connection);
+        if (it == connections.end()) continue;  // ִڼѶϿ
+        Connection& connection = *it->second;
+        connection.busy = false;
+        if (connection.output.empty()) connection.output = std::move(completion.response);
+        else connection.output += completion.response;
+
+        // ֱддٵȴд¼
+        if (!writeTo(connection)) {
+            closeConnection(completion.connection);
+            continue;
+        }
+        dispatch(completion.connection, connection);
+        updateConnection(completion.connection, connection);
+    }
+}
+
+bool LibraryServer::updateConnection(uint64_t id, Connection& connection) {
+    bool pendingOutput = connection.outputOffset < connection.output.size();
+    if (connection.readClosed && !connection.busy && connection.requests.empty() && !pendingOutput) {
+        closeConnection(id);
+        return false;
+    }
+
+    // ӦѹʱͣȡɶԶ˵ķͻеѹ
+    uint32_t events = 0;
+    if (!connection.readClosed && connection.requests.size() < options.maxBatch * 4 &&
+        connection.output.size() < maxPendingOutput) {
+        events |= EPOLLIN;
+    }
+    if (pendingOutput) events |= EPOLLOUT;
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+    return true;
+}
+
+void LibraryServer::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    ::close(it->second->fd);
+    connections.erase(it);
+}
+
+void LibraryServer::shutdown() {
+    // ̣ͣ߳ӵִϣٹر
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        workersStopping = true;
+    }
+    taskReady.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+
+    while (!connections.empty()) closeConnection(connections.begin()->first);
+    if (listenFd != -1) ::close(listenFd);
+    if (epollFd != -1) ::close(epollFd);
+    if (wakeFd != -1) ::close(wakeFd);
+    listenFd = epollFd = wakeFd = -1;
+    if (!unixPath.empty()) ::unlink(unixPath.c_str());
+    unixPath.clear();
+}
+
+#else
+
+// ¼ѭ epollƽ̨ݲ֧
+LibraryServer::~LibraryServer() {
+}
+
+bool LibraryServer::start(const Options&, std::string& error) {
+    error = "ǰƽֲ̨֧ѯ";
+    return false;
+}
+
+void LibraryServer::run() {
+}
+
+void LibraryServer::wake() {
+}
+
+void LibraryServer::stop() {
+    stopping.store(true);
+}
+
+#endif
+
+void LibraryServer::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            taskReady.wait(lock, [this] { return workersStopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        std::string response = executeBatch(task.lines);
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back(Completion{ task.connection, std::move(response) });
+        }
+        wake();
+    }
+}
+
+std::string LibraryServer::executeBatch(const std::vector<std::string>& lines) {
+    LibraryMetrics::Span span(library.getMetrics(), "server.batch", "server");
+    std::ostringstream out;
+    size_t i = 0;
+    while (i < lines.size()) {
+        // ֻһζִУ޸һдִ
+        CommandProtocol::Access access = CommandProtocol::access(lines[i]);
+        size_t end = i + 1;
+        while (end < lines.size() && CommandProtocol::access(lines[end]) == access) ++end;
+        if (access == CommandProtocol::Read) {
+            std::shared_lock<std::shared_mutex> lock(libraryMutex);
+            for (; i < end; ++i) CommandProtocol::executeRead(library, lines[i], out);
+        }
+        else {
+            std::unique_lock<std::shared_mutex> lock(libraryMutex);
+            for (; i < end; ++i) CommandProtocol::execute(library, lines[i], out);
+        }
+    }
+    return out.str();
+}
+
+void LibraryServer::exportMetrics() {
+    // ֻȴе޸
+    std::shared_lock<std::shared_mutex> lock(libraryMutex);
+    if (!library.writeMetricsFile(options.metricsFile, true)) {
+        std::cerr << "棺޷дָļ " << options.metricsFile << "" << std::endl;
+    }
+}
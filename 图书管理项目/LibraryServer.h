@@ -0,0 +1,113 @@
+#ifndef LIBRARY_SERVER_H
+#define LIBRARY_SERVER_H
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+class Library;
+
+// زѯ񣺼 Unix ׽ֻ򱾻 TCP ˿ڣнЭ CommandProtocol
+// һ¼ѭ̣߳epollշִ̳߳У
+//   - ͬһϿˮ߷Ͷ󣬰˳һ̣߳Ӧϲһдأ
+//   - ͬӵβִУֻɾĶռд
+//   - ָļʱ¼ѭܼдļ Prometheus ļɼȡ
+// Ŀǰֻ֧ Linuxƽ̨ start() ʧ
+class LibraryServer {
+public:
+    struct Options {
+        std::string address;      // "unix:<·>"  "[:]˿"ȱʡΪ 127.0.0.1
+        size_t workers = 0;       // ߳0 ʾ CPU 
+        size_t maxBatch = 256;    // һν̵߳
+        std::string metricsFile;  // д Prometheus ıʽܼΪʱд
+        size_t metricsInterval = 10;  // д룩
+    };
+
+private:
+    // ̵߳һ
+    struct Task {
+        uint64_t connection;
+        std::vector<std::string> lines;
+    };
+
+    // һӦ
+    struct Completion {
+        uint64_t connection;
+        std::string response;
+    };
+
+    struct Connection {
+        int fd = -1;
+        std::string input;                 // δճе
+        std::deque<std::string> requests;  // յδִе
+        std::string output;                // δдӦ
+        size_t outputOffset = 0;
+        uint32_t events = 0;               // ǰ epoll йע¼
+        bool busy = false;                 // һڹִ߳
+        bool readClosed = false;           // Զѹرд򣬷Ӧر
+    };
+
+    Library& library;
+    std::shared_mutex libraryMutex;
+
+    Options options;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;                       // eventfd߳һֹͣʱ¼ѭ
+    std::string unixPath;                  //  Unix ׽ʱ·˳ʱɾ
+    std::atomic<bool> stopping{ false };
+
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;
+    uint64_t nextConnectionId = 2;         // 01 ׽ֺ eventfd
+
+    std::vector<std::thread> workers;
+    std::mutex taskMutex;
+    std::condition_variable taskReady;
+    std::deque<Task> tasks;
+    bool workersStopping = false;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    bool listenOn(const std::string& address, std::string& error);
+    void wake();
+    void workerLoop();
+    std::string executeBatch(const std::vector<std::string>& lines);
+    void exportMetrics();
+
+    void acceptConnections();
+    // շݣӳʱ false
+    bool readFrom(Connection& connection);
+    bool writeTo(Connection& connection);
+    void dispatch(uint64_t id, Connection& connection);
+    void drainCompletions();
+    // ״̬¹ע¼ѽʱرղ false
+    bool updateConnection(uint64_t id, Connection& connection);
+    void closeConnection(uint64_t id);
+    void shutdown();
+
+public:
+    explicit LibraryServer(Library& library) : library(library) {}
+    ~LibraryServer();
+
+    LibraryServer(const LibraryServer&) = delete;
+    LibraryServer& operator=(const LibraryServer&) = delete;
+
+    // ߳
+    bool start(const Options& options, std::string& error);
+
+    // ڵǰ߳¼ѭֱ stop() 
+    void run();
+
+    // ֹͣźŴе
+    void stop();
+};
+
+#endif // LIBRARY_SERVER_H
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// ֻڴӳļ
+class MappedFile {
+private:
+    const char* begin = nullptr;   // ӳʼַ
+    size_t length = 0;             // ļ
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    void close();
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 򿪲ӳļļڻ޷ӳʱ false
+    bool open(const std::string& path);
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(begin, length); }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,48 @@
+#include "OrderedIndex.h"
+
+int32_t publishDateKey(std::string_view date) {
+    // ȡַ֣- / .    ոȣΪָ
+    int parts[3] = { 0, 0, 0 };
+    size_t digits[3] = { 0, 0, 0 };
+    size_t count = 0;
+    for (size_t i = 0; i < date.size();) {
+        if (date[i] < '0' || date[i] > '9') {
+            ++i;
+            continue;
+        }
+        if (count == 3) return -1;
+        while (i < date.size() && date[i] >= '0' && date[i] <= '9') {
+            if (digits[count] == 8) return -1;
+            parts[count] = parts[count] * 10 + (date[i] - '0');
+            ++digits[count];
+            ++i;
+        }
+        ++count;
+    }
+    if (count == 0) return -1;
+
+    int year = parts[0], month = parts[1], day = parts[2];
+    if (count == 1 && digits[0] == 8) {         // 20120805
+        year = parts[0] / 10000;
+        month = parts[0] / 100 % 100;
+        day = parts[0] % 100;
+    }
+    else if (count == 1 && digits[0] == 6) {    // 201208
+        year = parts[0] / 100;
+        month = parts[0] % 100;
+    }
+    else if (digits[0] < 3 || digits[0] > 4) {
+        return -1;
+    }
+
+    if (year <= 0 || month > 12 || day > 31 || (month == 0 && day != 0)) return -1;
+    return year * 10000 + month * 100 + day;
+}
+
+int32_t publishDateUpperKey(std::string_view date) {
+    int32_t key = publishDateKey(date);
+    if (key < 0) return key;
+    if (key / 100 % 100 == 0) return key + 1299;
+    if (key % 100 == 0) return key + 99;
+    return key;
+}
@@ -0,0 +1,164 @@
+#ifndef ORDERED_INDEX_H
+#define ORDERED_INDEX_H
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <cstdint>
+
+//  (, ͼ±) ַ֧Χѯ/
+// 飻¼ȷСɾеļ¼ȼΪĹ
+// ﵽ 1/8 ʱϲһΣ޸ĵľ̯Ϊƶ O(log n)
+template <typename Key>
+class OrderedIndex {
+public:
+    struct Entry {
+        Key key;
+        uint32_t slot;
+
+        bool operator<(const Entry& other) const {
+            return key < other.key || (!(other.key < key) && slot < other.slot);
+        }
+        bool operator==(const Entry& other) const {
+            return !(*this < other) && !(other < *this);
+        }
+    };
+
+private:
+    std::vector<Entry> base;    // Ѻϲ
+    std::set<Entry> inserted;   // δϲ¼
+    std::set<Entry> erased;     // ɾδϲļ¼
+
+    void mergeIfNeeded() {
+        size_t limit = std::max<size_t>(1024, base.size() / 8);
+        if (inserted.size() + erased.size() > limit) merge();
+    }
+
+    // 鲢Ĺ before ˳ϲ
+    template <typename BaseIt, typename SetIt, typename Compare, typename Visit>
+    static void mergeScan(BaseIt b, BaseIt bEnd, SetIt d, SetIt dEnd, SetIt e, SetIt eEnd,
+        Compare before, Visit& visit) {
+        while (b != bEnd || d != dEnd) {
+            if (b != bEnd) {
+                while (e != eEnd && before(*e, *b)) ++e;
+                if (e != eEnd && *e == *b) {
+                    ++b;
+                    continue;
+                }
+            }
+            const Entry& next = (d == dEnd || (b != bEnd && before(*b, *d))) ? *b++ : *d++;
+            if (!visit(next.key, next.slot)) return;
+        }
+    }
+
+public:
+    void add(Key key, uint32_t slot) {
+        Entry entry{ key, slot };
+        auto it = erased.find(entry);
+        if (it != erased.end()) erased.erase(it);  // ָеͬһ¼
+        else inserted.insert(entry);
+        mergeIfNeeded();
+    }
+
+    void remove(Key key, uint32_t slot) {
+        Entry entry{ key, slot };
+        if (inserted.erase(entry) == 0 && std::binary_search(base.begin(), base.end(), entry)) {
+            erased.insert(entry);
+        }
+        mergeIfNeeded();
+    }
+
+    // װ룺׷ӵĩβȫ׷Ӻ finishBulkLoad() һΣ
+    // ֮䲻ܲѯʺϼʱʹãÿ¼һڵ
+    void bulkAdd(Key key, uint32_t slot) {
+        base.push_back(Entry{ key, slot });
+    }
+
+    void finishBulkLoad() {
+        std::sort(base.begin(), base.end());
+    }
+
+    // Ĺ
+    void merge() {
+        if (inserted.empty() && erased.empty()) return;
+        std::vector<Entry> merged;
+        merged.reserve(base.size() + inserted.size() - erased.size());
+        auto append = [&merged](Key key, uint32_t slot) {
+            merged.push_back(Entry{ key, slot });
+            return true;
+        };
+        mergeScan(base.cbegin(), base.cend(), inserted.cbegin(), inserted.cend(),
+            erased.cbegin(), erased.cend(), std::less<Entry>(), append);
+        base.swap(merged);
+        inserted.clear();
+        erased.clear();
+    }
+
+    // 洢ѹʵλӳд±꣨ӳ䵥ͬ˳򲻱䣬Ȼ
+    void remap(const std::vector<uint32_t>& newSlots) {
+        merge();
+        for (Entry& entry : base) {
+            entry.slot = newSlots[entry.slot];
+        }
+    }
+
+    void clear() {
+        std::vector<Entry>().swap(base);
+        inserted.clear();
+        erased.clear();
+    }
+
+    size_t size() const { return base.size() + inserted.size() - erased.size(); }
+
+    size_t memoryUsage() const {
+        // ڵ㰴ݱ 32 ָֽɫλ
+        return base.capacity() * sizeof(Entry) + (inserted.size() + erased.size()) * (sizeof(Entry) + 32);
+    }
+
+    // low <= key <= high ļ¼ѯ滮ѡԣ
+    size_t count(Key low, Key high) const {
+        if (high < low) return 0;
+        Entry first{ low, 0 };
+        Entry last{ high, std::numeric_limits<uint32_t>::max() };
+        auto bBegin = std::lower_bound(base.begin(), base.end(), first);
+        size_t total = static_cast<size_t>(std::upper_bound(bBegin, base.end(), last) - bBegin);
+        total += static_cast<size_t>(std::distance(inserted.lower_bound(first), inserted.upper_bound(last)));
+        total -= static_cast<size_t>(std::distance(erased.lower_bound(first), erased.upper_bound(last)));
+        return total;
+    }
+
+    // ˳ low <= key <= high ļ¼visit(key, slot)  false ʱֹͣ
+    template <typename Visit>
+    void scan(Key low, Key high, Visit visit, bool descending = false) const {
+        if (high < low) return;
+        Entry first{ low, 0 };
+        Entry last{ high, std::numeric_limits<uint32_t>::max() };
+        auto bBegin = std::lower_bound(base.begin(), base.end(), first);
+        auto bEnd = std::upper_bound(bBegin, base.end(), last);
+        auto dBegin = inserted.lower_bound(first);
+        auto dEnd = inserted.upper_bound(last);
+        auto eBegin = erased.lower_bound(first);
+        auto eEnd = erased.upper_bound(last);
+        if (!descending) {
+            mergeScan(bBegin, bEnd, dBegin, dEnd, eBegin, eEnd, std::less<Entry>(), visit);
+        }
+        else {
+            using BaseRev = std::reverse_iterator<typename std::vector<Entry>::const_iterator>;
+            using SetRev = std::reverse_iterator<typename std::set<Entry>::const_iterator>;
+            mergeScan(BaseRev(bEnd), BaseRev(bBegin), SetRev(dEnd), SetRev(dBegin), SetRev(eEnd), SetRev(eBegin),
+                [](const Entry& a, const Entry& b) { return b < a; }, visit);
+        }
+    }
+};
+
+// ڵĿ yyyymmddֻʱȱٵĲּΪ 0ڸ/֪֮ǰ
+// ʶ 1791-01-012012-82012/8/52012.08201285ա201208052012 д޷ʶʱ -1
+int32_t publishDateKey(std::string_view date);
+
+// ΪϽʹõڼȱٵ¡ȡֵʹ "2000"  2000 ȫ
+int32_t publishDateUpperKey(std::string_view date);
+
+#endif // ORDERED_INDEX_H
@@ -0,0 +1,38 @@
+#ifndef POOLED_OBJECT_H
+#define POOLED_OBJECT_H
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+// ͷŵĶ󣺶ڲȫ䶼ͬһڴأ
+// ûʱֱͷأеԪء
+// ֻֻڴͷŵͣpmr ԪҲʹͬһأT  memory_resource* 
+template <typename T>
+class PooledObject {
+private:
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool;
+    T* object = nullptr;
+
+public:
+    PooledObject() { reset(); }
+
+    PooledObject(PooledObject&&) noexcept = default;
+    PooledObject& operator=(PooledObject&&) noexcept = default;
+
+    // һն󣬾ɶͬһͷ
+    void reset() {
+        auto fresh = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+        void* storage = fresh->allocate(sizeof(T), alignof(T));
+        T* created = new (storage) T(fresh.get());
+        pool = std::move(fresh);
+        object = created;
+    }
+
+    T& operator*() { return *object; }
+    const T& operator*() const { return *object; }
+    T* operator->() { return object; }
+    const T* operator->() const { return object; }
+};
+
+#endif // POOLED_OBJECT_H
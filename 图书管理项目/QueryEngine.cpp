@@ -0,0 +1,547 @@
+#include <cmath>
+#include <limits>
+#include <charconv>
+#include <algorithm>
+#include <sstream>
+#include "QueryEngine.h"
+#include "LibraryManagement.h"
+
+namespace {
+    struct Token {
+        enum Type { Word, String, Operator, LeftParen, RightParen, End } type = End;
+        std::string text;
+        size_t position = 0;
+    };
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isOperatorChar(char c) {
+        return c == '<' || c == '>' || c == '=' || c == '!';
+    }
+
+    bool tokenize(std::string_view text, std::vector<Token>& tokens, std::string& error) {
+        size_t i = 0;
+        while (true) {
+            while (i < text.size() && isSpace(text[i])) ++i;
+            Token token;
+            token.position = i + 1;
+            if (i == text.size()) {
+                tokens.push_back(token);
+                return true;
+            }
+
+            char c = text[i];
+            if (c == '(' || c == ')') {
+                token.type = c == '(' ? Token::LeftParen : Token::RightParen;
+                token.text = c;
+                ++i;
+            }
+            else if (isOperatorChar(c)) {
+                token.type = Token::Operator;
+                while (i < text.size() && isOperatorChar(text[i]) && token.text.size() < 2) token.text += text[i++];
+            }
+            else if (c == '"') {
+                token.type = Token::String;
+                ++i;
+                while (i < text.size() && text[i] != '"') {
+                    if (text[i] == '\\' && i + 1 < text.size()) ++i;
+                    token.text += text[i++];
+                }
+                if (i == text.size()) {
+                    error = " " + std::to_string(token.position) + " ַûбպ";
+                    return false;
+                }
+                ++i;
+            }
+            else {
+                token.type = Token::Word;
+                while (i < text.size() && !isSpace(text[i]) && text[i] != '(' && text[i] != ')'
+                    && text[i] != '"' && !isOperatorChar(text[i])) {
+                    token.text += text[i++];
+                }
+            }
+            tokens.push_back(std::move(token));
+        }
+    }
+
+    std::string lower(std::string text) {
+        for (char& c : text) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+        return text;
+    }
+
+    bool parseField(const std::string& word, Query::Field& field) {
+        static const struct { const char* name; const char* alias; Query::Field field; } names[] = {
+            { "isbn", "ISBN", Query::ISBN }, { "title", "", Query::Title },
+            { "author", "", Query::Author }, { "publisher", "", Query::Publisher },
+            { "date", "", Query::PublishDate }, { "price", "۸", Query::Price },
+            { "quantity", "", Query::Quantity },
+        };
+        std::string key = lower(word);
+        for (const auto& entry : names) {
+            if (key == entry.name || word == entry.alias) {
+                field = entry.field;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseOp(const Token& token, Query::Op& op) {
+        static const struct { const char* text; Query::Op op; } ops[] = {
+            { "=", Query::Equal }, { "==", Query::Equal }, { "!=", Query::NotEqual },
+            { "<", Query::Less }, { "<=", Query::LessEqual }, { ">", Query::Greater }, { ">=", Query::GreaterEqual },
+        };
+        if (token.type == Token::Word) {
+            if (lower(token.text) == "contains" || token.text == "") {
+                op = Query::Contains;
+                return true;
+            }
+            return false;
+        }
+        if (token.type != Token::Operator) return false;
+        for (const auto& entry : ops) {
+            if (token.text == entry.text) {
+                op = entry.op;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* opName(Query::Op op) {
+        static const char* names[] = { "contains", "=", "!=", "<", "<=", ">", ">=" };
+        return names[op];
+    }
+
+    // ݹ½or := and (OR and)*   and := unary (AND unary)*   unary := NOT unary | ( or ) | Ƚ
+    class Parser {
+    private:
+        std::vector<Token> tokens;
+        size_t pos = 0;
+        std::string& error;
+
+        const Token& peek() const { return tokens[pos]; }
+
+        bool isKeyword(const char* keyword) const {
+            return peek().type == Token::Word && lower(peek().text) == keyword;
+        }
+
+        bool fail(const std::string& message) {
+            if (error.empty()) error = " " + std::to_string(peek().position) + " ַ" + message;
+            return false;
+        }
+
+        using NodePtr = std::unique_ptr<Query::Node>;
+
+        NodePtr combine(Query::Node::Kind kind, NodePtr left, NodePtr right) {
+            if (left->kind != kind) {
+                NodePtr node = std::make_unique<Query::Node>();
+                node->kind = kind;
+                node->children.push_back(std::move(left));
+                left = std::move(node);
+            }
+            left->children.push_back(std::move(right));
+            return left;
+        }
+
+        NodePtr parseOr() {
+            NodePtr node = parseAnd();
+            while (node && isKeyword("or")) {
+                ++pos;
+                NodePtr right = parseAnd();
+                if (!right) return nullptr;
+                node = combine(Query::Node::Or, std::move(node), std::move(right));
+            }
+            return node;
+        }
+
+        NodePtr parseAnd() {
+            NodePtr node = parseUnary();
+            while (node && isKeyword("and")) {
+                ++pos;
+                NodePtr right = parseUnary();
+                if (!right) return nullptr;
+                node = combine(Query::Node::And, std::move(node), std::move(right));
+            }
+            return node;
+        }
+
+        NodePtr parseUnary() {
+            if (isKeyword("not")) {
+                ++pos;
+                NodePtr child = parseUnary();
+                if (!child) return nullptr;
+                NodePtr node = std::make_unique<Query::Node>();
+                node->kind = Query::Node::Not;
+                node->children.push_back(std::move(child));
+                return node;
+            }
+            if (peek().type == Token::LeftParen) {
+                ++pos;
+                NodePtr node = parseOr();
+                if (!node) return nullptr;
+                if (peek().type != Token::RightParen) {
+                    fail("ȱ");
+                    return nullptr;
+                }
+                ++pos;
+                return node;
+            }
+            return parseCompare();
+        }
+
+        NodePtr parseCompare() {
+            NodePtr node = std::make_unique<Query::Node>();
+            if (peek().type != Token::Word || !parseField(peek().text, node->field)) {
+                fail(peek().type == Token::End ? "ȱٲѯ" : "޷ʶֶ \"" + peek().text + "\"");
+                return nullptr;
+            }
+            ++pos;
+            if (!parseOp(peek(), node->op)) {
+                fail("ȱٱȽ");
+                return nullptr;
+            }
+            ++pos;
+            if (peek().type != Token::Word && peek().type != Token::String) {
+                fail("ȱٱȽֵ");
+                return nullptr;
+            }
+            node->value = peek().text;
+            if (!resolveRange(*node)) return nullptr;
+            ++pos;
+            return node;
+        }
+
+        // ֵֶΰѱȽϻΪ䣬滮ֵͬһ
+        bool resolveRange(Query::Node& node) {
+            const double infinity = std::numeric_limits<double>::infinity();
+            if (!Query::isNumeric(node.field)) {
+                if (node.op != Query::Contains && node.op != Query::Equal && node.op != Query::NotEqual) {
+                    return fail("ֶ " + std::string(Query::fieldName(node.field)) + " ֻ֧ contains=  !=");
+                }
+                return true;
+            }
+            if (node.op == Query::Contains) {
+                if (node.field == Query::PublishDate) return true;  // ڰԭıƥ
+                return fail("ֶ " + std::string(Query::fieldName(node.field)) + " ֧ contains");
+            }
+
+            double lowValue = 0.0, highValue = 0.0;
+            if (node.field == Query::PublishDate) {
+                int32_t key = publishDateKey(node.value);
+                if (key < 0) return fail("޷ʶ \"" + node.value + "\"");
+                lowValue = key;
+                highValue = publishDateUpperKey(node.value);
+            }
+            else {
+                const std::string& v = node.value;
+                auto result = std::from_chars(v.data(), v.data() + v.size(), lowValue);
+                if (result.ec != std::errc() || result.ptr != v.data() + v.size() || !std::isfinite(lowValue)) {
+                    return fail("Чֵ \"" + v + "\"");
+                }
+                highValue = lowValue;
+            }
+
+            // ڼΪϸ񲻵ȺŻΪ۸ȡڵĸ
+            bool integral = node.field != Query::Price;
+            auto below = [integral](double v) { return integral ? std::ceil(v) - 1 : std::nextafter(v, -HUGE_VAL); };
+            auto above = [integral](double v) { return integral ? std::floor(v) + 1 : std::nextafter(v, HUGE_VAL); };
+            switch (node.op) {
+            case Query::Equal:
+            case Query::NotEqual:
+                node.low = lowValue;
+                node.high = highValue;
+                break;
+            case Query::Less:
+                node.low = -infinity;
+                node.high = below(lowValue);
+                break;
+            case Query::LessEqual:
+                node.low = -infinity;
+                node.high = integral ? std::floor(highValue) : highValue;
+                break;
+            case Query::Greater:
+                node.low = above(highValue);
+                node.high = infinity;
+                break;
+            case Query::GreaterEqual:
+                node.low = integral ? std::ceil(lowValue) : lowValue;
+                node.high = infinity;
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
+
+    public:
+        Parser(std::vector<Token> tokens, std::string& error) : tokens(std::move(tokens)), error(error) {}
+
+        NodePtr parse() {
+            NodePtr node = parseOr();
+            if (node && peek().type != Token::End) {
+                fail("ж \"" + peek().text + "\"");
+                return nullptr;
+            }
+            return node;
+        }
+    };
+
+    std::string_view fieldText(const BookRecord& record, Query::Field field) {
+        switch (field) {
+        case Query::ISBN: return record.isbn;
+        case Query::Title: return record.title;
+        case Query::Author: return record.author;
+        case Query::Publisher: return record.publisher;
+        default: return record.publishDate;
+        }
+    }
+
+    std::string formatNumber(double value) {
+        if (std::isinf(value)) return value < 0 ? "-inf" : "inf";
+        if (value == std::floor(value) && std::fabs(value) < 1e15) {
+            return std::to_string(static_cast<long long>(value));
+        }
+        std::ostringstream out;
+        out.precision(15);
+        out << value;
+        return out.str();
+    }
+}
+
+const char* Query::fieldName(Field field) {
+    static const char* names[] = { "isbn", "title", "author", "publisher", "date", "price", "quantity" };
+    return names[field];
+}
+
+bool Query::parse(std::string_view text, Query& out, std::string& error) {
+    error.clear();
+    std::vector<Token> tokens;
+    if (!tokenize(text, tokens, error)) return false;
+    std::unique_ptr<Node> root = Parser(std::move(tokens), error).parse();
+    if (!root) return false;
+    out.root = std::move(root);
+    return true;
+}
+
+bool Query::Node::matches(const BookRecord& record) const {
+    switch (kind) {
+    case And:
+        for (const auto& child : children) {
+            if (!child->matches(record)) return false;
+        }
+        return true;
+    case Or:
+        for (const auto& child : children) {
+            if (child->matches(record)) return true;
+        }
+        return false;
+    case Not:
+        return !children[0]->matches(record);
+    default:
+        break;
+    }
+
+    if (!isNumeric(field) || op == Contains) {
+        std::string_view text = fieldText(record, field);
+        switch (op) {
+        case Contains: return TextIndex::containsText(text, value);
+        case Equal: return text == value;
+        default: return text != value;
+        }
+    }
+
+    double number = 0.0;
+    if (field == Price) number = record.price;
+    else if (field == Quantity) number = record.quantity;
+    else {
+        int32_t key = publishDateKey(record.publishDate);
+        if (key < 0) return false;
+        number = key;
+    }
+    bool inRange = number >= low && number <= high;
+    return op == NotEqual ? !inRange : inRange;
+}
+
+std::string Query::Node::toString() const {
+    if (kind == Compare) {
+        std::string text = std::string(fieldName(field)) + " " + opName(op) + " ";
+        if (isNumeric(field) && op != Contains) return text + value;
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') quoted += '\\';
+            quoted += c;
+        }
+        return text + quoted + "\"";
+    }
+    if (kind == Not) {
+        const Node& child = *children[0];
+        bool group = child.kind == And || child.kind == Or;
+        std::string text = group ? "NOT (" : "NOT ";
+        text += child.toString();
+        if (group) text += ')';
+        return text;
+    }
+
+    std::string text;
+    for (const auto& child : children) {
+        if (!text.empty()) text += kind == And ? " AND " : " OR ";
+        bool group = child->kind == And || child->kind == Or;
+        // ׷ӣƴʱַ
+        if (group) text += '(';
+        text += child->toString();
+        if (group) text += ')';
+    }
+    return text;
+}
+
+std::string QueryEngine::Trace::toString() const {
+    std::ostringstream out;
+    out << "ִмƻ" << std::endl;
+    for (const auto& candidate : candidates) {
+        out << "  " << candidate << std::endl;
+    }
+    out << "  ã" << access << std::endl;
+    out << "  У " << scanned << " Уƥ " << matched << " ";
+    if (stoppedEarly) out << "Ѵޣǰ";
+    out << std::endl;
+    return out.str();
+}
+
+QueryEngine::Trace QueryEngine::execute(const Query& query, ResultSink& sink) const {
+    return execute(query, [&sink](const BookRecord& record) { return sink.write(record); });
+}
+
+QueryEngine::Trace QueryEngine::execute(const Query& query,
+    const std::function<bool(const BookRecord&)>& visit) const {
+    LibraryMetrics::Span span(library.metrics, LibraryMetrics::Query);
+    Trace trace;
+    const Query::Node* root = query.getRoot();
+    if (!root) return trace;
+
+    // ֻж AND ƵOR/NOT ֮µ޷СѡΧ
+    std::vector<const Query::Node*> conjuncts;
+    if (root->kind == Query::Node::And) {
+        for (const auto& child : root->children) conjuncts.push_back(child.get());
+    }
+    else {
+        conjuncts.push_back(root);
+    }
+
+    // ͬһֵֶεĶΧ
+    const double infinity = std::numeric_limits<double>::infinity();
+    double low[Query::FieldCount], high[Query::FieldCount];
+    bool ranged[Query::FieldCount] = {};
+    std::fill(low, low + Query::FieldCount, -infinity);
+    std::fill(high, high + Query::FieldCount, infinity);
+
+    enum Access { FullScan, IsbnLookup, TextPostings, RangeScan } access = FullScan;
+    size_t bestRows = library.books.size();
+    int isbnSlot = -1;
+    std::vector<uint32_t> postings, textCandidates;
+    Query::Field rangeField = Query::Price;
+
+    for (const Query::Node* node : conjuncts) {
+        if (node->kind != Query::Node::Compare) continue;
+        if (node->field == Query::ISBN && node->op == Query::Equal) {
+            int slot = library.findBookIndex(node->value);
+            size_t rows = slot == -1 ? 0 : 1;
+            trace.candidates.push_back("ISBN ϣ" + node->toString() + "Լ " + std::to_string(rows) + " ");
+            if (rows <= bestRows) {
+                access = IsbnLookup;
+                bestRows = rows;
+                isbnSlot = slot;
+            }
+        }
+        else if ((node->field == Query::Title || node->field == Query::Author || node->field == Query::Publisher)
+            && (node->op == Query::Contains || node->op == Query::Equal)) {
+            TextIndex::Field textField = node->field == Query::Title ? TextIndex::Title
+                : node->field == Query::Author ? TextIndex::Author : TextIndex::Publisher;
+            if (!library.textIndex.candidates(textField, node->value, postings)) continue;
+            trace.candidates.push_back(std::string(Query::fieldName(node->field)) + " ű" + node->toString()
+                + "" + std::to_string(postings.size()) + " ");
+            if (postings.size() < bestRows) {
+                access = TextPostings;
+                bestRows = postings.size();
+                textCandidates.swap(postings);
+            }
+        }
+        else if (Query::isNumeric(node->field) && node->op != Query::Contains && node->op != Query::NotEqual) {
+            low[node->field] = std::max(low[node->field], node->low);
+            high[node->field] = std::min(high[node->field], node->high);
+            ranged[node->field] = true;
+        }
+    }
+
+    // Χϲ
+    auto clampInt = [](double v) {
+        return static_cast<int>(std::max<double>(std::numeric_limits<int>::min(),
+            std::min<double>(std::numeric_limits<int>::max(), v)));
+    };
+    for (Query::Field field : { Query::Price, Query::Quantity, Query::PublishDate }) {
+        if (!ranged[field]) continue;
+        size_t rows = field == Query::Price ? library.priceIndex.count(low[field], high[field])
+            : field == Query::Quantity ? library.quantityIndex.count(clampInt(low[field]), clampInt(high[field]))
+            : library.dateIndex.count(clampInt(low[field]), clampInt(high[field]));
+        trace.candidates.push_back(std::string(Query::fieldName(field)) + "  ["
+            + formatNumber(low[field]) + ", " + formatNumber(high[field]) + "]" + std::to_string(rows) + " ");
+        if (rows < bestRows) {
+            access = RangeScan;
+            bestRows = rows;
+            rangeField = field;
+        }
+    }
+
+    // У
+    auto check = [&](uint32_t slot) {
+        ++trace.scanned;
+        BookRecord record = library.recordAt(slot);
+        if (!query.matches(record)) return true;
+        ++trace.matched;
+        if (!visit(record)) {
+            trace.stoppedEarly = true;
+            return false;
+        }
+        return true;
+    };
+
+    switch (access) {
+    case IsbnLookup:
+        trace.access = "ISBN ϣ";
+        if (isbnSlot != -1) check(static_cast<uint32_t>(isbnSlot));
+        break;
+    case TextPostings:
+        trace.access = "űѡ " + std::to_string(textCandidates.size()) + " ";
+        for (uint32_t slot : textCandidates) {
+            if (!check(slot)) break;
+        }
+        break;
+    case RangeScan:
+        trace.access = std::string(Query::fieldName(rangeField)) + " ɨ裬 "
+            + Query::fieldName(rangeField) + " ";
+        if (rangeField == Query::Price) {
+            library.priceIndex.scan(low[rangeField], high[rangeField], [&](double, uint32_t slot) { return check(slot); });
+        }
+        else if (rangeField == Query::Quantity) {
+            library.quantityIndex.scan(clampInt(low[rangeField]), clampInt(high[rangeField]),
+                [&](int, uint32_t slot) { return check(slot); });
+        }
+        else {
+            library.dateIndex.scan(clampInt(low[rangeField]), clampInt(high[rangeField]),
+                [&](int32_t, uint32_t slot) { return check(slot); });
+        }
+        break;
+    default:
+        trace.access = "ȫɨ";
+        for (size_t slot = 0; slot < library.books.slotCount(); ++slot) {
+            if (library.books.contains(slot) && !check(static_cast<uint32_t>(slot))) break;
+        }
+        break;
+    }
+    span.rows(trace.scanned, trace.matched);
+    return trace;
+}
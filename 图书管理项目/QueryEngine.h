@@ -0,0 +1,75 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "ResultSink.h"
+
+class Library;
+
+// ϲѯ磺author contains "໪" AND price < 30 AND quantity > 0
+//   ֶΣisbn title author publisher date price quantityҲд ISBN     ۸ 
+//   㣺contains = != < <= > >= AND / OR / NOT 
+// ڰ淶ļȽϣ"date = 2000" ƥ 2000 ڵڣ޷ʶڲκڱȽ
+class Query {
+public:
+    enum Field { ISBN, Title, Author, Publisher, PublishDate, Price, Quantity, FieldCount };
+    enum Op { Contains, Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+    struct Node {
+        enum Kind { And, Or, Not, Compare } kind = Compare;
+        std::vector<std::unique_ptr<Node>> children;
+
+        // Ƚ
+        Field field = Title;
+        Op op = Contains;
+        std::string value;
+        double low = 0.0, high = 0.0;   // ֵֶΣı䣨!= ȡ⣩
+
+        bool matches(const BookRecord& record) const;
+        std::string toString() const;
+    };
+
+private:
+    std::unique_ptr<Node> root;
+
+public:
+    static bool parse(std::string_view text, Query& out, std::string& error);
+
+    const Node* getRoot() const { return root.get(); }
+    bool matches(const BookRecord& record) const { return root->matches(record); }
+    std::string toString() const { return root ? root->toString() : std::string(); }
+
+    static const char* fieldName(Field field);
+    static bool isNumeric(Field field) { return field == PublishDate || field == Price || field == Quantity; }
+};
+
+// ѯִУڶ AND ĸѡѡٵISBN ϣ//絹ű
+// ۸//ֻЩѡУй
+class QueryEngine {
+public:
+    // ִй̼¼EXPLAIN
+    struct Trace {
+        std::vector<std::string> candidates;   // ÷·
+        std::string access;                    // ʵʲõķ·
+        size_t scanned = 0;                    // У
+        size_t matched = 0;                    // 
+        bool stoppedEarly = false;             // ǰ
+
+        std::string toString() const;
+    };
+
+private:
+    const Library& library;
+
+public:
+    explicit QueryEngine(const Library& library) : library(library) {}
+
+    // ƻͼ飬visit  false ʱֹͣ
+    Trace execute(const Query& query, const std::function<bool(const BookRecord&)>& visit) const;
+    Trace execute(const Query& query, ResultSink& sink) const;
+};
+
+#endif // QUERY_ENGINE_H
@@ -0,0 +1,176 @@
+#include <charconv>
+#include <cstdio>
+#include "ResultSink.h"
+
+ResultSink::ResultSink(std::ostream& out, Format format, size_t offset, size_t limit)
+    : out(out), format(format), offset(offset), limit(limit) {
+    buffer.reserve(bufferSize + 1024);
+}
+
+ResultSink::~ResultSink() {
+    flush();
+}
+
+void ResultSink::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
+
+void ResultSink::flushIfFull() {
+    if (buffer.size() >= bufferSize) flush();
+}
+
+void ResultSink::appendPrice(double price) {
+    char text[64];
+    auto result = std::to_chars(text, text + sizeof(text), price, std::chars_format::fixed, 2);
+    buffer.append(text, result.ptr);
+}
+
+void ResultSink::appendInt(long long value) {
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+void ResultSink::appendTsvField(std::string_view text) {
+    // ֶڵƱкͷбת壬֤һһ¼
+    for (char c : text) {
+        switch (c) {
+        case '\t': buffer += "\\t"; break;
+        case '\n': buffer += "\\n"; break;
+        case '\r': buffer += "\\r"; break;
+        case '\\': buffer += "\\\\"; break;
+        default: buffer += c;
+        }
+    }
+}
+
+void ResultSink::appendJsonString(std::string_view text) {
+    appendJsonString(buffer, text);
+}
+
+void ResultSink::appendJsonString(std::string& json, std::string_view text) {
+    json += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"': json += "\\\""; break;
+        case '\\': json += "\\\\"; break;
+        case '\n': json += "\\n"; break;
+        case '\r': json += "\\r"; break;
+        case '\t': json += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                json += escaped;
+            }
+            else {
+                json += c;  //  ASCII ֽڰԭ
+            }
+        }
+    }
+    json += '"';
+}
+
+bool ResultSink::write(const BookRecord& record) {
+    if (full()) return false;
+    if (matchedCount++ < offset) return true;
+
+    switch (format) {
+    case Human:
+        buffer += "================================\nISBN: ";
+        buffer.append(record.isbn);
+        buffer += "\n: ";
+        buffer.append(record.title);
+        buffer += "\n: ";
+        buffer.append(record.author);
+        buffer += "\n: ";
+        buffer.append(record.publisher);
+        buffer += "\n: ";
+        buffer.append(record.publishDate);
+        buffer += "\n۸: ";
+        appendPrice(record.price);
+        buffer += "Ԫ\n: ";
+        appendInt(record.quantity);
+        buffer += "\n================================\n";
+        break;
+    case Brief:
+        buffer += "ISBN: ";
+        buffer.append(record.isbn);
+        buffer += "\n: ";
+        buffer.append(record.title);
+        buffer += "\n: ";
+        buffer.append(record.author);
+        buffer += "\n۸: ";
+        appendPrice(record.price);
+        buffer += "Ԫ\n: ";
+        appendInt(record.quantity);
+        buffer += "\n------------------------\n";
+        break;
+    case TSV:
+        if (!headerWritten) {
+            buffer += "isbn\ttitle\tauthor\tpublisher\tpublish_date\tprice\tquantity\n";
+            headerWritten = true;
+        }
+        appendTsvField(record.isbn);
+        buffer += '\t';
+        appendTsvField(record.title);
+        buffer += '\t';
+        appendTsvField(record.author);
+        buffer += '\t';
+        appendTsvField(record.publisher);
+        buffer += '\t';
+        appendTsvField(record.publishDate);
+        buffer += '\t';
+        appendPrice(record.price);
+        buffer += '\t';
+        appendInt(record.quantity);
+        buffer += '\n';
+        break;
+    case JsonLines:
+        buffer += "{\"isbn\":";
+        appendJsonString(record.isbn);
+        buffer += ",\"title\":";
+        appendJsonString(record.title);
+        buffer += ",\"author\":";
+        appendJsonString(record.author);
+        buffer += ",\"publisher\":";
+        appendJsonString(record.publisher);
+        buffer += ",\"publishDate\":";
+        appendJsonString(record.publishDate);
+        buffer += ",\"price\":";
+        appendPrice(record.price);
+        buffer += ",\"quantity\":";
+        appendInt(record.quantity);
+        buffer += "}\n";
+        break;
+    }
+    ++writtenCount;
+    flushIfFull();
+    return !full();
+}
+
+void ResultSink::heading(std::string_view text) {
+    if (format != Human && format != Brief) return;
+    buffer.append(text);
+    buffer += '\n';
+    flushIfFull();
+}
+
+void ResultSink::heading(std::initializer_list<std::string_view> parts) {
+    if (format != Human && format != Brief) return;
+    for (std::string_view part : parts) buffer.append(part);
+    buffer += '\n';
+    flushIfFull();
+}
+
+bool ResultSink::parseFormat(std::string_view name, Format& format) {
+    if (name == "human") format = Human;
+    else if (name == "brief") format = Brief;
+    else if (name == "tsv") format = TSV;
+    else if (name == "json") format = JsonLines;
+    else return false;
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <limits>
+#include <initializer_list>
+
+// һͼ¼ֶֻΣƣ
+struct BookRecord {
+    std::string_view isbn;
+    std::string_view title;
+    std::string_view author;
+    std::string_view publisher;
+    std::string_view publishDate;
+    double price = 0.0;
+    int quantity = 0;
+};
+
+// ѯдڲдˢ
+// ֧ offset/limit ҳԼ˺ļָʽ
+class ResultSink {
+public:
+    enum Format {
+        Human,      // Ϣÿһ
+        Brief,      // бժҪISBNߡ۸
+        TSV,        // ƱָΪ
+        JsonLines   // ÿһ JSON 
+    };
+
+    static constexpr size_t bufferSize = 64 * 1024;
+
+private:
+    std::ostream& out;
+    Format format;
+    size_t offset;
+    size_t limit;
+    size_t matchedCount = 0;   // ύƥ¼ģ
+    size_t writtenCount = 0;   // ʵļ¼
+    bool headerWritten = false;
+    std::string buffer;
+
+    void appendPrice(double price);
+    void appendInt(long long value);
+    void appendTsvField(std::string_view text);
+    void appendJsonString(std::string_view text);
+    void flushIfFull();
+
+public:
+    explicit ResultSink(std::ostream& out, Format format = Human,
+        size_t offset = 0, size_t limit = std::numeric_limits<size_t>::max());
+    ~ResultSink();
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    // ύһƥ¼ false ʾ limit÷ֹͣö
+    bool write(const BookRecord& record);
+
+    // Ƿ limit
+    bool full() const { return writtenCount >= limit; }
+
+    // ⡢ʾ˵ֻ֣˵ĸʽֶδʱֱƴӵʱַ
+    void heading(std::string_view text);
+    void heading(std::initializer_list<std::string_view> parts);
+
+    // ѻдײ
+    void flush();
+
+    Format getFormat() const { return format; }
+    size_t matched() const { return matchedCount; }
+    size_t written() const { return writtenCount; }
+
+    // ʽhuman / brief / tsv / json
+    static bool parseFormat(std::string_view name, Format& format);
+
+    //  text дɴšת JSON ַ׷ӵ jsonļ¼ JSON ã
+    static void appendJsonString(std::string& json, std::string_view text);
+};
+
+#endif // RESULT_SINK_H
@@ -1,7 +1,268 @@
 #include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <limits>
+#include <charconv>
+#include <csignal>
 #include "LibraryManagement.h"
+#include "BinaryCatalog.h"
+#include "QueryEngine.h"
+#include "LibraryServer.h"
+
+// ӲļȡһɾĲִУһиʽʱִ
+static int applyOperationFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "޷ļ " << path << "" << std::endl;
+        return 1;
+    }
+
+    std::vector<BookOperation> operations;
+    BookOperation operation;
+    std::string line, error;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (!BookOperation::tryParse(line, operation, error)) {
+            std::cerr << "󣺵 " << lineNumber << " " << error << "δִС" << std::endl;
+            return 1;
+        }
+        operations.push_back(std::move(operation));
+    }
+
+    Library library;
+    return library.applyBatch(operations) ? 0 : 1;
+}
+
+// ѡ--format--offset--limit--explain
+struct OutputOptions {
+    ResultSink::Format format = ResultSink::Brief;
+    size_t offset = 0;
+    size_t limit = std::numeric_limits<size_t>::max();
+    bool explain = false;
+};
+
+static bool parseOutputOptions(int argc, char* argv[], int first, OutputOptions& options) {
+    for (int i = first; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--explain") {
+            options.explain = true;
+            --i;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "ѡ " << option << " ȱٲ" << std::endl;
+            return false;
+        }
+        std::string value = argv[i + 1];
+        bool ok = true;
+        if (option == "--format") ok = ResultSink::parseFormat(value, options.format);
+        else if (option == "--offset" || option == "--limit") {
+            size_t number = 0;
+            auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+            ok = result.ec == std::errc() && result.ptr == value.data() + value.size();
+            (option == "--offset" ? options.offset : options.limit) = number;
+        }
+        else ok = false;
+        if (!ok) {
+            std::cerr << "Чѡ " << option << " " << value << "" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ָʽҳгȫͼ飬״̬ʾд׼󣬱׼ֻн
+static int listBooks(int argc, char* argv[]) {
+    OutputOptions options;
+    if (!parseOutputOptions(argc, argv, 2, options)) return 2;
+
+    Library library(&std::cerr);
+    ResultSink sink(std::cout, options.format, options.offset, options.limit);
+    library.displayAllBooks(sink);
+    return 0;
+}
+
+// ִϲѯ--explain ʱִмƻд׼
+static int runQuery(int argc, char* argv[]) {
+    OutputOptions options;
+    if (argc < 3 || !parseOutputOptions(argc, argv, 3, options)) return 2;
+
+    Query query;
+    std::string error;
+    if (!Query::parse(argv[2], query, error)) {
+        std::cerr << "󣺲ѯ" << error << "" << std::endl;
+        return 2;
+    }
+
+    Library library(&std::cerr);
+    QueryEngine::Trace trace;
+    {
+        ResultSink sink(std::cout, options.format, options.offset, options.limit);
+        trace = QueryEngine(library).execute(query, sink);
+    }
+    if (options.explain) {
+        std::cerr << "ѯ" << query.toString() << std::endl << trace.toString();
+    }
+    return 0;
+}
+
+// ģƶӽͼ飬Ĭ 20 
+static int runFuzzySearch(int argc, char* argv[]) {
+    OutputOptions options;
+    TextIndex::Field field;
+    if (argc < 4) return 2;
+    if (!TextIndex::parseField(argv[2], field)) {
+        std::cerr << "Чֶ " << argv[2] << "ӦΪ titleauthor  publisher" << std::endl;
+        return 2;
+    }
+    if (!parseOutputOptions(argc, argv, 4, options)) return 2;
+
+    Library library(&std::cerr);
+    size_t top = options.limit == std::numeric_limits<size_t>::max() ? 20 : options.limit;
+    ResultSink sink(std::cout, options.format, options.offset, top);
+    library.searchRanked(field, argv[3], sink, options.offset + top);
+    return 0;
+}
+
+// űģʽļ׼ִд׼
+static int runScript(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    LibraryUI librarySystem(nullptr);
+    if (argc < 3 || std::string(argv[2]) == "-") {
+        return librarySystem.runScript(std::cin, std::cout);
+    }
+    std::ifstream in(argv[2], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "޷ļ " << argv[2] << "" << std::endl;
+        return 2;
+    }
+    return librarySystem.runScript(in, std::cout);
+}
+
+static LibraryServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer) activeServer->stop();
+}
+
+// ѯ񣺼׽ֱ֣յ SIGINT/SIGTERM˳ʱ
+static int runServer(int argc, char* argv[]) {
+    LibraryServer::Options options;
+    options.address = argv[2];
+    if (argc % 2 == 0) {
+        std::cerr << "ѡ " << argv[argc - 1] << " ȱٲ" << std::endl;
+        return 2;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--metrics-file") {
+            options.metricsFile = value;
+            continue;
+        }
+        size_t number = 0;
+        auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (result.ec != std::errc() || result.ptr != value.data() + value.size() ||
+            (option != "--workers" && option != "--batch" && option != "--metrics-interval")) {
+            std::cerr << "Чѡ " << option << " " << value << "" << std::endl;
+            return 2;
+        }
+        (option == "--workers" ? options.workers : option == "--batch" ? options.maxBatch : options.metricsInterval) = number;
+    }
+
+    Library library(&std::cerr);
+    library.setMessageStream(nullptr);  // ɾĵĽӦأʾ
+    LibraryServer server(library);
+    std::string error;
+    if (!server.start(options, error)) {
+        std::cerr << "" << error << "" << std::endl;
+        return 1;
+    }
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    std::cerr << "ѯ" << options.address << std::endl;
+    server.run();
+    activeServer = nullptr;
+    std::cerr << "ѯֹͣ" << std::endl;
+    return 0;
+}
+
+// йߣѯ񡢽űģʽбϲѯִвļıĿ¼תISBNѯĿ¼
+static int runTool(int argc, char* argv[]) {
+    std::string command = argv[1];
+    if (command == "--script" && argc <= 3) {
+        return runScript(argc, argv);
+    }
+    if (command == "--serve" && argc >= 3) {
+        return runServer(argc, argv);
+    }
+    if (command == "--list") {
+        return listBooks(argc, argv);
+    }
+    if (command == "--query") {
+        return runQuery(argc, argv);
+    }
+    if (command == "--fuzzy") {
+        return runFuzzySearch(argc, argv);
+    }
+    if (command == "--apply" && argc == 3) {
+        return applyOperationFile(argv[2]);
+    }
+    if (command == "--export-binary" && argc == 4) {
+        return BinaryCatalog::exportFromText(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (command == "--import-binary" && argc == 4) {
+        return BinaryCatalog::importToText(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (command == "--lookup" && argc == 4) {
+        BinaryCatalog catalog;
+        std::string error;
+        if (!catalog.open(argv[2], error)) {
+            std::cerr << "" << error << "" << std::endl;
+            return 1;
+        }
+        long long index = catalog.findByISBN(argv[3]);
+        if (index < 0) {
+            std::cout << "δҵISBNΪ " << argv[3] << " ͼ顣" << std::endl;
+            return 1;
+        }
+        catalog.get(static_cast<size_t>(index)).displayInfo();
+        return 0;
+    }
+
+    std::cerr << "÷" << std::endl
+        << "  " << argv[0] << " --apply <ļ>                     ִɾģA|ͼ顢U|ԭISBN|ͼ顢D|ISBN" << std::endl
+        << "  " << argv[0] << " --script [ļ|-]                   űģʽִʡļʱ׼룩" << std::endl
+        << "  " << argv[0] << " --serve <unix:·|[:]˿> [--workers N] [--batch N] [--metrics-file ·] [--metrics-interval ]   ѯЭͬűģʽ" << std::endl
+        << "  " << argv[0] << " --list [--format human|brief|tsv|json] [--offset N] [--limit N]   гͼ" << std::endl
+        << "  " << argv[0] << " --query <> [--format ...] [--offset N] [--limit N] [--explain]   ѯ" << std::endl
+        << "  " << argv[0] << " --fuzzy <title|author|publisher> <ؼ> [--format ...] [--offset N] [--limit N]   ģƶĬ 20 " << std::endl
+        << "  " << argv[0] << " --export-binary <book.txt> <Ŀ¼ļ>   ıݵΪĿ¼" << std::endl
+        << "  " << argv[0] << " --import-binary <Ŀ¼ļ> <book.txt>   Ŀ¼Ϊı" << std::endl
+        << "  " << argv[0] << " --lookup <Ŀ¼ļ> <ISBN>             ڶĿ¼аISBNѯ" << std::endl
+        << "  " << argv[0] << " --trace <ļ> []           ѱеĲʱд Chrome trace JSON" << std::endl;
+    return 2;
+}
+
+int main(int argc, char* argv[]) {
+    // --trace <ļ> ɷκģʽ֮ǰڼ¼䣬˳ʱдļ
+    if (argc > 2 && std::string(argv[1]) == "--trace") {
+        LibraryMetrics::traceToFile(argv[2]);
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc > 1) {
+        return runTool(argc, argv);
+    }
 
-int main() {
     std::cout << "================================" << std::endl;
     std::cout << "      ͼݹϵͳ v2.0" << std::endl;
     std::cout << "      ݴ洢book.txt" << std::endl;
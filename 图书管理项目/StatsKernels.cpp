@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <thread>
+#include "StatsKernels.h"
+#include "CatalogStatistics.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STATS_HAS_X86 1
+#define STATS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define STATS_HAS_X86 1
+#define STATS_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+    // ֿм
+    struct Partial {
+        long long valueCents = 0;
+        long long copies = 0;
+        double minPrice = std::numeric_limits<double>::infinity();
+        double maxPrice = -std::numeric_limits<double>::infinity();
+    };
+
+    Partial scalarKernel(const double* prices, const int* quantities, size_t count) {
+        Partial r;
+        for (size_t i = 0; i < count; ++i) {
+            double price = prices[i];
+            r.valueCents += CatalogStatistics::toCents(price, quantities[i]);
+            r.copies += quantities[i];
+            r.minPrice = std::min(r.minPrice, price);
+            r.maxPrice = std::max(r.maxPrice, price);
+        }
+        return r;
+    }
+
+#ifdef STATS_HAS_X86
+    STATS_TARGET_AVX2
+    Partial avx2Kernel(const double* prices, const int* quantities, size_t count) {
+        // ÿĽ CatalogStatistics::toCents λͬͨۼӣٺϲͨ
+        const __m256d hundred = _mm256_set1_pd(100.0);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+        const __m256d infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+        const __m256d maxCents = _mm256_set1_pd(static_cast<double>(CatalogStatistics::maxValueCents));
+        const __m256d minCents = _mm256_set1_pd(-static_cast<double>(CatalogStatistics::maxValueCents));
+        const __m256d magic = _mm256_set1_pd(6755399441055744.0);   // 2^52 + 2^51
+        __m256i cents = _mm256_setzero_si256();
+        __m256d minv = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+        __m256d maxv = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+        __m256i copies = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d price = _mm256_loadu_pd(prices + i);
+            __m128i qty = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i));
+            __m256d quantity = _mm256_cvtepi32_pd(qty);
+
+            // ۸ 100 루Զ㣩ضϺСֲ 1Ǿȷ
+            __m256d scaled = _mm256_mul_pd(price, hundred);
+            __m256d truncated = _mm256_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            __m256d fraction = _mm256_andnot_pd(signBit, _mm256_sub_pd(scaled, truncated));
+            __m256d carry = _mm256_and_pd(_mm256_cmp_pd(fraction, half, _CMP_GE_OQ),
+                _mm256_or_pd(_mm256_and_pd(scaled, signBit), one));
+            __m256d value = _mm256_mul_pd(_mm256_add_pd(truncated, carry), quantity);
+            value = _mm256_max_pd(_mm256_min_pd(value, maxCents), minCents);
+            // ۸޻Ϊ 0 ʱΪ 0
+            __m256d counted = _mm256_and_pd(_mm256_cmp_pd(_mm256_andnot_pd(signBit, price), infinity, _CMP_LT_OQ),
+                _mm256_cmp_pd(quantity, _mm256_setzero_pd(), _CMP_NEQ_OQ));
+            value = _mm256_and_pd(value, counted);
+            // |value|  maxValueCents < 2^51 magic βĵλΪ
+            cents = _mm256_add_epi64(cents,
+                _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(value, magic)), _mm256_castpd_si256(magic)));
+
+            copies = _mm256_add_epi64(copies, _mm256_cvtepi32_epi64(qty));
+            minv = _mm256_min_pd(minv, price);
+            maxv = _mm256_max_pd(maxv, price);
+        }
+
+        alignas(32) double mins[4], maxs[4];
+        alignas(32) long long values[4], counts[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), cents);
+        _mm256_store_pd(mins, minv);
+        _mm256_store_pd(maxs, maxv);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(counts), copies);
+
+        Partial r = scalarKernel(prices + i, quantities + i, count - i);
+        for (int lane = 0; lane < 4; ++lane) {
+            r.valueCents += values[lane];
+            r.copies += counts[lane];
+            r.minPrice = std::min(r.minPrice, mins[lane]);
+            r.maxPrice = std::max(r.maxPrice, maxs[lane]);
+        }
+        return r;
+    }
+#endif
+
+    bool detectAvx2() {
+#if defined(STATS_HAS_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(STATS_HAS_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    Partial runKernel(const double* prices, const int* quantities, size_t count) {
+#ifdef STATS_HAS_X86
+        if (StatsKernels::usingAvx2()) {
+            return avx2Kernel(prices, quantities, count);
+        }
+#endif
+        return scalarKernel(prices, quantities, count);
+    }
+}
+
+bool StatsKernels::usingAvx2() {
+    static const bool supported = detectAvx2();
+    return supported;
+}
+
+PriceSummary StatsKernels::summarize(const double* prices, const int* quantities, size_t count, bool parallel) {
+    PriceSummary summary;
+    summary.count = count;
+    if (count == 0) return summary;
+
+    size_t threads = parallel ? std::max<size_t>(1, std::thread::hardware_concurrency()) : 1;
+    threads = std::min(threads, std::max<size_t>(1, count / 65536));
+
+    std::vector<Partial> partials(threads);
+    if (threads == 1) {
+        partials[0] = runKernel(prices, quantities, count);
+    }
+    else {
+        // ֿ鲢йԼϲ֤ظ
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            size_t begin = count * t / threads;
+            size_t end = count * (t + 1) / threads;
+            workers.emplace_back([&partials, prices, quantities, t, begin, end] {
+                partials[t] = runKernel(prices + begin, quantities + begin, end - begin);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    Partial total;
+    for (const auto& p : partials) {
+        total.valueCents += p.valueCents;
+        total.copies += p.copies;
+        total.minPrice = std::min(total.minPrice, p.minPrice);
+        total.maxPrice = std::max(total.maxPrice, p.maxPrice);
+    }
+
+    summary.valueCents = total.valueCents;
+    summary.totalCopies = total.copies;
+    summary.minPrice = total.minPrice;
+    summary.maxPrice = total.maxPrice;
+    return summary;
+}
+
+double StatsKernels::pricePercentile(const double* prices, size_t count, double q) {
+    if (count == 0) return 0.0;
+    q = std::min(1.0, std::max(0.0, q));
+
+    // Բֵڵ lo  lo+1 ˳ͳ֮ȡֵ
+    std::vector<double> sorted(prices, prices + count);
+    double rank = q * static_cast<double>(count - 1);
+    size_t lo = static_cast<size_t>(rank);
+    std::nth_element(sorted.begin(), sorted.begin() + lo, sorted.end());
+    double low = sorted[lo];
+    if (lo + 1 >= count) return low;
+    double high = *std::min_element(sorted.begin() + lo + 1, sorted.end());
+    return low + (high - low) * (rank - static_cast<double>(lo));
+}
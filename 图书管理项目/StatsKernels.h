@@ -0,0 +1,31 @@
+#ifndef STATS_KERNELS_H
+#define STATS_KERNELS_H
+#include <cstddef>
+
+// ۸/еĻܽ
+struct PriceSummary {
+    size_t count = 0;              // ͼ
+    long long totalCopies = 0;     // 
+    long long valueCents = 0;      // ֵܼ֣𱾰 CatalogStatistics::toCents ȡۼ
+    double minPrice = 0.0;
+    double maxPrice = 0.0;
+};
+
+// ͳںˣȫɨ裬 verifyStatistics Уάͳƻ档
+// AVX2 ʵʵ֣ʱ CPU ֧ѡ
+class StatsKernels {
+public:
+    // ܼ۸parallel Ϊ true ʱֿ̹߳Լ
+    static PriceSummary summarize(const double* prices, const int* quantities, size_t count, bool parallel = false);
+
+    // ۸λq ȡ 0~1 0.5 Ϊλ0.9 Ϊ P90
+    static double pricePercentile(const double* prices, size_t count, double q);
+
+    // ǰ CPU Ƿ AVX2 ں
+    static bool usingAvx2();
+
+    // ﵽʱ verifyStatistics òйԼ
+    static constexpr size_t parallelThreshold = 1 << 20;
+};
+
+#endif // STATS_KERNELS_H
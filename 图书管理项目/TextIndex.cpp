@@ -0,0 +1,567 @@
+#include <algorithm>
+#include <bitset>
+#include <utility>
+#include "TextIndex.h"
+
+namespace {
+
+// ֵ֣֣Unicode λ GBK һ
+struct FoldPair {
+    uint16_t traditional, simplified, traditionalGbk, simplifiedGbk;
+};
+
+const FoldPair foldPairs[] = {
+    { 0x4E9E, 0x4E9A, 0x8186, 0xD1C7 }, { 0x4F86, 0x6765, 0x81ED, 0xC0B4 }, { 0x4F96, 0x4ED1, 0x81F6, 0xC2D8 }, { 0x500B, 0x4E2A, 0x8280, 0xB8F6 },
+    { 0x5011, 0x4EEC, 0x8283, 0xC3C7 }, { 0x502B, 0x4F26, 0x8290, 0xC2D7 }, { 0x5049, 0x4F1F, 0x82A5, 0xCEB0 }, { 0x5091, 0x6770, 0x82DC, 0xBDDC },
+    { 0x50B3, 0x4F20, 0x82F7, 0xB4AB }, { 0x50B7, 0x4F24, 0x82FB, 0xC9CB }, { 0x50C5, 0x4EC5, 0x8348, 0xBDF6 }, { 0x50F9, 0x4EF7, 0x8372, 0xBCDB },
+    { 0x5100, 0x4EEA, 0x8378, 0xD2C7 }, { 0x5104, 0x4EBF, 0x837C, 0xD2DA }, { 0x512A, 0x4F18, 0x839E, 0xD3C5 }, { 0x5152, 0x513F, 0x83BA, 0xB6F9 },
+    { 0x5167, 0x5185, 0x83C8, 0xC4DA }, { 0x5169, 0x4E24, 0x83C9, 0xC1BD }, { 0x518A, 0x518C, 0x83D4, 0xB2E1 }, { 0x5275, 0x521B, 0x8493, 0xB4B4 },
+    { 0x5283, 0x5212, 0x849D, 0xBBAE }, { 0x5287, 0x5267, 0x84A1, 0xBEE7 }, { 0x5289, 0x5218, 0x84A2, 0xC1F5 }, { 0x52D5, 0x52A8, 0x84D3, 0xB6AF },
+    { 0x52D9, 0x52A1, 0x84D5, 0xCEF1 }, { 0x52DD, 0x80DC, 0x84D9, 0xCAA4 }, { 0x52DE, 0x52B3, 0x84DA, 0xC0CD }, { 0x52E2, 0x52BF, 0x84DD, 0xCAC6 },
+    { 0x5340, 0x533A, 0x855E, 0xC7F8 }, { 0x5354, 0x534F, 0x8566, 0xD0AD }, { 0x537B, 0x5374, 0x8573, 0xC8B4 }, { 0x53B2, 0x5389, 0x8596, 0xC0F7 },
+    { 0x53C3, 0x53C2, 0x85A2, 0xB2CE }, { 0x5433, 0x5434, 0x85C7, 0xCEE2 }, { 0x54E1, 0x5458, 0x8654, 0xD4B1 }, { 0x554F, 0x95EE, 0x8696, 0xCECA },
+    { 0x555F, 0x542F, 0x86A2, 0xC6F4 }, { 0x55AC, 0x4E54, 0x86CC, 0xC7C7 }, { 0x55AE, 0x5355, 0x86CE, 0xB5A5 }, { 0x56B4, 0x4E25, 0x87C0, 0xD1CF },
+    { 0x56D1, 0x5631, 0x87DA, 0xD6F6 }, { 0x570B, 0x56FD, 0x87F8, 0xB9FA }, { 0x5712, 0x56ED, 0x8840, 0xD4B0 }, { 0x5713, 0x5706, 0x8841, 0xD4B2 },
+    { 0x5716, 0x56FE, 0x8844, 0xCDBC }, { 0x5718, 0x56E2, 0x8846, 0xCDC5 }, { 0x5831, 0x62A5, 0x88F3, 0xB1A8 }, { 0x5834, 0x573A, 0x88F6, 0xB3A1 },
+    { 0x58D3, 0x538B, 0x89BA, 0xD1B9 }, { 0x58FD, 0x5BFF, 0x89DB, 0xCAD9 }, { 0x5920, 0x591F, 0x89F2, 0xB9BB }, { 0x5922, 0x68A6, 0x89F4, 0xC3CE },
+    { 0x5925, 0x4F19, 0xE2B7, 0xBBEF }, { 0x593E, 0x5939, 0x8A41, 0xBCD0 }, { 0x5967, 0x5965, 0x8A57, 0xB0C2 }, { 0x596A, 0x593A, 0x8A5A, 0xB6E1 },
+    { 0x596E, 0x594B, 0x8A5E, 0xB7DC }, { 0x5A41, 0x5A04, 0x8AE4, 0xC2A6 }, { 0x5A66, 0x5987, 0x8B44, 0xB8BE }, { 0x5ABD, 0x5988, 0x8B8C, 0xC2E8 },
+    { 0x5B0C, 0x5A07, 0x8BC9, 0xBDBF }, { 0x5B30, 0x5A74, 0x8BEB, 0xD3A4 }, { 0x5B6B, 0x5B59, 0x8C4F, 0xCBEF }, { 0x5B78, 0x5B66, 0x8C57, 0xD1A7 },
+    { 0x5BE6, 0x5B9E, 0x8C8D, 0xCAB5 }, { 0x5BE7, 0x5B81, 0x8C8E, 0xC4FE }, { 0x5BE9, 0x5BA1, 0x8C8F, 0xC9F3 }, { 0x5BEB, 0x5199, 0x8C91, 0xD0B4 },
+    { 0x5BEC, 0x5BBD, 0x8C92, 0xBFED }, { 0x5BF5, 0x5BA0, 0x8C99, 0xB3E8 }, { 0x5BF6, 0x5B9D, 0x8C9A, 0xB1A6 }, { 0x5C07, 0x5C06, 0x8CA2, 0xBDAB },
+    { 0x5C08, 0x4E13, 0x8CA3, 0xD7A8 }, { 0x5C0B, 0x5BFB, 0x8CA4, 0xD1B0 }, { 0x5C0D, 0x5BF9, 0x8CA6, 0xB6D4 }, { 0x5C0E, 0x5BFC, 0x8CA7, 0xB5BC },
+    { 0x5C46, 0x5C4A, 0x8CC3, 0xBDEC }, { 0x5C4D, 0x5C38, 0x8CC6, 0xCAAC }, { 0x5C62, 0x5C61, 0x8CD2, 0xC2C5 }, { 0x5C64, 0x5C42, 0x8CD3, 0xB2E3 },
+    { 0x5C6C, 0x5C5E, 0x8CD9, 0xCAF4 }, { 0x5CA1, 0x5188, 0x8CF9, 0xB8D4 }, { 0x5CF6, 0x5C9B, 0x8D75, 0xB5BA }, { 0x5D17, 0x5C97, 0x8D8F, 0xB8DA },
+    { 0x5DBA, 0x5CAD, 0x8E58, 0xC1EB }, { 0x5DD2, 0x5CE6, 0x8E6E, 0xC2CD }, { 0x5DD6, 0x5CA9, 0x8E72, 0xD1D2 }, { 0x5E2B, 0x5E08, 0x8E9F, 0xCAA6 },
+    { 0x5E36, 0x5E26, 0x8EA7, 0xB4F8 }, { 0x5E5F, 0x5E1C, 0x8EC3, 0xD6C4 }, { 0x5E63, 0x5E01, 0x8EC5, 0xB1D2 }, { 0x5E6B, 0x5E2E, 0x8ECD, 0xB0EF },
+    { 0x5E79, 0x5E72, 0x8ED6, 0xB8C9 }, { 0x5E7E, 0x51E0, 0x8ED7, 0xBCB8 }, { 0x5EAB, 0x5E93, 0x8EEC, 0xBFE2 }, { 0x5EDF, 0x5E99, 0x8F52, 0xC3ED },
+    { 0x5EE0, 0x5382, 0x8F53, 0xB3A7 }, { 0x5EE2, 0x5E9F, 0x8F55, 0xB7CF }, { 0x5EE3, 0x5E7F, 0x8F56, 0xB9E3 }, { 0x5EF3, 0x5385, 0x8F64, 0xCCFC },
+    { 0x5F35, 0x5F20, 0x8F88, 0xD5C5 }, { 0x5F37, 0x5F3A, 0x8F8A, 0xC7BF }, { 0x5F48, 0x5F39, 0x8F97, 0xB5AF }, { 0x5F4C, 0x5F25, 0x8F9B, 0xC3D6 },
+    { 0x5F4E, 0x5F2F, 0x8F9D, 0xCDE4 }, { 0x5F59, 0x6C47, 0x8FA1, 0xBBE3 }, { 0x5F8C, 0x540E, 0xE1E1, 0xBAF3 }, { 0x5F91, 0x5F84, 0x8FBD, 0xBEB6 },
+    { 0x5F9E, 0x4ECE, 0x8FC4, 0xB4D3 }, { 0x5FA9, 0x590D, 0x8FCD, 0xB8B4 }, { 0x5FB5, 0x5F81, 0xE1E7, 0xD5F7 }, { 0x5FB9, 0x5F7B, 0x8FD8, 0xB3B9 },
+    { 0x611B, 0x7231, 0x90DB, 0xB0AE }, { 0x614B, 0x6001, 0x9142, 0xCCAC }, { 0x6182, 0x5FE7, 0x916E, 0xD3C7 }, { 0x61B6, 0x5FC6, 0x919B, 0xD2E4 },
+    { 0x61C7, 0x6073, 0x91A9, 0xBFD2 }, { 0x61C9, 0x5E94, 0x91AA, 0xD3A6 }, { 0x61F7, 0x6000, 0x91D1, 0xBBB3 }, { 0x61F8, 0x60AC, 0x91D2, 0xD0FC },
+    { 0x61FC, 0x60E7, 0x91D6, 0xBEE5 }, { 0x6200, 0x604B, 0x91D9, 0xC1B5 }, { 0x6230, 0x6218, 0x91F0, 0xD5BD }, { 0x6232, 0x620F, 0x91F2, 0xCFB7 },
+    { 0x6236, 0x6237, 0x91F4, 0xBBA7 }, { 0x62CB, 0x629B, 0x9281, 0xC5D7 }, { 0x633E, 0x631F, 0x92B6, 0xD0AE }, { 0x6368, 0x820D, 0x92CE, 0xC9E1 },
+    { 0x6383, 0x626B, 0x92DF, 0xC9A8 }, { 0x6399, 0x6323, 0x92EA, 0xD5F5 }, { 0x63C0, 0x62E3, 0x92FE, 0xBCF0 }, { 0x63DA, 0x626C, 0x9350, 0xD1EF },
+    { 0x63DB, 0x6362, 0x9351, 0xBBBB }, { 0x63EE, 0x6325, 0x935D, 0xBBD3 }, { 0x640D, 0x635F, 0x9370, 0xCBF0 }, { 0x6416, 0x6447, 0x9375, 0xD2A1 },
+    { 0x6436, 0x62A2, 0x938C, 0xC7C0 }, { 0x646F, 0x631A, 0x93B4, 0xD6BF }, { 0x64AB, 0x629A, 0x93E1, 0xB8A7 }, { 0x64C1, 0x62E5, 0x93ED, 0xD3B5 },
+    { 0x64C7, 0x62E9, 0x93F1, 0xD4F1 }, { 0x64CA, 0x51FB, 0x93F4, 0xBBF7 }, { 0x64CB, 0x6321, 0x93F5, 0xB5B2 }, { 0x64D4, 0x62C5, 0x93FA, 0xB5A3 },
+    { 0x64DA, 0x636E, 0x93FE, 0xBEDD }, { 0x64E0, 0x6324, 0x9444, 0xBCB7 }, { 0x64EC, 0x62DF, 0x944D, 0xC4E2 }, { 0x64F4, 0x6269, 0x9455, 0xC0A9 },
+    { 0x651D, 0x6444, 0x947A, 0xC9E3 }, { 0x6524, 0x644A, 0x9482, 0xCCAF }, { 0x6557, 0x8D25, 0x94A1, 0xB0DC }, { 0x6558, 0x53D9, 0x94A2, 0xD0F0 },
+    { 0x6575, 0x654C, 0x94B3, 0xB5D0 }, { 0x6578, 0x6570, 0x94B5, 0xCAFD }, { 0x6582, 0x655B, 0x94BF, 0xC1B2 }, { 0x65B7, 0x65AD, 0x94E0, 0xB6CF },
+    { 0x65BC, 0x4E8E, 0xECB6, 0xD3DA }, { 0x6642, 0x65F6, 0x9572, 0xCAB1 }, { 0x6688, 0x6655, 0x959E, 0xD4CE }, { 0x66AB, 0x6682, 0x95BA, 0xD4DD },
+    { 0x66C6, 0x5386, 0x95D1, 0xC0FA }, { 0x66C9, 0x6653, 0x95D4, 0xCFFE }, { 0x66EC, 0x6652, 0x95F1, 0xC9B9 }, { 0x66F8, 0x4E66, 0x95F8, 0xCAE9 },
+    { 0x6703, 0x4F1A, 0x95FE, 0xBBE1 }, { 0x6727, 0x80E7, 0x9656, 0xEBCA }, { 0x6771, 0x4E1C, 0x967C, 0xB6AB }, { 0x689D, 0x6761, 0x976C, 0xCCF5 },
+    { 0x68C4, 0x5F03, 0x9789, 0xC6FA }, { 0x68DF, 0x680B, 0x979D, 0xB6B0 }, { 0x694A, 0x6768, 0x97EE, 0xD1EE }, { 0x6975, 0x6781, 0x984F, 0xBCAB },
+    { 0x69AE, 0x8363, 0x9873, 0xC8D9 }, { 0x69CB, 0x6784, 0x988B, 0xB9B9 }, { 0x69CD, 0x67AA, 0x988C, 0xC7B9 }, { 0x6A01, 0x6869, 0x98B6, 0xD7AE },
+    { 0x6A02, 0x4E50, 0x98B7, 0xC0D6 }, { 0x6A13, 0x697C, 0x98C7, 0xC2A5 }, { 0x6A19, 0x6807, 0x98CB, 0xB1EA }, { 0x6A23, 0x6837, 0x98D3, 0xD1F9 },
+    { 0x6A4B, 0x6865, 0x98F2, 0xC7C5 }, { 0x6A5F, 0x673A, 0x9943, 0xBBFA }, { 0x6A6B, 0x6A2A, 0x994D, 0xBAE1 }, { 0x6AA2, 0x68C0, 0x997A, 0xBCEC },
+    { 0x6AC3, 0x67DC, 0x9999, 0xB9F1 }, { 0x6AFB, 0x6A31, 0x99D1, 0xD3A3 }, { 0x6B0A, 0x6743, 0x99E0, 0xC8A8 }, { 0x6B4E, 0x53F9, 0x9A55, 0xCCBE },
+    { 0x6B50, 0x6B27, 0x9A57, 0xC5B7 }, { 0x6B61, 0x6B22, 0x9A67, 0xBBB6 }, { 0x6B72, 0x5C81, 0x9A71, 0xCBEA }, { 0x6B77, 0x5386, 0x9A76, 0xC0FA },
+    { 0x6B78, 0x5F52, 0x9A77, 0xB9E9 }, { 0x6B98, 0x6B8B, 0x9A88, 0xB2D0 }, { 0x6BBA, 0x6740, 0x9AA2, 0xC9B1 }, { 0x6BBC, 0x58F3, 0x9AA4, 0xBFC7 },
+    { 0x6BC6, 0x6BB4, 0x9AAA, 0xC5B9 }, { 0x6C23, 0x6C14, 0x9AE2, 0xC6F8 }, { 0x6C2B, 0x6C22, 0x9AE4, 0xC7E2 }, { 0x6C7A, 0x51B3, 0x9B51, 0xBEF6 },
+    { 0x6C92, 0x6CA1, 0x9B5D, 0xC3BB }, { 0x6CC1, 0x51B5, 0x9B72, 0xBFF6 }, { 0x6DDA, 0x6CEA, 0x9C49, 0xC0E1 }, { 0x6DFA, 0x6D45, 0x9C5C, 0xC7B3 },
+    { 0x6E2C, 0x6D4B, 0x9C79, 0xB2E2 }, { 0x6E6F, 0x6C64, 0x9CAB, 0xCCC0 }, { 0x6E9D, 0x6C9F, 0x9CCF, 0xB9B5 }, { 0x6EAB, 0x6E29, 0x9CD8, 0xCEC2 },
+    { 0x6EC4, 0x6CA7, 0x9CE6, 0xB2D7 }, { 0x6EC5, 0x706D, 0x9CE7, 0xC3F0 }, { 0x6EEC, 0x6CAA, 0x9CFB, 0xBBA6 }, { 0x6EFE, 0x6EDA, 0x9D4C, 0xB9F6 },
+    { 0x6EFF, 0x6EE1, 0x9D4D, 0xC2FA }, { 0x6F01, 0x6E14, 0x9D4F, 0xD3E6 }, { 0x6F22, 0x6C49, 0x9D68, 0xBABA }, { 0x6F32, 0x6DA8, 0x9D71, 0xD5C7 },
+    { 0x6F54, 0x6D01, 0x9D8D, 0xBDE0 }, { 0x6F5B, 0x6F5C, 0x9D93, 0xC7B1 }, { 0x6F64, 0x6DA6, 0x9D99, 0xC8F3 }, { 0x6FA4, 0x6CFD, 0x9DC9, 0xD4F3 },
+    { 0x6FC3, 0x6D53, 0x9DE2, 0xC5A8 }, { 0x6FD5, 0x6E7F, 0x9DF1, 0xCAAA }, { 0x6FDF, 0x6D4E, 0x9DFA, 0xBCC3 }, { 0x6FE4, 0x6D9B, 0x9DFD, 0xCCCE },
+    { 0x6FF1, 0x6EE8, 0x9E49, 0xB1F5 }, { 0x700B, 0x6C88, 0x9E63, 0xC9F2 }, { 0x700F, 0x6D4F, 0x9E67, 0xE4AF }, { 0x7051, 0x6D12, 0x9EA2, 0xC8F7 },
+    { 0x7058, 0x6EE9, 0x9EA9, 0xCCB2 }, { 0x7063, 0x6E7E, 0x9EB3, 0xCDE5 }, { 0x707D, 0x707E, 0x9EC4, 0xD4D6 }, { 0x70BA, 0x4E3A, 0x9EE9, 0xCEAA },
+    { 0x70CF, 0x4E4C, 0x9EF5, 0xCEDA }, { 0x7121, 0x65E0, 0x9F6F, 0xCEDE }, { 0x7149, 0x70BC, 0x9F92, 0xC1B6 }, { 0x7152, 0x709C, 0x9F98, 0xECBF },
+    { 0x7159, 0x70DF, 0x9F9F, 0xD1CC }, { 0x71B1, 0x70ED, 0x9FE1, 0xC8C8 }, { 0x71C1, 0x70E8, 0x9FEE, 0xECC7 }, { 0x71C8, 0x706F, 0x9FF4, 0xB5C6 },
+    { 0x71D2, 0x70E7, 0x9FFD, 0xC9D5 }, { 0x71E6, 0x707F, 0xA04E, 0xB2D3 }, { 0x7210, 0x7089, 0xA074, 0xC2AF }, { 0x722D, 0x4E89, 0xA08E, 0xD5F9 },
+    { 0x723A, 0x7237, 0xA094, 0xD2AF }, { 0x723E, 0x5C14, 0xA096, 0xB6FB }, { 0x7246, 0x5899, 0xA09D, 0xC7BD }, { 0x727D, 0x7275, 0xA0BF, 0xC7A3 },
+    { 0x72A7, 0x727A, 0xA0DE, 0xCEFE }, { 0x72C0, 0x72B6, 0xA0EE, 0xD7B4 }, { 0x72F9, 0x72ED, 0xAA4D, 0xCFC1 }, { 0x7336, 0x72B9, 0xAA71, 0xD3CC },
+    { 0x7344, 0x72F1, 0xAA7A, 0xD3FC }, { 0x734E, 0x5956, 0xAA84, 0xBDB1 }, { 0x7368, 0x72EC, 0xAA9A, 0xB6C0 }, { 0x7372, 0x83B7, 0xAB40, 0xBBF1 },
+    { 0x7378, 0x517D, 0xAB46, 0xCADE }, { 0x73FE, 0x73B0, 0xAC46, 0xCFD6 }, { 0x744B, 0x73AE, 0xAC7C, 0xE7E2 }, { 0x7463, 0x7410, 0xAC8D, 0xCBF6 },
+    { 0x7469, 0x83B9, 0xAC93, 0xD3A8 }, { 0x746A, 0x739B, 0xAC94, 0xC2EA }, { 0x74B0, 0x73AF, 0xAD68, 0xBBB7 }, { 0x74BD, 0x73BA, 0xAD74, 0xE7F4 },
+    { 0x74CA, 0x743C, 0xAD82, 0xC7ED }, { 0x74CF, 0x73D1, 0xAD87, 0xE7E7 }, { 0x7522, 0x4EA7, 0xAE61, 0xB2FA }, { 0x755D, 0x4EA9, 0xAE80, 0xC4B6 },
+    { 0x7562, 0x6BD5, 0xAE85, 0xB1CF }, { 0x756B, 0x753B, 0xAE8B, 0xBBAD }, { 0x7570, 0x5F02, 0xAE90, 0xD2EC }, { 0x7576, 0x5F53, 0xAE94, 0xB5B1 },
+    { 0x758A, 0x53E0, 0xAF42, 0xB5FE }, { 0x760B, 0x75AF, 0xAF82, 0xB7E8 }, { 0x7642, 0x7597, 0xAF9F, 0xC1C6 }, { 0x7652, 0x6108, 0xB04B, 0xD3FA },
+    { 0x767C, 0x53D1, 0xB06C, 0xB7A2 }, { 0x76DC, 0x76D7, 0xB149, 0xB5C1 }, { 0x76DE, 0x76CF, 0xB14B, 0xD5B5 }, { 0x76E1, 0x5C3D, 0xB14D, 0xBEA1 },
+    { 0x76E3, 0x76D1, 0xB14F, 0xBCE0 }, { 0x76E4, 0x76D8, 0xB150, 0xC5CC }, { 0x76E7, 0x5362, 0xB152, 0xC2AC }, { 0x773E, 0x4F17, 0xB18A, 0xD6DA },
+    { 0x775C, 0x7741, 0xB1A0, 0xD5F6 }, { 0x77EF, 0x77EB, 0xB343, 0xBDC3 }, { 0x786F, 0x781A, 0xB38E, 0xD1E2 }, { 0x78BA, 0x786E, 0xB45F, 0xC8B7 },
+    { 0x78BC, 0x7801, 0xB461, 0xC2EB }, { 0x78DA, 0x7816, 0xB475, 0xD7A9 }, { 0x790E, 0x7840, 0xB541, 0xB4A1 }, { 0x7926, 0x77FF, 0xB556, 0xBFF3 },
+    { 0x797F, 0x7984, 0xB593, 0xC2BB }, { 0x798D, 0x7978, 0xB59C, 0xBBF6 }, { 0x79AA, 0x7985, 0xB655, 0xECF8 }, { 0x79AE, 0x793C, 0xB659, 0xC0F1 },
+    { 0x7A05, 0x7A0E, 0xB690, 0xCBB0 }, { 0x7A2E, 0x79CD, 0xB74E, 0xD6D6 }, { 0x7A31, 0x79F0, 0xB751, 0xB3C6 }, { 0x7A4D, 0x79EF, 0xB765, 0xBBFD },
+    { 0x7A4E, 0x9896, 0xB766, 0xD3B1 }, { 0x7A69, 0x7A33, 0xB780, 0xCEC8 }, { 0x7AA9, 0x7A9D, 0xB843, 0xCED1 }, { 0x7AAE, 0x7A77, 0xB846, 0xC7EE },
+    { 0x7ACA, 0x7A83, 0xB860, 0xC7D4 }, { 0x7AF6, 0x7ADE, 0xB882, 0xBEBA }, { 0x7B46, 0x7B14, 0xB950, 0xB1CA }, { 0x7B4D, 0x7B0B, 0xB953, 0xCBF1 },
+    { 0x7B8F, 0x7B5D, 0xB97E, 0xF3DD }, { 0x7BC0, 0x8282, 0xB99D, 0xBDDA }, { 0x7BC4, 0x8303, 0xB9A0, 0xB7B6 }, { 0x7BC9, 0x7B51, 0xBA42, 0xD6FE },
+    { 0x7BE4, 0x7B03, 0xBA56, 0xF3C6 }, { 0x7C21, 0x7B80, 0xBA86, 0xBCF2 }, { 0x7C3D, 0x7B7E, 0xBA9E, 0xC7A9 }, { 0x7C3E, 0x5E18, 0xBA9F, 0xC1B1 },
+    { 0x7C43, 0x7BEE, 0xBB40, 0xC0BA }, { 0x7C60, 0x7B3C, 0xBB5C, 0xC1FD }, { 0x7CE7, 0x7CAE, 0xBC5A, 0xC1B8 }, { 0x7CFE, 0x7EA0, 0xBC6D, 0xBEC0 },
+    { 0x7D00, 0x7EAA, 0xBC6F, 0xBCCD }, { 0x7D04, 0x7EA6, 0xBC73, 0xD4BC }, { 0x7D05, 0x7EA2, 0xBC74, 0xBAEC }, { 0x7D0B, 0x7EB9, 0xBC79, 0xCEC6 },
+    { 0x7D10, 0x7EBD, 0xBC7E, 0xC5A6 }, { 0x7D14, 0x7EAF, 0xBC83, 0xB4BF }, { 0x7D17, 0x7EB1, 0xBC86, 0xC9B4 }, { 0x7D19, 0x7EB8, 0xBC88, 0xD6BD },
+    { 0x7D1A, 0x7EA7, 0xBC89, 0xBCB6 }, { 0x7D1B, 0x7EB7, 0xBC8A, 0xB7D7 }, { 0x7D21, 0x7EBA, 0xBC8F, 0xB7C4 }, { 0x7D30, 0x7EC6, 0xBC9A, 0xCFB8 },
+    { 0x7D39, 0x7ECD, 0xBD42, 0xC9DC }, { 0x7D42, 0x7EC8, 0xBD4B, 0xD6D5 }, { 0x7D44, 0x7EC4, 0xBD4D, 0xD7E9 }, { 0x7D50, 0x7ED3, 0xBD59, 0xBDE1 },
+    { 0x7D55, 0x7EDD, 0xBD5E, 0xBEF8 }, { 0x7D61, 0x7EDC, 0xBD6A, 0xC2E7 }, { 0x7D66, 0x7ED9, 0xBD6F, 0xB8F8 }, { 0x7D68, 0x7ED2, 0xBD71, 0xC8DE },
+    { 0x7D71, 0x7EDF, 0xBD79, 0xCDB3 }, { 0x7D72, 0x4E1D, 0xBD7A, 0xCBBF }, { 0x7D81, 0x7ED1, 0xBD89, 0xB0F3 }, { 0x7D93, 0x7ECF, 0xBD9B, 0xBEAD },
+    { 0x7D9C, 0x7EFC, 0xBE43, 0xD7DB }, { 0x7DA0, 0x7EFF, 0xBE47, 0xC2CC }, { 0x7DAD, 0x7EF4, 0xBE53, 0xCEAC }, { 0x7DB1, 0x7EB2, 0xBE56, 0xB8D9 },
+    { 0x7DB2, 0x7F51, 0xBE57, 0xCDF8 }, { 0x7DBA, 0x7EEE, 0xBE5F, 0xE7B2 }, { 0x7DBF, 0x7EF5, 0xBE64, 0xC3E0 }, { 0x7DCA, 0x7D27, 0xBE6F, 0xBDF4 },
+    { 0x7DD2, 0x7EEA, 0xBE77, 0xD0F7 }, { 0x7DDA, 0x7EBF, 0xBE80, 0xCFDF }, { 0x7DE3, 0x7F18, 0xBE89, 0xD4B5 }, { 0x7DE8, 0x7F16, 0xBE8E, 0xB1E0 },
+    { 0x7DE9, 0x7F13, 0xBE8F, 0xBBBA }, { 0x7DF4, 0x7EC3, 0xBE9A, 0xC1B7 }, { 0x7DFB, 0x81F4, 0xBF40, 0xD6C2 }, { 0x7E23, 0x53BF, 0xBF68, 0xCFD8 },
+    { 0x7E2E, 0x7F29, 0xBF73, 0xCBF5 }, { 0x7E31, 0x7EB5, 0xBF76, 0xD7DD }, { 0x7E3D, 0x603B, 0xBF82, 0xD7DC }, { 0x7E54, 0x7EC7, 0xBF97, 0xD6AF },
+    { 0x7E5E, 0x7ED5, 0xC040, 0xC8C6 }, { 0x7E61, 0x7EE3, 0xC043, 0xD0E5 }, { 0x7E69, 0x7EF3, 0xC04B, 0xC9FE }, { 0x7E6A, 0x7ED8, 0xC04C, 0xBBE6 },
+    { 0x7E6B, 0x7CFB, 0xC04D, 0xCFB5 }, { 0x7E7C, 0x7EE7, 0xC05E, 0xBCCC }, { 0x7E7D, 0x7F24, 0xC05F, 0xE7CD }, { 0x7E8C, 0x7EED, 0xC06D, 0xD0F8 },
+    { 0x7E8F, 0x7F20, 0xC070, 0xB2F8 }, { 0x7F70, 0x7F5A, 0xC150, 0xB7A3 }, { 0x7F75, 0x9A82, 0xC152, 0xC2EE }, { 0x7F77, 0x7F62, 0xC154, 0xB0D5 },
+    { 0x7F85, 0x7F57, 0xC15F, 0xC2DE }, { 0x7FA9, 0x4E49, 0xC178, 0xD2E5 }, { 0x7FD2, 0x4E60, 0xC195, 0xCFB0 }, { 0x7FF9, 0x7FD8, 0xC24E, 0xC7CC },
+    { 0x8056, 0x5723, 0xC27D, 0xCAA5 }, { 0x805E, 0x95FB, 0xC284, 0xCEC5 }, { 0x806F, 0x8054, 0xC293, 0xC1AA }, { 0x8070, 0x806A, 0xC294, 0xB4CF },
+    { 0x8072, 0x58F0, 0xC295, 0xC9F9 }, { 0x8073, 0x8038, 0xC296, 0xCBCA }, { 0x8076, 0x8042, 0xC299, 0xC4F4 }, { 0x8077, 0x804C, 0xC29A, 0xD6B0 },
+    { 0x807D, 0x542C, 0xC2A0, 0xCCFD }, { 0x8085, 0x8083, 0xC343, 0xCBE0 }, { 0x8105, 0x80C1, 0xC37B, 0xD0B2 }, { 0x8108, 0x8109, 0xC37D, 0xC2F6 },
+    { 0x812B, 0x8131, 0xC393, 0xCDD1 }, { 0x814E, 0x80BE, 0xC449, 0xC9F6 }, { 0x8166, 0x8111, 0xC458, 0xC4D4 }, { 0x819A, 0x80A4, 0xC477, 0xB7F4 },
+    { 0x81BD, 0x80C6, 0xC491, 0xB5A8 }, { 0x81C9, 0x8138, 0xC498, 0xC1B3 }, { 0x81D8, 0x814A, 0xC544, 0xC0B0 }, { 0x81E8, 0x4E34, 0xC552, 0xC1D9 },
+    { 0x81FA, 0x53F0, 0xC55F, 0xCCA8 }, { 0x8207, 0x4E0E, 0xC563, 0xD3EB }, { 0x8208, 0x5174, 0xC564, 0xD0CB }, { 0x8209, 0x4E3E, 0xC565, 0xBED9 },
+    { 0x820A, 0x65E7, 0xC566, 0xBEC9 }, { 0x8259, 0x8231, 0xC593, 0xB2D5 }, { 0x8266, 0x8230, 0xC59E, 0xBDA2 }, { 0x8271, 0x8270, 0xC644, 0xBCE8 },
+    { 0x838A, 0x5E84, 0xC766, 0xD7AF }, { 0x8396, 0x830E, 0xC76F, 0xBEA5 }, { 0x83A2, 0x835A, 0xC776, 0xBCD4 }, { 0x83EF, 0x534E, 0xC841, 0xBBAA },
+    { 0x840A, 0x83B1, 0xC852, 0xC0B3 }, { 0x842C, 0x4E07, 0xC866, 0xCDF2 }, { 0x8449, 0x53F6, 0xC87E, 0xD2B6 }, { 0x8466, 0x82C7, 0xC894, 0xCEAD },
+    { 0x84CB, 0x76D6, 0xC977, 0xB8C7 }, { 0x84EE, 0x83B2, 0xC98F, 0xC1AB }, { 0x8514, 0x535C, 0xCA4E, 0xB2B7 }, { 0x8523, 0x848B, 0xCA59, 0xBDAF },
+    { 0x856D, 0x8427, 0xCA92, 0xCFF4 }, { 0x8588, 0x835F, 0xCB43, 0xDCF6 }, { 0x85A6, 0x8350, 0xCB5D, 0xBCF6 }, { 0x85A9, 0x8428, 0xCB5F, 0xC8F8 },
+    { 0x85CD, 0x84DD, 0xCB7B, 0xC0B6 }, { 0x85DD, 0x827A, 0xCB87, 0xD2D5 }, { 0x85E5, 0x836F, 0xCB8E, 0xD2A9 }, { 0x8606, 0x82A6, 0xCC4A, 0xC2AB },
+    { 0x8607, 0x82CF, 0xCC4B, 0xCBD5 }, { 0x860B, 0x82F9, 0xCC4F, 0xC6BB }, { 0x862D, 0x5170, 0xCC6D, 0xC0BC }, { 0x8655, 0x5904, 0xCC8E, 0xB4A6 },
+    { 0x865B, 0x865A, 0xCC93, 0xD0E9 }, { 0x865F, 0x53F7, 0xCC96, 0xBAC5 }, { 0x8766, 0x867E, 0xCE72, 0xCFBA }, { 0x87F2, 0x866B, 0xCF78, 0xB3E6 },
+    { 0x881F, 0x8721, 0xCF9E, 0xC0AF }, { 0x8836, 0x8695, 0xD051, 0xB2CF }, { 0x8853, 0x672F, 0xD067, 0xCAF5 }, { 0x885B, 0x536B, 0xD06C, 0xCEC0 },
+    { 0x885D, 0x51B2, 0xD06E, 0xB3E5 }, { 0x88CF, 0x91CC, 0xD159, 0xC0EF }, { 0x88DC, 0x8865, 0xD161, 0xB2B9 }, { 0x88DD, 0x88C5, 0xD162, 0xD7B0 },
+    { 0x88E1, 0x91CC, 0xD165, 0xC0EF }, { 0x88FD, 0x5236, 0xD175, 0xD6C6 }, { 0x8907, 0x590D, 0xD17D, 0xB8B4 }, { 0x8932, 0x88E4, 0xD19D, 0xBFE3 },
+    { 0x896F, 0x886C, 0xD272, 0xB3C4 }, { 0x8972, 0x88AD, 0xD275, 0xCFAE }, { 0x898B, 0x89C1, 0xD28A, 0xBCFB }, { 0x898F, 0x89C4, 0xD28E, 0xB9E6 },
+    { 0x8996, 0x89C6, 0xD295, 0xCAD3 }, { 0x89AA, 0x4EB2, 0xD348, 0xC7D7 }, { 0x89BA, 0x89C9, 0xD358, 0xBEF5 }, { 0x89BD, 0x89C8, 0xD35B, 0xC0C0 },
+    { 0x89C0, 0x89C2, 0xD35E, 0xB9DB }, { 0x8A02, 0x8BA2, 0xD386, 0xB6A9 }, { 0x8A08, 0x8BA1, 0xD38B, 0xBCC6 }, { 0x8A0A, 0x8BAF, 0xD38D, 0xD1B6 },
+    { 0x8A13, 0x8BAD, 0xD396, 0xD1B5 }, { 0x8A17, 0x6258, 0xD39A, 0xCDD0 }, { 0x8A18, 0x8BB0, 0xD39B, 0xBCC7 }, { 0x8A2A, 0x8BBF, 0xD44C, 0xB7C3 },
+    { 0x8A2D, 0x8BBE, 0xD44F, 0xC9E8 }, { 0x8A31, 0x8BB8, 0xD453, 0xD0ED }, { 0x8A3B, 0x6CE8, 0xD45D, 0xD7A2 }, { 0x8A55, 0x8BC4, 0xD475, 0xC6C0 },
+    { 0x8A5E, 0x8BCD, 0xD47E, 0xB4CA }, { 0x8A62, 0x8BE2, 0xD483, 0xD1AF }, { 0x8A66, 0x8BD5, 0xD487, 0xCAD4 }, { 0x8A69, 0x8BD7, 0xD48A, 0xCAAB },
+    { 0x8A71, 0x8BDD, 0xD492, 0xBBB0 }, { 0x8A72, 0x8BE5, 0xD493, 0xB8C3 }, { 0x8A73, 0x8BE6, 0xD494, 0xCFEA }, { 0x8A87, 0x5938, 0xD546, 0xBFE4 },
+    { 0x8A8C, 0x5FD7, 0xD549, 0xD6BE }, { 0x8A8D, 0x8BA4, 0xD54A, 0xC8CF }, { 0x8A95, 0x8BDE, 0xD551, 0xB5AE }, { 0x8A98, 0x8BF1, 0xD554, 0xD3D5 },
+    { 0x8A9E, 0x8BED, 0xD55A, 0xD3EF }, { 0x8AA0, 0x8BDA, 0xD55C, 0xB3CF }, { 0x8AA4, 0x8BEF, 0xD560, 0xCEF3 }, { 0x8AAA, 0x8BF4, 0xD566, 0xCBB5 },
+    { 0x8AB0, 0x8C01, 0xD56C, 0xCBAD }, { 0x8AB2, 0x8BFE, 0xD56E, 0xBFCE }, { 0x8ABC, 0x8C0A, 0xD578, 0xD2EA }, { 0x8ABF, 0x8C03, 0xD57B, 0xB5F7 },
+    { 0x8AC7, 0x8C08, 0xD584, 0xCCB8 }, { 0x8ACB, 0x8BF7, 0xD588, 0xC7EB }, { 0x8AD2, 0x8C05, 0xD58F, 0xC1C2 }, { 0x8AD6, 0x8BBA, 0xD593, 0xC2DB },
+    { 0x8AF8, 0x8BF8, 0xD654, 0xD6EE }, { 0x8AFE, 0x8BFA, 0xD65A, 0xC5B5 }, { 0x8B00, 0x8C0B, 0xD65C, 0xC4B1 }, { 0x8B0E, 0x8C1C, 0xD669, 0xC3D5 },
+    { 0x8B19, 0x8C26, 0xD674, 0xC7AB }, { 0x8B1B, 0x8BB2, 0xD676, 0xBDB2 }, { 0x8B1D, 0x8C22, 0xD678, 0xD0BB }, { 0x8B39, 0x8C28, 0xD694, 0xBDF7 },
+    { 0x8B49, 0x8BC1, 0xD743, 0xD6A4 }, { 0x8B58, 0x8BC6, 0xD752, 0xCAB6 }, { 0x8B5A, 0x8C2D, 0xD754, 0xCCB7 }, { 0x8B5C, 0x8C31, 0xD756, 0xC6D7 },
+    { 0x8B6F, 0x8BD1, 0xD767, 0xD2EB }, { 0x8B70, 0x8BAE, 0xD768, 0xD2E9 }, { 0x8B77, 0x62A4, 0xD76F, 0xBBA4 }, { 0x8B7D, 0x8A89, 0xD775, 0xD3FE },
+    { 0x8B80, 0x8BFB, 0xD778, 0xB6C1 }, { 0x8B8A, 0x53D8, 0xD783, 0xB1E4 }, { 0x8B93, 0x8BA9, 0xD78C, 0xC8C3 }, { 0x8B9A, 0x8D5E, 0xD793, 0xD4DE },
+    { 0x8C50, 0x4E30, 0xD853, 0xB7E1 }, { 0x8C6C, 0x732A, 0xD869, 0xD6ED }, { 0x8C93, 0x732B, 0xD888, 0xC3A8 }, { 0x8C9D, 0x8D1D, 0xD890, 0xB1B4 },
+    { 0x8C9E, 0x8D1E, 0xD891, 0xD5EA }, { 0x8CA0, 0x8D1F, 0xD893, 0xB8BA }, { 0x8CA1, 0x8D22, 0xD894, 0xB2C6 }, { 0x8CA2, 0x8D21, 0xD895, 0xB9B1 },
+    { 0x8CA8, 0x8D27, 0xD89B, 0xBBF5 }, { 0x8CA9, 0x8D29, 0xD89C, 0xB7B7 }, { 0x8CAA, 0x8D2A, 0xD89D, 0xCCB0 }, { 0x8CAB, 0x8D2F, 0xD89E, 0xB9E1 },
+    { 0x8CB4, 0x8D35, 0xD946, 0xB9F3 }, { 0x8CB7, 0x4E70, 0xD949, 0xC2F2 }, { 0x8CBB, 0x8D39, 0xD94D, 0xB7D1 }, { 0x8CBC, 0x8D34, 0xD94E, 0xCCF9 },
+    { 0x8CC0, 0x8D3A, 0xD952, 0xBAD8 }, { 0x8CC7, 0x8D44, 0xD959, 0xD7CA }, { 0x8CC8, 0x8D3E, 0xD95A, 0xBCD6 }, { 0x8CCA, 0x8D3C, 0xD95C, 0xD4F4 },
+    { 0x8CD3, 0x5BBE, 0xD965, 0xB1F6 }, { 0x8CDC, 0x8D50, 0xD96E, 0xB4CD }, { 0x8CDE, 0x8D4F, 0xD970, 0xC9CD }, { 0x8CE0, 0x8D54, 0xD972, 0xC5E2 },
+    { 0x8CE2, 0x8D24, 0xD974, 0xCFCD }, { 0x8CE3, 0x5356, 0xD975, 0xC2F4 }, { 0x8CE6, 0x8D4B, 0xD978, 0xB8B3 }, { 0x8CEA, 0x8D28, 0xD97C, 0xD6CA },
+    { 0x8CF4, 0x8D56, 0xD987, 0xC0B5 }, { 0x8CFA, 0x8D5A, 0xD98D, 0xD7AC }, { 0x8CFC, 0x8D2D, 0xD98F, 0xB9BA }, { 0x8CFD, 0x8D5B, 0xD990, 0xC8FC },
+    { 0x8D08, 0x8D60, 0xD99B, 0xD4F9 }, { 0x8D0A, 0x8D5E, 0xD99D, 0xD4DE }, { 0x8D0F, 0x8D62, 0xDA41, 0xD3AE }, { 0x8D95, 0x8D76, 0xDA73, 0xB8CF },
+    { 0x8D99, 0x8D75, 0xDA77, 0xD5D4 }, { 0x8DA8, 0x8D8B, 0xDA85, 0xC7F7 }, { 0x8DE1, 0x8FF9, 0xDB45, 0xBCA3 }, { 0x8E10, 0x8DF5, 0xDB60, 0xBCF9 },
+    { 0x8E5F, 0x8FF9, 0xDB94, 0xBCA3 }, { 0x8E64, 0x8E2A, 0xDB99, 0xD7D9 }, { 0x8E8D, 0x8DC3, 0xDC53, 0xD4BE }, { 0x8ECA, 0x8F66, 0xDC87, 0xB3B5 },
+    { 0x8ECC, 0x8F68, 0xDC89, 0xB9EC }, { 0x8ECD, 0x519B, 0xDC8A, 0xBEFC }, { 0x8ED2, 0x8F69, 0xDC8E, 0xD0F9 }, { 0x8EDF, 0x8F6F, 0xDC9B, 0xC8ED },
+    { 0x8F03, 0x8F83, 0xDD5E, 0xBDCF }, { 0x8F09, 0x8F7D, 0xDD64, 0xD4D8 }, { 0x8F14, 0x8F85, 0xDD6F, 0xB8A8 }, { 0x8F15, 0x8F7B, 0xDD70, 0xC7E1 },
+    { 0x8F1D, 0x8F89, 0xDD78, 0xBBD4 }, { 0x8F29, 0x8F88, 0xDD85, 0xB1B2 }, { 0x8F2A, 0x8F6E, 0xDD86, 0xC2D6 }, { 0x8F2F, 0x8F91, 0xDD8B, 0xBCAD },
+    { 0x8F38, 0x8F93, 0xDD94, 0xCAE4 }, { 0x8F49, 0x8F6C, 0xDE44, 0xD7AA }, { 0x8F5F, 0x8F70, 0xDE5A, 0xBAE4 }, { 0x8FA6, 0x529E, 0xDE6B, 0xB0EC },
+    { 0x8FAD, 0x8F9E, 0xDE6F, 0xB4C7 }, { 0x8FAF, 0x8FA9, 0xDE71, 0xB1E7 }, { 0x8FB2, 0x519C, 0xDE72, 0xC5A9 }, { 0x9019, 0x8FD9, 0xDF40, 0xD5E2 },
+    { 0x9023, 0x8FDE, 0xDF42, 0xC1AC }, { 0x9031, 0x5468, 0xDF4C, 0xD6DC }, { 0x9032, 0x8FDB, 0xDF4D, 0xBDF8 }, { 0x904A, 0x6E38, 0xDF5B, 0xD3CE },
+    { 0x904B, 0x8FD0, 0xDF5C, 0xD4CB }, { 0x904E, 0x8FC7, 0xDF5E, 0xB9FD }, { 0x9054, 0x8FBE, 0xDF5F, 0xB4EF }, { 0x905E, 0x9012, 0xDF66, 0xB5DD },
+    { 0x9060, 0x8FDC, 0xDF68, 0xD4B6 }, { 0x9069, 0x9002, 0xDF6D, 0xCACA }, { 0x9072, 0x8FDF, 0xDF74, 0xB3D9 }, { 0x9077, 0x8FC1, 0xDF77, 0xC7A8 },
+    { 0x9078, 0x9009, 0xDF78, 0xD1A1 }, { 0x907A, 0x9057, 0xDF7A, 0xD2C5 }, { 0x907C, 0x8FBD, 0xDF7C, 0xC1C9 }, { 0x9081, 0x8FC8, 0xDF7E, 0xC2F5 },
+    { 0x9084, 0x8FD8, 0xDF80, 0xBBB9 }, { 0x908A, 0x8FB9, 0xDF85, 0xB1DF }, { 0x908F, 0x903B, 0xDF89, 0xC2DF }, { 0x90F5, 0x90AE, 0xE05D, 0xD3CA },
+    { 0x9109, 0x4E61, 0xE06C, 0xCFE7 }, { 0x9112, 0x90B9, 0xE075, 0xD7DE }, { 0x9114, 0x90AC, 0xE077, 0xDAF9 }, { 0x9127, 0x9093, 0xE087, 0xB5CB },
+    { 0x912D, 0x90D1, 0xE08D, 0xD6A3 }, { 0x913A, 0x909D, 0xE097, 0xDAF7 }, { 0x919C, 0x4E11, 0xE168, 0xB3F3 }, { 0x919E, 0x915D, 0xE16A, 0xD4CD },
+    { 0x91AB, 0x533B, 0xE174, 0xD2BD }, { 0x91C0, 0x917F, 0xE184, 0xC4F0 }, { 0x91CB, 0x91CA, 0xE18C, 0xCACD }, { 0x91D8, 0x9489, 0xE194, 0xB6A4 },
+    { 0x91DD, 0x9488, 0xE198, 0xD5EB }, { 0x91E3, 0x9493, 0xE19E, 0xB5F6 }, { 0x9214, 0x949E, 0xE26E, 0xB3AE }, { 0x921E, 0x94A7, 0xE278, 0xBEFB },
+    { 0x9223, 0x9499, 0xE27D, 0xB8C6 }, { 0x9234, 0x94C3, 0xE28F, 0xC1E5 }, { 0x925B, 0x94C5, 0xE355, 0xC7A6 }, { 0x9264, 0x94A9, 0xE35E, 0xB9B3 },
+    { 0x9280, 0x94F6, 0xE379, 0xD2F8 }, { 0x9285, 0x94DC, 0xE37E, 0xCDAD }, { 0x9298, 0x94ED, 0xE391, 0xC3FA }, { 0x92B3, 0x9510, 0xE44A, 0xC8F1 },
+    { 0x92B7, 0x9500, 0xE44E, 0xCFFA }, { 0x92C1, 0x94DD, 0xE458, 0xC2C1 }, { 0x92C5, 0x950C, 0xE45C, 0xD0BF }, { 0x92D2, 0x950B, 0xE468, 0xB7E6 },
+    { 0x92EA, 0x94FA, 0xE481, 0xC6CC }, { 0x92FC, 0x94A2, 0xE493, 0xB8D6 }, { 0x9304, 0x5F55, 0xE49B, 0xC2BC }, { 0x9322, 0x94B1, 0xE558, 0xC7AE },
+    { 0x9326, 0x9526, 0xE55C, 0xBDF5 }, { 0x932B, 0x9521, 0xE561, 0xCEFD }, { 0x932F, 0x9519, 0xE565, 0xB4ED }, { 0x9336, 0x8868, 0xE56C, 0xB1ED },
+    { 0x934A, 0x70BC, 0xE580, 0xC1B6 }, { 0x934B, 0x9505, 0xE581, 0xB9F8 }, { 0x935B, 0x953B, 0xE591, 0xB6CD }, { 0x9375, 0x952E, 0xE649, 0xBCFC },
+    { 0x937E, 0x949F, 0xE652, 0xD6D3 }, { 0x9382, 0x9541, 0xE656, 0xC3BE }, { 0x9396, 0x9501, 0xE669, 0xCBF8 }, { 0x93AE, 0x9547, 0xE682, 0xD5F2 },
+    { 0x93C8, 0x94FE, 0xE69C, 0xC1B4 }, { 0x93E1, 0x955C, 0xE752, 0xBEB5 }, { 0x9418, 0x949F, 0xE78A, 0xD6D3 }, { 0x9435, 0x94C1, 0xE846, 0xCCFA },
+    { 0x9438, 0x94CE, 0xE849, 0xEEEC }, { 0x9444, 0x94F8, 0xE854, 0xD6FD }, { 0x9452, 0x9274, 0xE862, 0xBCF8 }, { 0x9470, 0x94A5, 0xE880, 0xD4BF },
+    { 0x947C, 0x9523, 0xE88C, 0xC2E0 }, { 0x947D, 0x94BB, 0xE88D, 0xD7EA }, { 0x9577, 0x957F, 0xE94C, 0xB3A4 }, { 0x9580, 0x95E8, 0xE954, 0xC3C5 },
+    { 0x9583, 0x95EA, 0xE957, 0xC9C1 }, { 0x9586, 0x95EB, 0xE95A, 0xE3C6 }, { 0x9589, 0x95ED, 0xE95D, 0xB1D5 }, { 0x958B, 0x5F00, 0xE95F, 0xBFAA },
+    { 0x9592, 0x95F2, 0xE966, 0xCFD0 }, { 0x9593, 0x95F4, 0xE967, 0xBCE4 }, { 0x9598, 0x95F8, 0xE96C, 0xD5A2 }, { 0x95A3, 0x9601, 0xE977, 0xB8F3 },
+    { 0x95A9, 0x95FD, 0xE97D, 0xC3F6 }, { 0x95B1, 0x9605, 0xE986, 0xD4C4 }, { 0x95BB, 0x960E, 0xE990, 0xD1D6 }, { 0x95C6, 0x677F, 0xE99B, 0xB0E5 },
+    { 0x95CA, 0x9614, 0xE99F, 0xC0AB }, { 0x95D6, 0x95EF, 0xEA4A, 0xB4B3 }, { 0x95DC, 0x5173, 0xEA50, 0xB9D8 }, { 0x9663, 0x9635, 0xEA87, 0xD5F3 },
+    { 0x9670, 0x9634, 0xEA8E, 0xD2F5 }, { 0x9673, 0x9648, 0xEA90, 0xB3C2 }, { 0x9678, 0x9646, 0xEA91, 0xC2BD }, { 0x967D, 0x9633, 0xEA96, 0xD1F4 },
+    { 0x968A, 0x961F, 0xEAA0, 0xB6D3 }, { 0x968E, 0x9636, 0xEB41, 0xBDD7 }, { 0x969B, 0x9645, 0xEB48, 0xBCCA }, { 0x96A8, 0x968F, 0xEB53, 0xCBE6 },
+    { 0x96AA, 0x9669, 0xEB55, 0xCFD5 }, { 0x96B1, 0x9690, 0xEB5B, 0xD2FE }, { 0x96B8, 0x96B6, 0xEB60, 0xC1A5 }, { 0x96BB, 0x53EA, 0xEB62, 0xD6BB },
+    { 0x96D6, 0x867D, 0xEB6D, 0xCBE4 }, { 0x96D9, 0x53CC, 0xEB70, 0xCBAB }, { 0x96DC, 0x6742, 0xEB73, 0xD4D3 }, { 0x96DE, 0x9E21, 0xEB75, 0xBCA6 },
+    { 0x96E2, 0x79BB, 0xEB78, 0xC0EB }, { 0x96E3, 0x96BE, 0xEB79, 0xC4D1 }, { 0x96F2, 0x4E91, 0xEB85, 0xD4C6 }, { 0x96FB, 0x7535, 0xEB8A, 0xB5E7 },
+    { 0x9727, 0x96FE, 0xEC46, 0xCEED }, { 0x9748, 0x7075, 0xEC60, 0xC1E9 }, { 0x975C, 0x9759, 0xEC6F, 0xBEB2 }, { 0x97CB, 0x97E6, 0xED66, 0xCEA4 },
+    { 0x97D3, 0x97E9, 0xED6E, 0xBAAB }, { 0x97FF, 0x54CD, 0xED91, 0xCFEC }, { 0x9801, 0x9875, 0xED93, 0xD2B3 }, { 0x9802, 0x9876, 0xED94, 0xB6A5 },
+    { 0x9805, 0x9879, 0xED97, 0xCFEE }, { 0x9806, 0x987A, 0xED98, 0xCBB3 }, { 0x9808, 0x987B, 0xED9A, 0xD0EB }, { 0x980C, 0x9882, 0xED9E, 0xCBCC },
+    { 0x9810, 0x9884, 0xEE41, 0xD4A4 }, { 0x9813, 0x987F, 0xEE44, 0xB6D9 }, { 0x9818, 0x9886, 0xEE49, 0xC1EC }, { 0x9824, 0x9890, 0xEE55, 0xD2C3 },
+    { 0x982D, 0x5934, 0xEE5E, 0xCDB7 }, { 0x983B, 0x9891, 0xEE6C, 0xC6B5 }, { 0x9846, 0x9897, 0xEE77, 0xBFC5 }, { 0x984C, 0x9898, 0xEE7D, 0xCCE2 },
+    { 0x984D, 0x989D, 0xEE7E, 0xB6EE }, { 0x984F, 0x989C, 0xEE81, 0xD1D5 }, { 0x9858, 0x613F, 0xEE8A, 0xD4B8 }, { 0x985B, 0x98A0, 0xEE8D, 0xB5DF },
+    { 0x985E, 0x7C7B, 0xEE90, 0xC0E0 }, { 0x9867, 0x987E, 0xEE99, 0xB9CB }, { 0x986F, 0x663E, 0xEF40, 0xCFD4 }, { 0x98A8, 0x98CE, 0xEF4C, 0xB7E7 },
+    { 0x98B1, 0x53F0, 0xEF55, 0xCCA8 }, { 0x98B3, 0x522E, 0xEF57, 0xB9CE }, { 0x98C4, 0x98D8, 0xEF68, 0xC6AE }, { 0x98DB, 0x98DE, 0xEF77, 0xB7C9 },
+    { 0x98EF, 0x996D, 0xEF88, 0xB7B9 }, { 0x98FC, 0x9972, 0xEF95, 0xCBC7 }, { 0x98FD, 0x9971, 0xEF96, 0xB1A5 }, { 0x9905, 0x997C, 0xEF9E, 0xB1FD },
+    { 0x990A, 0x517B, 0xF042, 0xD1F8 }, { 0x9918, 0x4F59, 0xF04E, 0xD3E0 }, { 0x9928, 0x9986, 0xF05E, 0xB9DD }, { 0x9935, 0x5582, 0xF06A, 0xCEB9 },
+    { 0x9951, 0x9965, 0xF087, 0xBCA2 }, { 0x99AC, 0x9A6C, 0xF152, 0xC2ED }, { 0x99AE, 0x51AF, 0xF154, 0xB7EB }, { 0x99D0, 0x9A7B, 0xF176, 0xD7A4 },
+    { 0x99D5, 0x9A7E, 0xF17B, 0xBCDD }, { 0x99DB, 0x9A76, 0xF182, 0xCABB }, { 0x99F1, 0x9A86, 0xF198, 0xC2E6 }, { 0x9A0E, 0x9A91, 0xF254, 0xC6EF },
+    { 0x9A30, 0x817E, 0xF276, 0xCCDA }, { 0x9A45, 0x9A71, 0xF28C, 0xC7FD }, { 0x9A55, 0x9A84, 0xF29C, 0xBDBE }, { 0x9A57, 0x9A8C, 0xF29E, 0xD1E9 },
+    { 0x9A5A, 0x60CA, 0xF340, 0xBEAA }, { 0x9A62, 0x9A74, 0xF348, 0xC2BF }, { 0x9AD4, 0x4F53, 0xF377, 0xCCE5 }, { 0x9AEE, 0x53D1, 0xF38C, 0xB7A2 },
+    { 0x9B06, 0x677E, 0xF3A0, 0xCBC9 }, { 0x9B25, 0x6597, 0xF459, 0xB6B7 }, { 0x9B27, 0x95F9, 0xF45B, 0xC4D6 }, { 0x9B5A, 0x9C7C, 0xF47E, 0xD3E3 },
+    { 0x9B6F, 0x9C81, 0xF494, 0xC2B3 }, { 0x9BAE, 0x9C9C, 0xF572, 0xCFCA }, { 0x9BE8, 0x9CB8, 0xF64C, 0xBEA8 }, { 0x9CE5, 0x9E1F, 0xF842, 0xC4F1 },
+    { 0x9CF3, 0x51E4, 0xF850, 0xB7EF }, { 0x9CF4, 0x9E23, 0xF851, 0xC3F9 }, { 0x9D28, 0x9E2D, 0xF886, 0xD1BC }, { 0x9D3B, 0x9E3F, 0xF899, 0xBAE8 },
+    { 0x9D5D, 0x9E45, 0xF95A, 0xB6EC }, { 0x9D6C, 0x9E4F, 0xF969, 0xC5F4 }, { 0x9DB4, 0x9E64, 0xFA51, 0xBAD7 }, { 0x9DD7, 0x9E25, 0xFA74, 0xC5B8 },
+    { 0x9DF9, 0x9E70, 0xFA97, 0xD3A5 }, { 0x9E7D, 0x76D0, 0xFB7D, 0xD1CE }, { 0x9E97, 0x4E3D, 0xFB90, 0xC0F6 }, { 0x9EA5, 0x9EA6, 0xFB9C, 0xC2F3 },
+    { 0x9EB5, 0x9762, 0xFC49, 0xC3E6 }, { 0x9EBC, 0x4E48, 0xFC4E, 0xC3B4 }, { 0x9EC3, 0x9EC4, 0xFC53, 0xBBC6 }, { 0x9EDE, 0x70B9, 0xFC63, 0xB5E3 },
+    { 0x9EE8, 0x515A, 0xFC68, 0xB5B3 }, { 0x9EF4, 0x9709, 0xFC71, 0xC3B9 }, { 0x9F4A, 0x9F50, 0xFD52, 0xC6EB }, { 0x9F4B, 0x658B, 0xFD53, 0xD5AB },
+    { 0x9F52, 0x9F7F, 0xFD58, 0xB3DD }, { 0x9F61, 0x9F84, 0xFD67, 0xC1E4 }, { 0x9F8D, 0x9F99, 0xFD88, 0xC1FA }, { 0x9F90, 0x5E9E, 0xFD8B, 0xC5D3 },
+    { 0x9F94, 0x9F9A, 0xFD8F, 0xB9A8 }, { 0x9F9C, 0x9F9F, 0xFD94, 0xB9EA },
+};
+
+// ֲ֣λͼųַʱж
+class FoldTable {
+private:
+    std::bitset<0x10000> present;
+    std::vector<std::pair<uint16_t, uint16_t>> pairs;
+
+public:
+    template <typename Key>
+    FoldTable(Key key) {
+        for (const FoldPair& pair : foldPairs) {
+            auto entry = key(pair);
+            present.set(entry.first);
+            pairs.push_back(entry);
+        }
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    uint32_t find(uint32_t code) const {
+        if (code > 0xFFFF || !present.test(code)) return 0;
+        auto it = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(static_cast<uint16_t>(code), uint16_t(0)));
+        return it->second;
+    }
+};
+
+const FoldTable& unicodeFolds() {
+    static const FoldTable table([](const FoldPair& pair) { return std::make_pair(pair.traditional, pair.simplified); });
+    return table;
+}
+
+const FoldTable& gbkFolds() {
+    static const FoldTable table([](const FoldPair& pair) { return std::make_pair(pair.traditionalGbk, pair.simplifiedGbk); });
+    return table;
+}
+
+// ӢĸתСдոַ»ߺ͵Ϊָ
+uint32_t foldAscii(uint32_t c) {
+    if (c >= 'A' && c <= 'Z') return c + ('a' - 'A');
+    if (c == ' ' || c == '\t' || c == '-' || c == '_' || c == '.') return 0;
+    return c;
+}
+
+} // namespace
+
+uint32_t TextIndex::foldChar(uint32_t code, bool utf8) {
+    if (code < 0x80) return foldAscii(code);
+    if (!utf8) {
+        if (code >= 0xA3A1 && code <= 0xA3FE) return foldAscii(code - 0xA3A1 + 0x21);   // ȫ ASCII
+        if (code == 0xA1A1 || code == 0xA1A4 || code == 0xA1AA) return 0;              // ȫǿո񡢼šۺ
+        uint32_t simplified = gbkFolds().find(code);
+        return simplified ? simplified : code;
+    }
+
+    // ԭλַֽƴɵַֽһ
+    uint32_t point;
+    if (code <= 0xFFFF) point = ((code >> 8) & 0x1F) << 6 | (code & 0x3F);
+    else if (code <= 0xFFFFFF) point = ((code >> 16) & 0x0F) << 12 | ((code >> 8) & 0x3F) << 6 | (code & 0x3F);
+    else return code;
+
+    if (point >= 0xFF01 && point <= 0xFF5E) return foldAscii(point - 0xFEE0);
+    if (point == 0x00B7 || point == 0x2022 || point == 0x2027 || point == 0x30FB || point == 0x3000
+        || (point >= 0x2010 && point <= 0x2015)) {
+        return 0;
+    }
+    uint32_t simplified = unicodeFolds().find(point);
+    if (simplified == 0) return code;
+    return (0xE0 | (simplified >> 12)) << 16 | (0x80 | ((simplified >> 6) & 0x3F)) << 8 | (0x80 | (simplified & 0x3F));
+}
+
+void TextIndex::foldChars(std::string_view text, std::vector<uint32_t>& out) {
+    out.clear();
+    bool utf8 = isUtf8(text);
+    const char* p = text.data();
+    const char* end = p + text.size();
+    if (utf8) {
+        // ·ASCII ֣U+4E00~U+9FFFֱӴַ foldChar
+        const FoldTable& table = unicodeFolds();
+        while (p < end) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            uint32_t code;
+            if (c < 0x80) {
+                code = foldAscii(c);
+                ++p;
+            }
+            else if (c >= 0xE4 && c <= 0xE9) {
+                unsigned char c1 = static_cast<unsigned char>(p[1]), c2 = static_cast<unsigned char>(p[2]);
+                p += 3;
+                uint32_t simplified = table.find((c & 0x0Fu) << 12 | (c1 & 0x3Fu) << 6 | (c2 & 0x3Fu));
+                code = simplified == 0 ? uint32_t(c) << 16 | uint32_t(c1) << 8 | c2
+                    : (0xE0 | (simplified >> 12)) << 16 | (0x80 | ((simplified >> 6) & 0x3F)) << 8 | (0x80 | (simplified & 0x3F));
+            }
+            else {
+                size_t len = charLength(p, end, true);
+                code = 0;
+                for (size_t i = 0; i < len; ++i) {
+                    code = (code << 8) | static_cast<unsigned char>(p[i]);
+                }
+                p += len;
+                code = foldChar(code, true);
+            }
+            if (code != 0) out.push_back(code);
+        }
+        return;
+    }
+    while (p < end) {
+        size_t len = charLength(p, end, false);
+        uint32_t code = 0;
+        for (size_t i = 0; i < len; ++i) {
+            code = (code << 8) | static_cast<unsigned char>(p[i]);
+        }
+        p += len;
+        code = foldChar(code, false);
+        if (code != 0) out.push_back(code);
+    }
+}
+
+bool TextIndex::parseField(std::string_view name, Field& field) {
+    if (name == "title") field = Title;
+    else if (name == "author") field = Author;
+    else if (name == "publisher") field = Publisher;
+    else return false;
+    return true;
+}
+
+bool TextIndex::isUtf8(std::string_view text) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    while (p < end) {
+        unsigned char c = *p;
+        size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (len == 0 || static_cast<size_t>(end - p) < len) return false;
+        for (size_t i = 1; i < len; ++i) {
+            if ((p[i] & 0xC0) != 0x80) return false;
+        }
+        p += len;
+    }
+    return true;
+}
+
+size_t TextIndex::charLength(const char* p, const char* end, bool utf8) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    size_t len = 1;
+    if (utf8) {
+        len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+    }
+    else if (c >= 0x81 && c <= 0xFE) {
+        len = 2;  // GBK ˫ַֽ
+    }
+    return std::min(len, static_cast<size_t>(end - p));
+}
+
+std::vector<uint32_t> TextIndex::splitChars(std::string_view text) {
+    std::vector<uint32_t> chars;
+    chars.reserve(text.size());
+    bool utf8 = isUtf8(text);
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        size_t len = charLength(p, end, utf8);
+        uint32_t code = 0;
+        for (size_t i = 0; i < len; ++i) {
+            code = (code << 8) | static_cast<unsigned char>(p[i]);
+        }
+        chars.push_back(code);
+        p += len;
+    }
+    return chars;
+}
+
+std::vector<uint64_t> TextIndex::collectKeys(std::string_view text) {
+    std::vector<uint32_t> chars;
+    foldChars(text, chars);
+    std::vector<uint64_t> keys;
+    keys.reserve(chars.size() * 2);
+    for (size_t i = 0; i < chars.size(); ++i) {
+        keys.push_back(static_cast<uint64_t>(chars[i]) << 32);
+        if (i + 1 < chars.size()) {
+            keys.push_back((static_cast<uint64_t>(chars[i]) << 32) | chars[i + 1]);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+void TextIndex::add(uint32_t slot, Field field, std::string_view text) {
+    for (uint64_t key : collectKeys(text)) {
+        PostingList& list = postings->fields[field][key];
+        if (list.empty() || list.back() < slot) {
+            list.push_back(slot);  // ׷ĩβƶ
+        }
+        else {
+            auto it = std::lower_bound(list.begin(), list.end(), slot);
+            if (it == list.end() || *it != slot) list.insert(it, slot);
+        }
+    }
+}
+
+void TextIndex::remove(uint32_t slot, Field field, std::string_view text) {
+    for (uint64_t key : collectKeys(text)) {
+        auto found = postings->fields[field].find(key);
+        if (found == postings->fields[field].end()) continue;
+        PostingList& list = found->second;
+        auto it = std::lower_bound(list.begin(), list.end(), slot);
+        if (it != list.end() && *it == slot) list.erase(it);
+        if (list.empty()) postings->fields[field].erase(found);
+    }
+}
+
+void TextIndex::remap(const std::vector<uint32_t>& newSlots) {
+    for (size_t field = 0; field < FieldCount; ++field) {
+        for (auto& entry : postings->fields[field]) {
+            for (uint32_t& slot : entry.second) {
+                slot = newSlots[slot];
+            }
+        }
+    }
+}
+
+void TextIndex::clear() {
+    postings.reset();
+}
+
+bool TextIndex::candidates(Field field, std::string_view keyword, std::vector<uint32_t>& out) const {
+    out.clear();
+    return forEachCandidate(field, keyword, [&out](uint32_t slot) {
+        out.push_back(slot);
+        return true;
+    });
+}
+
+bool TextIndex::containsText(std::string_view text, std::string_view keyword) {
+    if (keyword.empty()) return true;
+    bool utf8 = isUtf8(text);
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (static_cast<size_t>(end - p) >= keyword.size()) {
+        if (text.compare(static_cast<size_t>(p - text.data()), keyword.size(), keyword) == 0) {
+            return true;
+        }
+        p += charLength(p, end, utf8);
+    }
+    return false;
+}
+
+void TextIndex::fuzzyCandidates(Field field, const std::vector<uint32_t>& pattern, size_t maxEdits,
+    FuzzyCandidates& out) const {
+    out.slots.clear();
+    out.shared.clear();
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+        keys.push_back((static_cast<uint64_t>(pattern[i]) << 32) | pattern[i + 1]);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    out.keysPerEdit = 2;
+    if (keys.size() <= 2 * maxEdits) {
+        keys.clear();
+        for (uint32_t c : pattern) keys.push_back(static_cast<uint64_t>(c) << 32);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        out.keysPerEdit = 1;
+    }
+    out.keyCount = keys.size();
+    size_t threshold = out.required(maxEdits);
+    out.filtered = threshold > 0;
+    if (!out.filtered) return;
+
+    // ڵļձ
+    static const PostingList empty;
+    std::vector<const PostingList*> lists;
+    lists.reserve(keys.size());
+    for (uint64_t key : keys) {
+        auto found = postings->fields[field].find(key);
+        lists.push_back(found == postings->fields[field].end() ? &empty : &found->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+        [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+
+    // ǰ׺ˣ threshold еͼ飬Ȼ̵ size - threshold + 1 ֮һ
+    // ֻϲ⼸̱೤ÿѡֲҼ
+    size_t shortLists = lists.size() - threshold + 1;
+    std::vector<uint32_t> merged;
+    for (size_t i = 0; i < shortLists; ++i) {
+        size_t middle = merged.size();
+        merged.insert(merged.end(), lists[i]->begin(), lists[i]->end());
+        std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end());
+    }
+
+    std::vector<const uint32_t*> cursors(lists.size());
+    for (size_t i = shortLists; i < lists.size(); ++i) cursors[i] = lists[i]->data();
+    std::vector<uint32_t> slots, counts;
+    for (size_t i = 0; i < merged.size();) {
+        uint32_t slot = merged[i];
+        uint32_t count = 0;
+        while (i < merged.size() && merged[i] == slot) {
+            ++count;
+            ++i;
+        }
+        for (size_t j = shortLists; j < lists.size(); ++j) {
+            if (count + (lists.size() - j) < threshold) break;
+            const uint32_t* end = lists[j]->data() + lists[j]->size();
+            cursors[j] = std::lower_bound(cursors[j], end, slot);
+            if (cursors[j] != end && *cursors[j] == slot) ++count;
+        }
+        if (count >= threshold) {
+            slots.push_back(slot);
+            counts.push_back(count);
+        }
+    }
+
+    // Ͱ򣩣ĺѡУ
+    std::vector<size_t> start(keys.size() + 2, 0);
+    for (uint32_t count : counts) ++start[keys.size() - count + 1];
+    for (size_t i = 1; i < start.size(); ++i) start[i] += start[i - 1];
+    out.slots.resize(slots.size());
+    out.shared.resize(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        size_t position = start[keys.size() - counts[i]]++;
+        out.slots[position] = slots[i];
+        out.shared[position] = counts[i];
+    }
+}
+
+size_t TextIndex::substringDistance(const uint32_t* pattern, size_t patternLength,
+    const uint32_t* text, size_t textLength, size_t bound) {
+    // column[i]pattern ǰ i ַԵǰλýβӴС루Sellers 㷨Ӵɴλÿʼ
+    // Ukkonen ضϣֻ㵽һ bound У¸Ϊ bound + 1
+    // ҵõƥս boundֻѰҸСľ
+    const size_t limit = bound;
+    size_t best = patternLength;   // Ӵɾȥ pattern ȫַ
+    if (best == 0) return 0;
+    if (best <= bound) bound = best - 1;
+
+    uint32_t column[maxFuzzyChars + 1];
+    for (size_t i = 0; i <= patternLength; ++i) column[i] = static_cast<uint32_t>(i);
+    size_t last = std::min(bound, patternLength);
+    for (size_t j = 0; j < textLength; ++j) {
+        size_t rows = std::min(last + 1, patternLength);
+        if (rows > last) column[rows] = static_cast<uint32_t>(bound + 1);
+        uint32_t diagonal = 0;
+        for (size_t i = 1; i <= rows; ++i) {
+            uint32_t left = column[i];
+            uint32_t value = std::min(diagonal + (pattern[i - 1] != text[j] ? 1u : 0u), std::min(left, column[i - 1]) + 1);
+            diagonal = left;
+            column[i] = value;
+        }
+        last = rows;
+        while (last > 0 && column[last] > bound) --last;
+        if (last == patternLength) {
+            best = column[patternLength];
+            if (best == 0) return 0;
+            bound = best - 1;
+            while (last > 0 && column[last] > bound) --last;
+        }
+    }
+    return best <= limit ? best : limit + 1;
+}
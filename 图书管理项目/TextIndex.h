@@ -0,0 +1,173 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory_resource>
+#include <cstdint>
+#include <algorithm>
+#include "PooledObject.h"
+
+// ַߡ罨˫֣bigramű
+// ַֽз֣ǺϷ UTF-8 ʱ UTF-8 룬 GBK ˫ֽڽ룻
+// ǰȰַһת塢ȫתǡӢĸתСдȥո񡢼ŵȷָ
+// ˺ѡҪԭУ
+class TextIndex {
+public:
+    enum Field { Title = 0, Author = 1, Publisher = 2, FieldCount = 3 };
+
+private:
+    using PostingList = std::pmr::vector<uint32_t>;  // еͼ±
+    using PostingMap = std::pmr::unordered_map<uint64_t, PostingList>;
+
+    // ֶεĵűϣ㶼ͬһз䣬Сĵűٸռһζѷ䣬
+    // ʱͷ
+    struct Postings {
+        PostingMap fields[FieldCount];
+        explicit Postings(std::pmr::memory_resource* memory)
+            : fields{ PostingMap(memory), PostingMap(memory), PostingMap(memory) } {}
+    };
+    PooledObject<Postings> postings;
+
+    // ʱʹõĵűֻȡ̵ļ˫յУѹ
+    static constexpr size_t maxIntersect = 8;
+
+    // ıгֵȫ˫ּȥأ
+    static std::vector<uint64_t> collectKeys(std::string_view text);
+
+    // θؼʵļֻһʱΪּΪ˫ּ
+    // visit  false ʱֹͣعؼʵ
+    template <typename Visit>
+    static size_t forEachSearchKey(std::string_view keyword, Visit visit) {
+        bool utf8 = isUtf8(keyword);
+        const char* p = keyword.data();
+        const char* end = p + keyword.size();
+        uint32_t previous = 0;
+        size_t count = 0;
+        while (p < end) {
+            size_t len = charLength(p, end, utf8);
+            uint32_t code = 0;
+            for (size_t i = 0; i < len; ++i) {
+                code = (code << 8) | static_cast<unsigned char>(p[i]);
+            }
+            p += len;
+            code = foldChar(code, utf8);
+            if (code == 0) continue;
+            if (count > 0 && !visit((static_cast<uint64_t>(previous) << 32) | code)) return count + 1;
+            previous = code;
+            ++count;
+        }
+        if (count == 1) visit(static_cast<uint64_t>(previous) << 32);
+        return count;
+    }
+
+public:
+    // ģʱؼȡ
+    static constexpr size_t maxFuzzyChars = 64;
+
+    // ģı༭ؼԽԽ࣬һʱֻһľȷƥ
+    static constexpr size_t fuzzyEditBudget(size_t chars) {
+        return chars <= 2 ? 0 : chars <= 6 ? 1 : chars <= 11 ? 2 : 3;
+    }
+
+    // ά
+    void add(uint32_t slot, Field field, std::string_view text);
+    void remove(uint32_t slot, Field field, std::string_view text);
+
+    // 洢ѹʵλӳд±꣨ӳ䵥űȻ
+    void remap(const std::vector<uint32_t>& newSlots);
+
+    void clear();
+
+    // 󽻵űѺѡ±꽻 visit(slot)visit  false ʱֹͣ
+    // ؼΪʱ޷СΧ falseȫ̲ڴ
+    template <typename Visit>
+    bool forEachCandidate(Field field, std::string_view keyword, Visit visit) const {
+        // ̵ļű
+        const PostingList* lists[maxIntersect];
+        size_t listCount = 0;
+        bool missing = false;
+        size_t chars = forEachSearchKey(keyword, [&](uint64_t key) {
+            auto found = postings->fields[field].find(key);
+            if (found == postings->fields[field].end()) {
+                missing = true;   // ĳڣ޽
+                return false;
+            }
+            const PostingList* list = &found->second;
+            for (size_t i = 0; i < listCount; ++i) {
+                if (lists[i] == list) return true;   // ظ˫
+            }
+            size_t pos;
+            if (listCount < maxIntersect) pos = listCount++;
+            else if (list->size() < lists[maxIntersect - 1]->size()) pos = maxIntersect - 1;
+            else return true;
+            while (pos > 0 && lists[pos - 1]->size() > list->size()) {
+                lists[pos] = lists[pos - 1];
+                --pos;
+            }
+            lists[pos] = list;
+            return true;
+        });
+        if (chars == 0) return false;
+        if (missing) return true;
+
+        // ̵ıдϴελֲ
+        const uint32_t* cursors[maxIntersect];
+        for (size_t i = 0; i < listCount; ++i) cursors[i] = lists[i]->data();
+        for (uint32_t slot : *lists[0]) {
+            bool inAll = true;
+            for (size_t i = 1; i < listCount && inAll; ++i) {
+                const uint32_t* end = lists[i]->data() + lists[i]->size();
+                cursors[i] = std::lower_bound(cursors[i], end, slot);
+                if (cursors[i] == end) return true;   // ñ֮꣬󲻻н
+                inAll = *cursors[i] == slot;
+            }
+            if (inAll && !visit(slot)) break;
+        }
+        return true;
+    }
+
+    // ͬϣѺѡ±ռ out
+    bool candidates(Field field, std::string_view keyword, std::vector<uint32_t>& out) const;
+
+    // ַ߽ж text Ƿ keywordѡУ飩
+    static bool containsText(std::string_view text, std::string_view keyword);
+
+    // ģĺѡ patternѹһַĳӴ༭벻 maxEdits ͼ飬Ȼ pattern 
+    // 㹻ļ˫֣ÿ༭ƻ˫̫ʱõ֣ÿ༭ƻһ
+    struct FuzzyCandidates {
+        std::vector<uint32_t> slots;    // еļӶൽУͬʱ±
+        std::vector<uint32_t> shared;   // ѡеļ
+        size_t keyCount = 0;
+        size_t keysPerEdit = 0;
+        bool filtered = false;          // Ϊ false ʱųκͼ飬ɵ÷У
+
+        // ༭벻 edits ͼٺеļ
+        size_t required(size_t edits) const {
+            return keysPerEdit * edits < keyCount ? keyCount - keysPerEdit * edits : 0;
+        }
+    };
+    void fuzzyCandidates(Field field, const std::vector<uint32_t>& pattern, size_t maxEdits, FuzzyCandidates& out) const;
+
+    // pattern  text һӴ֮С༭루Levenshtein bound ʱ bound + 1
+    // ֻ벻 bound Уҵȫƥ伴ֹͣpatternLength  maxFuzzyChars
+    static size_t substringDistance(const uint32_t* pattern, size_t patternLength,
+        const uint32_t* text, size_t textLength, size_t bound);
+
+    // ַһ 0 ʾָcode Ϊ splitChars ַ
+    static uint32_t foldChar(uint32_t code, bool utf8);
+
+    // ַзֲһȥָ
+    static void foldChars(std::string_view text, std::vector<uint32_t>& out);
+
+    // ֶtitle / author / publisher
+    static bool parseField(std::string_view name, Field& field);
+
+    // жַз
+    static bool isUtf8(std::string_view text);
+    static size_t charLength(const char* p, const char* end, bool utf8);
+    static std::vector<uint32_t> splitChars(std::string_view text);
+};
+
+#endif // TEXT_INDEX_H
@@ -0,0 +1,675 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <random>
+#include <charconv>
+#include <ctime>
+#include <filesystem>
+#include <sstream>
+#include <algorithm>
+#include "LibraryManagement.h"
+#include "ConcurrentLibrary.h"
+#include "QueryEngine.h"
+#include "LibraryServer.h"
+#include "StatsKernels.h"
+#include "CatalogGenerator.h"
+#include "BenchmarkSuite.h"
+#include "ServerLoad.h"
+
+// ׼ԳڹĿ¼ɺϳĿ¼ book.txtβءҡģϲѯбͳơ
+// ѯɾġ桢軹̶߳дգ JSON д
+
+namespace {
+
+struct BenchOptions {
+    size_t books = 100000;
+    uint64_t seed = 42;
+    size_t rounds = 5;
+    size_t threads = 4;                  // ̶߳дĶ߳ҲǲѯĹ߳
+    std::string directory = "bench-data";
+    std::string output;                  // ļΪʱд׼
+    std::vector<std::string> filters;
+    std::vector<double> rates{ 1000, 5000, 20000, 50000 };   // ѯѹ
+    double serverSeconds = 2;            // ÿʵѹʱ
+};
+
+// ȫ
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+NullBuffer nullBuffer;
+std::ostream nullStream(&nullBuffer);
+
+// ֹõĽŻ
+volatile size_t sink = 0;
+
+bool parseNumber(std::string_view text, size_t& out) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseNumber(std::string_view text, double& out) {
+    try {
+        size_t used = 0;
+        out = std::stod(std::string(text), &used);
+        return used == text.size();
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> parts;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        if (comma != 0) parts.emplace_back(text.substr(0, comma));
+        if (comma == std::string_view::npos) break;
+        text.remove_prefix(comma + 1);
+    }
+    return parts;
+}
+
+// ȡ count ͼ ISBN
+std::vector<std::string> sampleISBNs(size_t books, size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> isbns;
+    isbns.reserve(count);
+    for (size_t i = 0; i < count; ++i) isbns.push_back(CatalogGenerator::isbnAt(rng() % books));
+    return isbns;
+}
+
+// ıǰ count ַ
+std::string_view leadingChars(std::string_view text, size_t count) {
+    bool utf8 = TextIndex::isUtf8(text);
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (count-- > 0 && p < end) p += TextIndex::charLength(p, end, utf8);
+    return text.substr(0, static_cast<size_t>(std::min(p, end) - text.data()));
+}
+
+// Ŀ¼֮飺ߵֶΣISBN ȡб֮
+std::vector<Book> makeExtraBooks(size_t first, size_t count, uint64_t seed) {
+    CatalogGenerator::Options generatorOptions;
+    generatorOptions.books = count;
+    generatorOptions.seed = seed;
+    CatalogGenerator generator(generatorOptions);
+
+    std::vector<Book> books;
+    books.reserve(count);
+    Book parsed("", "", "", "", "", 0.0, 0);
+    std::string error;
+    for (size_t i = 0; i < count; ++i) {
+        Book::tryParse(generator.nextLine(), parsed, error);
+        books.emplace_back(CatalogGenerator::isbnAt(first + i), parsed.getTitle(), parsed.getAuthor(),
+            parsed.getPublisher(), parsed.getPublishDate(), parsed.getPrice(), parsed.getQuantity());
+    }
+    return books;
+}
+
+void benchGenerate(BenchmarkSuite& suite, const BenchOptions& options) {
+    CatalogGenerator::Options generatorOptions;
+    generatorOptions.books = options.books;
+    generatorOptions.seed = options.seed;
+
+    auto start = BenchmarkSuite::Clock::now();
+    if (!CatalogGenerator(generatorOptions).writeFile("book.txt")) {
+        std::cerr << "޷д book.txt" << std::endl;
+        std::exit(1);
+    }
+    BenchmarkSuite::Result result;
+    result.name = "generate";
+    result.operations = options.books;
+    result.roundSeconds.push_back(BenchmarkSuite::secondsSince(start));
+    result.metrics.emplace_back("file_bytes", static_cast<double>(std::filesystem::file_size("book.txt")));
+    suite.add(std::move(result));
+}
+
+std::unique_ptr<Library> benchLoad(BenchmarkSuite& suite) {
+    std::unique_ptr<Library> library;
+    suite.run("load", 1, [&] { library = std::make_unique<Library>(nullptr); },
+        [&] { library.reset(); },
+        [&](BenchmarkSuite::Result& result) {
+            double books = library->getTotalBooksCount();
+            double bytes = static_cast<double>(library->getMemoryUsage());
+            result.metrics.emplace_back("books", books);
+            result.metrics.emplace_back("memory_bytes", bytes);
+            result.metrics.emplace_back("bytes_per_book", books > 0 ? bytes / books : 0.0);
+            result.metrics.emplace_back("rss_bytes", static_cast<double>(BenchmarkSuite::residentBytes()));
+            result.metrics.emplace_back("peak_rss_bytes", static_cast<double>(BenchmarkSuite::peakResidentBytes()));
+        });
+    if (!library) library = std::make_unique<Library>(nullptr);
+    return library;
+}
+
+void benchReads(BenchmarkSuite& suite, const BenchOptions& options, Library& library) {
+    const size_t lookups = 1000000;
+    std::vector<std::string> hits = sampleISBNs(options.books, 100000, options.seed + 1);
+    std::vector<std::string> misses;
+    for (size_t i = 0; i < 100000; ++i) misses.push_back(CatalogGenerator::isbnAt(options.books + 1000000 + i));
+
+    suite.run("lookup_hit", lookups, [&] {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; ++i) found += library.isISBNExists(hits[i % hits.size()]);
+        sink = found;
+    });
+    suite.run("lookup_miss", lookups, [&] {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; ++i) found += library.isISBNExists(misses[i % misses.size()]);
+        sink = found;
+    });
+    suite.run("find_book", lookups, [&] {
+        size_t quantity = 0;
+        for (size_t i = 0; i < lookups; ++i) quantity += library.findBook(hits[i % hits.size()])->getQuantity();
+        sink = quantity;
+    });
+
+    // ؼȡͼ飬߱еĻʵʲѯ
+    const size_t searches = 200;
+    std::vector<std::string> titleKeywords, authors;
+    for (size_t i = 0; i < searches; ++i) {
+        auto book = library.findBook(hits[i]);
+        titleKeywords.emplace_back(leadingChars(book->getTitle(), 2));
+        authors.push_back(book->getAuthor());
+    }
+    auto searchCase = [&](const char* name, const std::vector<std::string>& keywords,
+        void (Library::*search)(std::string_view, ResultSink&) const) {
+        size_t rows = 0;
+        suite.run(name, searches, [&] {
+            rows = 0;
+            for (const auto& keyword : keywords) {
+                ResultSink results(nullStream, ResultSink::JsonLines);
+                (library.*search)(keyword, results);
+                rows += results.written();
+            }
+        }, nullptr, [&](BenchmarkSuite::Result& result) {
+            result.metrics.emplace_back("rows_per_query", static_cast<double>(rows) / searches);
+        });
+    };
+    searchCase("search_title", titleKeywords, &Library::searchBookByTitle);
+    searchCase("search_author", authors, &Library::searchBookByAuthor);
+
+    std::vector<Query> queries(4);
+    std::string error;
+    Query::parse("author contains \"" + authors[0] + "\" AND price < 50", queries[0], error);
+    Query::parse("price >= 30 AND price <= 30.5", queries[1], error);
+    Query::parse("title contains \"" + titleKeywords[1] + "\" AND quantity > 0", queries[2], error);
+    Query::parse("date >= 2020-01-01 AND date < 2020-02-01 AND quantity < 10", queries[3], error);
+    suite.run("query", searches, [&] {
+        for (size_t i = 0; i < searches; ++i) {
+            ResultSink results(nullStream, ResultSink::JsonLines);
+            QueryEngine(library).execute(queries[i % queries.size()], results);
+        }
+    });
+
+    suite.run("list", 1, [&] {
+        ResultSink results(nullStream, ResultSink::TSV);
+        library.displayAllBooks(results);
+    });
+
+    suite.run("statistics", 1, [&] {
+        std::streambuf* original = std::cout.rdbuf(&nullBuffer);   // generateStatistics ֱд׼
+        library.generateStatistics();
+        std::cout.rdbuf(original);
+    });
+    suite.run("price_percentile", 1, [&] { sink = static_cast<size_t>(library.getPricePercentile(0.9)); });
+}
+
+//  splitChars ַƴַ
+std::string joinChars(const std::vector<uint32_t>& chars) {
+    std::string text;
+    for (uint32_t c : chars) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            if ((c >> shift) != 0 || shift == 0) text += static_cast<char>((c >> shift) & 0xFF);
+        }
+    }
+    return text;
+}
+
+void benchFuzzy(BenchmarkSuite& suite, const BenchOptions& options, Library& library) {
+    if (!suite.enabled("fuzzy")) return;
+    const size_t limit = 10;
+    const size_t searches = 200;
+    const size_t bruteSearches = 20;
+
+    // ؼȡͼ飨ȡǰ 6 ֣һֻɱ֣ģ¼
+    std::vector<std::string> isbns = sampleISBNs(options.books, searches + 1, options.seed + 6);
+    std::mt19937_64 rng(options.seed + 7);
+    std::vector<std::string> keywords[2];
+    for (size_t i = 0; i < searches; ++i) {
+        auto book = library.findBook(isbns[i]);
+        auto other = library.findBook(isbns[i + 1]);
+        for (int field = 0; field < 2; ++field) {
+            std::vector<uint32_t> chars, replacement;
+            TextIndex::foldChars(field == 0 ? book->getTitle() : book->getAuthor(), chars);
+            TextIndex::foldChars(field == 0 ? other->getTitle() : other->getAuthor(), replacement);
+            if (chars.size() > 6) chars.resize(6);
+            if (chars.size() >= 3 && !replacement.empty()) chars[rng() % chars.size()] = replacement[rng() % replacement.size()];
+            keywords[field].push_back(joinChars(chars));
+        }
+    }
+
+    const TextIndex::Field fields[2] = { TextIndex::Title, TextIndex::Author };
+    const char* names[2] = { "fuzzy_title", "fuzzy_author" };
+    for (int field = 0; field < 2; ++field) {
+        size_t rows = 0;
+        suite.run(names[field], searches, [&] {
+            rows = 0;
+            for (const auto& keyword : keywords[field]) {
+                ResultSink results(nullStream, ResultSink::JsonLines);
+                library.searchRanked(fields[field], keyword, results, limit);
+                rows += results.written();
+            }
+        }, nullptr, [&](BenchmarkSuite::Result& result) {
+            result.metrics.emplace_back("rows_per_query", static_cast<double>(rows) / searches);
+        });
+    }
+
+    // գ𱾼ضϵı༭ȡǰ limit ͬʱ˶ǰ limit ľǷһ
+    bool bruteTitle = suite.enabled("fuzzy_title_brute"), bruteAuthor = suite.enabled("fuzzy_author_brute");
+    if (!bruteTitle && !bruteAuthor) return;
+    std::vector<std::vector<uint32_t>> texts[2];
+    library.forEachBook([&](const Book& book) {
+        for (int field = 0; field < 2; ++field) {
+            texts[field].emplace_back();
+            TextIndex::foldChars(field == 0 ? book.getTitle() : book.getAuthor(), texts[field].back());
+        }
+    });
+    auto bruteDistances = [&](int field, const std::string& keyword) {
+        std::vector<uint32_t> pattern;
+        TextIndex::foldChars(keyword, pattern);
+        size_t bound = TextIndex::fuzzyEditBudget(pattern.size());
+        std::vector<size_t> distances;
+        for (const auto& text : texts[field]) {
+            size_t distance = TextIndex::substringDistance(pattern.data(), pattern.size(), text.data(), text.size(), bound);
+            if (distance <= bound) distances.push_back(distance);
+        }
+        size_t top = std::min(limit, distances.size());
+        std::partial_sort(distances.begin(), distances.begin() + top, distances.end());
+        distances.resize(top);
+        return distances;
+    };
+    for (int field = 0; field < 2; ++field) {
+        std::string name = std::string(names[field]) + "_brute";
+        size_t rows = 0;
+        suite.run(name, bruteSearches, [&] {
+            rows = 0;
+            for (size_t i = 0; i < bruteSearches; ++i) rows += bruteDistances(field, keywords[field][i]).size();
+        }, nullptr, [&](BenchmarkSuite::Result& result) {
+            size_t mismatched = 0;
+            for (size_t i = 0; i < bruteSearches; ++i) {
+                std::ostringstream out;
+                {
+                    ResultSink results(out, ResultSink::TSV);
+                    library.searchRanked(fields[field], keywords[field][i], results, limit);
+                }
+                std::vector<uint32_t> pattern, text;
+                TextIndex::foldChars(keywords[field][i], pattern);
+                std::vector<size_t> indexed;
+                std::istringstream lines(out.str());
+                std::string line;
+                std::getline(lines, line);   // 
+                while (std::getline(lines, line)) {
+                    // TSV Уisbntitleauthor
+                    size_t start = line.find('\t') + 1;
+                    if (field == 1) start = line.find('\t', start) + 1;
+                    TextIndex::foldChars(std::string_view(line).substr(start, line.find('\t', start) - start), text);
+                    indexed.push_back(TextIndex::substringDistance(pattern.data(), pattern.size(), text.data(), text.size(), pattern.size()));
+                }
+                mismatched += indexed != bruteDistances(field, keywords[field][i]);
+            }
+            result.metrics.emplace_back("rows_per_query", static_cast<double>(rows) / bruteSearches);
+            result.metrics.emplace_back("mismatched_queries", static_cast<double>(mismatched));
+        });
+    }
+}
+
+void benchServer(BenchmarkSuite& suite, const BenchOptions& options, Library& library) {
+    bool any = false;
+    for (double rate : options.rates) any = any || suite.enabled("server_rate_" + std::to_string(static_cast<long long>(rate)));
+    if (!any) return;
+
+    std::string socketPath = (std::filesystem::current_path() / "bench.sock").string();
+    LibraryServer::Options serverOptions;
+    serverOptions.address = "unix:" + socketPath;
+    serverOptions.workers = options.threads;
+    LibraryServer server(library);
+    std::string error;
+    if (!server.start(serverOptions, error)) {
+        std::cerr << "ѯѹ⣺" << error << "" << std::endl;
+        return;
+    }
+    std::thread loop(&LibraryServer::run, &server);
+
+    // ųɰ ISBN ѯһɰ
+    ServerLoad::Options load;
+    load.socketPath = socketPath;
+    load.seconds = options.serverSeconds;
+    load.seed = options.seed;
+    for (const auto& isbn : sampleISBNs(options.books, 900, options.seed + 2)) load.requests.push_back("get|" + isbn);
+    for (const auto& isbn : sampleISBNs(options.books, 100, options.seed + 3)) {
+        load.requests.push_back("search|author|" + library.findBook(isbn)->getAuthor());
+    }
+
+    for (double rate : options.rates) {
+        std::string name = "server_rate_" + std::to_string(static_cast<long long>(rate));
+        if (!suite.enabled(name)) continue;
+        load.rate = rate;
+        ServerLoad::Outcome outcome;
+        if (!ServerLoad::run(load, outcome, error)) {
+            std::cerr << "ѯѹʧܣ" << name << "" << error << "" << std::endl;
+            break;
+        }
+        BenchmarkSuite::Result result;
+        result.name = name;
+        result.operations = outcome.latencies.size();
+        result.roundSeconds.push_back(outcome.seconds);
+        result.latencies = std::move(outcome.latencies);
+        result.metrics.emplace_back("target_rate", rate);
+        result.metrics.emplace_back("achieved_rate", static_cast<double>(result.operations) / outcome.seconds);
+        result.metrics.emplace_back("errors", static_cast<double>(outcome.errors));
+        suite.add(std::move(result));
+    }
+
+    server.stop();
+    loop.join();
+}
+
+void benchMutations(BenchmarkSuite& suite, const BenchOptions& options, Library& library) {
+    const size_t count = std::min<size_t>(10000, std::max<size_t>(100, options.books / 10));
+    std::vector<Book> extra = makeExtraBooks(options.books, count, options.seed + 4);
+    std::vector<Book> revised;
+    for (const Book& book : extra) {
+        revised.emplace_back(book.getISBN(), book.getTitle() + "޶棩", book.getAuthor(), book.getPublisher(),
+            book.getPublishDate(), book.getPrice() + 1, book.getQuantity() + 1);
+    }
+
+    // ʼǰѶͼ״̬ʱ
+    auto ensurePresent = [&] {
+        if (library.isISBNExists(extra[0].getISBN())) return;
+        for (const Book& book : extra) library.addBook(book);
+    };
+    auto ensureAbsent = [&] {
+        if (!library.isISBNExists(extra[0].getISBN())) return;
+        for (const Book& book : extra) library.deleteBook(book.getISBN());
+    };
+
+    // ֻڴ޸ģд־
+    library.setPersistenceDeferred(true);
+    suite.runEach("add", count, [&](size_t i) { library.addBook(extra[i]); }, ensureAbsent);
+    size_t updateRound = 0;
+    suite.runEach("update", count, [&](size_t i) {
+        const Book& book = (updateRound % 2 == 1 ? revised : extra)[i];
+        library.updateBook(book.getISBN(), book);
+    }, [&] { ensurePresent(); ++updateRound; });
+    suite.runEach("delete", count, [&](size_t i) { library.deleteBook(extra[i].getISBN()); }, ensurePresent);
+    library.setPersistenceDeferred(false);
+
+    // д־뽻һ
+    suite.runEach("add_journaled", count, [&](size_t i) { library.addBook(extra[i]); }, ensureAbsent);
+
+    // дһοգ --apply һ
+    std::vector<BookOperation> batch(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch[i].type = BookOperation::Add;
+        batch[i].isbn = extra[i].getISBN();
+        batch[i].book = extra[i];
+    }
+    suite.run("apply_batch", count, [&] { library.applyBatch(batch); }, ensureAbsent);
+    ensureAbsent();
+
+    // 
+    const std::string isbn = CatalogGenerator::isbnAt(0);
+    size_t saveRound = 0;
+    suite.run("save", 1, [&] { library.persist(); }, [&] {
+        library.setPersistenceDeferred(true);
+        BookPatch patch;
+        patch.quantity = static_cast<int>(++saveRound);
+        library.updateBook(isbn, patch);
+    }, [&](BenchmarkSuite::Result& result) {
+        result.metrics.emplace_back("file_bytes", static_cast<double>(std::filesystem::file_size("book.txt")));
+    });
+    library.setPersistenceDeferred(false);
+}
+
+void benchCirculation(BenchmarkSuite& suite, const BenchOptions& options, Library& library) {
+    if (!suite.enabled("circulation")) return;
+    const size_t count = 20000;
+    const uint32_t patrons = 1000;
+    std::string error;
+    for (uint32_t patron = 0; patron < patrons; ++patron) {
+        library.addPatron(patron, "" + std::to_string(patron), error);
+    }
+
+    // ÿÿһᣬ֤иɽ裻Ӧڷֲڽ 60 
+    std::vector<std::string> isbns = sampleISBNs(options.books, count * 2, options.seed + 8);
+    std::sort(isbns.begin(), isbns.end());
+    isbns.erase(std::unique(isbns.begin(), isbns.end()), isbns.end());
+    isbns.erase(std::remove_if(isbns.begin(), isbns.end(),
+        [&](const std::string& isbn) { return library.getAvailableCopies(isbn) <= 0; }), isbns.end());
+    std::shuffle(isbns.begin(), isbns.end(), std::mt19937_64(options.seed + 9));
+    if (isbns.size() > count) isbns.resize(count);
+
+    const int32_t today = Circulation::today();
+    std::vector<uint32_t> copies(isbns.size(), 0);   // 0 ʾڼ
+    Circulation::LoanInfo loan;
+    auto borrow = [&](size_t i) {
+        if (library.borrowBook(isbns[i], static_cast<uint32_t>(i % patrons), Circulation::addDays(today, 1 + i % 60),
+            loan, error)) {
+            copies[i] = loan.copy;
+        }
+    };
+    auto giveBack = [&](size_t i) {
+        if (copies[i] != 0 && library.returnBook(isbns[i], copies[i], loan, error)) copies[i] = 0;
+    };
+    auto returnAll = [&] { for (size_t i = 0; i < isbns.size(); ++i) giveBack(i); };
+    auto borrowAll = [&] { for (size_t i = 0; i < isbns.size(); ++i) if (copies[i] == 0) borrow(i); };
+    auto ledgerSize = [](BenchmarkSuite::Result& result) {
+        std::error_code ec;
+        result.metrics.emplace_back("ledger_bytes", static_cast<double>(std::filesystem::file_size("book.txt.loans", ec)));
+    };
+
+    // ÿ軹¼д˱־̼ύ
+    suite.runEach("circulation_borrow", isbns.size(), borrow, returnAll, ledgerSize);
+    suite.runEach("circulation_return", isbns.size(), giveBack, borrowAll, ledgerSize);
+
+    // һҵĽ 30 
+    size_t overdue = 0;
+    const int32_t asOf = Circulation::addDays(today, 31);
+    suite.run("circulation_overdue", 1, [&] {
+        overdue = 0;
+        library.getCirculation().forEachOverdue(asOf, [&](const Circulation::LoanInfo&) {
+            ++overdue;
+            return true;
+        });
+    }, borrowAll, [&](BenchmarkSuite::Result& result) {
+        result.metrics.emplace_back("loans", static_cast<double>(library.getCirculation().loanCount()));
+        result.metrics.emplace_back("overdue", static_cast<double>(overdue));
+    });
+    returnAll();
+    library.flush();
+}
+
+void benchConcurrent(BenchmarkSuite& suite, const BenchOptions& options) {
+    if (!suite.enabled("concurrent")) return;
+    const size_t readsPerThread = 200000;
+    const size_t writes = 20000;
+    ConcurrentLibrary library;
+    std::vector<std::string> isbns = sampleISBNs(options.books, 100000, options.seed + 5);
+
+    // ̰߳ ISBN ѯͬʱһд߳޸ͼ
+    suite.run("concurrent_read_write", options.threads * readsPerThread + writes, [&] {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < options.threads; ++t) {
+            threads.emplace_back([&, t] {
+                size_t quantity = 0;
+                for (size_t i = 0; i < readsPerThread; ++i) {
+                    auto book = library.findBook(isbns[(i * 7 + t * 7919) % isbns.size()]);
+                    if (book) quantity += book->getQuantity();
+                }
+                sink = quantity;
+            });
+        }
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < writes; ++i) {
+                auto book = library.findBook(isbns[i % isbns.size()]);
+                if (!book) continue;
+                library.updateBook(book->getISBN(), Book(book->getISBN(), book->getTitle(), book->getAuthor(),
+                    book->getPublisher(), book->getPublishDate(), book->getPrice(), book->getQuantity() % 500 + 1));
+            }
+        });
+        for (auto& thread : threads) thread.join();
+    }, [&] { library.flush(); }, [&](BenchmarkSuite::Result& result) {
+        result.metrics.emplace_back("readers", static_cast<double>(options.threads));
+        result.metrics.emplace_back("writers", 1);
+    });
+    library.flush();
+}
+
+void benchClear(BenchmarkSuite& suite) {
+    if (!suite.enabled("clear")) return;
+    Library library(nullptr);
+    auto start = BenchmarkSuite::Clock::now();
+    library.clearAllBooks();
+    BenchmarkSuite::Result result;
+    result.name = "clear";
+    result.operations = 1;
+    result.roundSeconds.push_back(BenchmarkSuite::secondsSince(start));
+    suite.add(std::move(result));
+}
+
+std::string currentTime() {
+    std::time_t now = std::time(nullptr);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return text;
+}
+
+std::string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+int usage(const char* program) {
+    std::cerr << "÷" << std::endl
+        << "  " << program << " [--books N] [--seed N] [--rounds N] [--threads N] [--dir Ŀ¼]" << std::endl
+        << "      [--filter 1,2] [--rates 1,2] [--server-seconds ] [--out .json]" << std::endl
+        << "  " << program << " --generate <ͼ> <ļ> [--seed N]   ֻɺϳĿ¼" << std::endl;
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    std::string generatePath;
+    bool generateOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--generate") {
+            if (i + 2 >= argc || !parseNumber(argv[i + 1], options.books)) return usage(argv[0]);
+            generatePath = argv[i + 2];
+            generateOnly = true;
+            i += 2;
+            continue;
+        }
+        if (i + 1 >= argc) return usage(argv[0]);
+        std::string value = argv[++i];
+        size_t number = 0;
+        bool ok = true;
+        if (option == "--books") ok = parseNumber(value, options.books) && options.books > 0;
+        else if (option == "--seed") {
+            ok = parseNumber(value, number);
+            options.seed = number;
+        }
+        else if (option == "--rounds") ok = parseNumber(value, options.rounds);
+        else if (option == "--threads") ok = parseNumber(value, options.threads) && options.threads > 0;
+        else if (option == "--dir") options.directory = value;
+        else if (option == "--out") options.output = value;
+        else if (option == "--filter") options.filters = splitList(value);
+        else if (option == "--server-seconds") ok = parseNumber(value, options.serverSeconds) && options.serverSeconds > 0;
+        else if (option == "--rates") {
+            options.rates.clear();
+            for (const auto& part : splitList(value)) {
+                double rate = 0;
+                ok = ok && parseNumber(part, rate) && rate > 0;
+                options.rates.push_back(rate);
+            }
+        }
+        else ok = false;
+        if (!ok) {
+            std::cerr << "Чѡ " << option << " " << value << "" << std::endl;
+            return 2;
+        }
+    }
+
+    if (generateOnly) {
+        CatalogGenerator::Options generatorOptions;
+        generatorOptions.books = options.books;
+        generatorOptions.seed = options.seed;
+        if (!CatalogGenerator(generatorOptions).writeFile(generatePath)) {
+            std::cerr << "޷д " << generatePath << "" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // ļ·Ŀ¼֮лĿ¼Library ̶дǰĿ¼µ book.txt
+    std::ofstream resultFile;
+    if (!options.output.empty()) {
+        resultFile.open(options.output, std::ios::binary | std::ios::trunc);
+        if (!resultFile.is_open()) {
+            std::cerr << "޷д " << options.output << "" << std::endl;
+            return 1;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(options.directory, ec);
+    std::filesystem::current_path(options.directory, ec);
+    if (ec) {
+        std::cerr << "޷빤Ŀ¼ " << options.directory << "" << ec.message() << "" << std::endl;
+        return 1;
+    }
+    std::filesystem::remove("book.txt.journal", ec);
+    std::filesystem::remove("book.txt.loans", ec);
+
+    BenchmarkSuite suite(options.rounds, options.filters, &std::cerr);
+    suite.setParameter("books", std::to_string(options.books));
+    suite.setParameter("seed", std::to_string(options.seed));
+    suite.setParameter("rounds", std::to_string(options.rounds));
+    suite.setParameter("threads", std::to_string(options.threads));
+    suite.setParameter("hardware_threads", std::to_string(std::thread::hardware_concurrency()));
+    suite.setParameter("stats_kernel", StatsKernels::usingAvx2() ? "avx2" : "scalar");
+    suite.setParameter("compiler", compilerName());
+    suite.setParameter("started", currentTime());
+
+    benchGenerate(suite, options);
+    {
+        std::unique_ptr<Library> library = benchLoad(suite);
+        benchReads(suite, options, *library);
+        benchFuzzy(suite, options, *library);
+        benchServer(suite, options, *library);
+        benchMutations(suite, options, *library);
+        benchCirculation(suite, options, *library);
+    }
+    benchConcurrent(suite, options);
+    benchClear(suite);
+
+    suite.writeJson(options.output.empty() ? std::cout : resultFile);
+    return 0;
+}
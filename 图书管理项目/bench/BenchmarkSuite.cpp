@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include "BenchmarkSuite.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace {
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.10g", value);
+    return text;
+}
+
+std::string jsonString(std::string_view text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+#if defined(__linux__)
+// ȡ /proc/self/status  key ͷһУλ kB
+size_t procStatusBytes(const char* key) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    size_t keyLength = std::char_traits<char>::length(key);
+    while (std::getline(in, line)) {
+        if (line.compare(0, keyLength, key) == 0) {
+            return std::strtoull(line.c_str() + keyLength, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+#endif
+
+} // namespace
+
+double BenchmarkSuite::Result::nanosecondsPerOperation() const {
+    if (operations == 0) return 0.0;
+    return median(roundSeconds) * 1e9 / static_cast<double>(operations);
+}
+
+double BenchmarkSuite::Result::bestNanosecondsPerOperation() const {
+    if (operations == 0 || roundSeconds.empty()) return 0.0;
+    return *std::min_element(roundSeconds.begin(), roundSeconds.end()) * 1e9 / static_cast<double>(operations);
+}
+
+double BenchmarkSuite::Result::latencyPercentile(double q) const {
+    if (latencies.empty()) return 0.0;
+    std::vector<double> sorted = latencies;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * static_cast<double>(sorted.size())));
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+    return sorted[index];
+}
+
+BenchmarkSuite::BenchmarkSuite(size_t rounds, std::vector<std::string> filters, std::ostream* progress)
+    : filters(std::move(filters)), rounds(rounds == 0 ? 1 : rounds), progress(progress) {
+}
+
+bool BenchmarkSuite::enabled(std::string_view name) const {
+    if (filters.empty()) return true;
+    return std::any_of(filters.begin(), filters.end(),
+        [name](const std::string& filter) { return name.find(filter) != std::string_view::npos; });
+}
+
+void BenchmarkSuite::setParameter(std::string name, std::string value) {
+    parameters.emplace_back(std::move(name), std::move(value));
+}
+
+void BenchmarkSuite::run(std::string_view name, size_t operations,
+    const std::function<void()>& body, const Setup& setup, const Finish& finish) {
+    if (!enabled(name)) return;
+    Result result;
+    result.name = name;
+    result.operations = operations;
+    for (size_t round = 0; round < rounds; ++round) {
+        if (setup) setup();
+        auto start = Clock::now();
+        body();
+        result.roundSeconds.push_back(secondsSince(start));
+    }
+    if (finish) finish(result);
+    add(std::move(result));
+}
+
+void BenchmarkSuite::runEach(std::string_view name, size_t operations,
+    const std::function<void(size_t)>& body, const Setup& setup, const Finish& finish) {
+    if (!enabled(name)) return;
+    Result result;
+    result.name = name;
+    result.operations = operations;
+    result.latencies.reserve(operations * rounds);
+    for (size_t round = 0; round < rounds; ++round) {
+        if (setup) setup();
+        auto roundStart = Clock::now();
+        for (size_t i = 0; i < operations; ++i) {
+            auto start = Clock::now();
+            body(i);
+            result.latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+        result.roundSeconds.push_back(secondsSince(roundStart));
+    }
+    if (finish) finish(result);
+    add(std::move(result));
+}
+
+BenchmarkSuite::Result& BenchmarkSuite::add(Result result) {
+    results.push_back(std::move(result));
+    const Result& added = results.back();
+    if (progress) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-28s %12.1f ns/op  (best %.1f, %zu x %zu)",
+            added.name.c_str(), added.nanosecondsPerOperation(), added.bestNanosecondsPerOperation(),
+            added.roundSeconds.size(), added.operations);
+        *progress << line;
+        if (!added.latencies.empty()) {
+            std::snprintf(line, sizeof(line), "  p50 %.0f  p99 %.0f  p999 %.0f ns",
+                added.latencyPercentile(0.5), added.latencyPercentile(0.99), added.latencyPercentile(0.999));
+            *progress << line;
+        }
+        for (const auto& [metric, value] : added.metrics) *progress << "  " << metric << "=" << jsonNumber(value);
+        *progress << std::endl;
+    }
+    return results.back();
+}
+
+void BenchmarkSuite::writeJson(std::ostream& out) const {
+    out << "{\n  \"suite\": \"library-bench\",\n  \"parameters\": {";
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        out << (i == 0 ? "" : ",") << "\n    " << jsonString(parameters[i].first) << ": " << jsonString(parameters[i].second);
+    }
+    out << "\n  },\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i == 0 ? "" : ",") << "\n    {\"name\": " << jsonString(result.name)
+            << ", \"operations\": " << result.operations
+            << ", \"rounds\": " << result.roundSeconds.size()
+            << ", \"ns_per_op\": " << jsonNumber(result.nanosecondsPerOperation())
+            << ", \"best_ns_per_op\": " << jsonNumber(result.bestNanosecondsPerOperation())
+            << ", \"ops_per_second\": " << jsonNumber(result.nanosecondsPerOperation() > 0 ? 1e9 / result.nanosecondsPerOperation() : 0.0);
+        if (!result.latencies.empty()) {
+            out << ", \"p50_ns\": " << jsonNumber(result.latencyPercentile(0.5))
+                << ", \"p99_ns\": " << jsonNumber(result.latencyPercentile(0.99))
+                << ", \"p999_ns\": " << jsonNumber(result.latencyPercentile(0.999))
+                << ", \"max_ns\": " << jsonNumber(*std::max_element(result.latencies.begin(), result.latencies.end()));
+        }
+        for (const auto& [metric, value] : result.metrics) {
+            out << ", " << jsonString(metric) << ": " << jsonNumber(value);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+size_t BenchmarkSuite::residentBytes() {
+#if defined(__linux__)
+    return procStatusBytes("VmRSS:");
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    return K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#else
+    return 0;
+#endif
+}
+
+size_t BenchmarkSuite::peakResidentBytes() {
+#if defined(__linux__)
+    return procStatusBytes("VmHWM:");
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    return K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+    return 0;
+#endif
+}
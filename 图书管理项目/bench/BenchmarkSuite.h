@@ -0,0 +1,72 @@
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <chrono>
+#include <ostream>
+
+// ׼Խռ
+// ÿ֣ÿִ operations βʱÿβʱλСֵ
+// βصμʱⱨӳٷλ JSON ڱȽϲͬ汾
+class BenchmarkSuite {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string name;
+        size_t operations = 0;                 // ÿֲ
+        std::vector<double> roundSeconds;      // ֺʱ
+        std::vector<double> latencies;         // μʱĵκʱ룩Ϊ
+        std::vector<std::pair<std::string, double>> metrics;   // ָ꣬ڴ桢
+
+        double nanosecondsPerOperation() const;     // λ
+        double bestNanosecondsPerOperation() const;
+        double latencyPercentile(double q) const;   // q ȡ 0~1
+    };
+
+private:
+    std::vector<std::string> filters;
+    std::vector<std::pair<std::string, std::string>> parameters;   // вԭд JSON
+    std::vector<Result> results;
+    size_t rounds;
+    std::ostream* progress;
+
+public:
+    // filters ǿʱֻưһӴд progressΪʱ
+    BenchmarkSuite(size_t rounds, std::vector<std::string> filters, std::ostream* progress);
+
+    bool enabled(std::string_view name) const;
+    size_t getRounds() const { return rounds; }
+
+    void setParameter(std::string name, std::string value);
+
+    using Setup = std::function<void()>;
+    using Finish = std::function<void(Result&)>;
+
+    // һÿȵ setupʱٶ body ʱbody ִ operations β
+    // ȫִν finish 丽ָ꣬Ȼ¼˵ʱʲôҲ
+    void run(std::string_view name, size_t operations, const std::function<void()>& body,
+        const Setup& setup = nullptr, const Finish& finish = nullptr);
+
+    // ͬϣμʱbody(i) ִе i β
+    void runEach(std::string_view name, size_t operations, const std::function<void(size_t)>& body,
+        const Setup& setup = nullptr, const Finish& finish = nullptr);
+
+    // һɵ÷вĽ
+    Result& add(Result result);
+
+    void writeJson(std::ostream& out) const;
+
+    // ǰ̵ĳפڴֵֽڣֵ֧ƽ̨ 0
+    static size_t residentBytes();
+    static size_t peakResidentBytes();
+
+    static double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+};
+
+#endif // BENCHMARK_SUITE_H
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "CatalogGenerator.h"
+
+namespace {
+
+// ֣°Ƶ
+const char* const titleCharacters[] = {
+    "", "֮", "", "", "", "", "ѧ", "", "ʷ", "", "", "", "", "", "", "",
+    "", "ʱ", "", "", "", "", "", "", "С", "˵", "", "", "", "", "", "",
+    "", "ʫ", "ѡ", "ѧ", "ϰ", "", "", "", "", "ʵ", "", "", "", "", "", "ԭ",
+    "", "", "", "", "", "", "", "", "", "", "Ȼ", "", "", "", "", "",
+    "", "", "", "", "", "", "", "", "", "", "", "", "", "", "ɽ", "",
+    "", "", "", "", "", "", "ҹ", "", "", "", "", "", "", "", "", "",
+    "", "", "", "", "", "", "·", "Զ", "", "", "", "", "", "", "", "",
+    "", "", "ͨ", "ʶ", "", "", "", "Ҫ", "ȫ", "", "", "", "ָ", "", "", "",
+    "", "", "", "", "", "Ӱ", "", "", "", "", "ʳ", "", "", "", "ҽ", "ҩ",
+    "", "ͯ", "", "", "", "", "", "ĸ", "", "ʦ", "", "", "", "Ů", "Ӣ", "",
+    "ս", "", "", "ƽ", "", "", "", "", "", "չ", "δ", "", "", "ȥ", "", "",
+    "˼", "", "", "ѧ", "", "", "", "", "", "", "", "", "", "ҵ", "", "",
+    "Ͷ", "", "Ӫ", "", "", "", "", "", "", "", "", "", "", "", "Դ", "",
+    "", "", "", "", "", "", "", "", "Ϣ", "", "", "", "", "", "", "",
+    "һ", "", "", "ʮ", "ǧ", "", "", "", "", "", "", "", "", "", "", "",
+};
+
+// ϣ°˿Уշĩβ
+const char* const surnames[] = {
+    "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "",
+    "", "", "", "", "֣", "", "л", "", "", "", "", "", "", "", "", "",
+    "Ф", "", "", "Ԭ", "", "", "", "", "", "", "Ҷ", "", "", "κ", "", "",
+    "", "", "Ҧ", "¬", "", "", "", "̷", "½", "", "", "", "ʯ", "", "", "",
+    "ŷ", "˾", "Ϲ", "",
+};
+
+// ֳ
+const char* const givenCharacters[] = {
+    "ΰ", "", "", "", "", "", "ǿ", "", "", "", "", "", "", "", "", "",
+    "", "", "ϼ", "ƽ", "", "", "Ӣ", "", "", "", "", "־", "", "", "", "",
+    "", "", "", "", "", "", "", "", "", "", "", "", "", "˼", "", "",
+    "", "", "", "ɭ", "", "", "", "ѩ", "÷", "", "", "", "", "", "", "",
+};
+
+// 
+const char* const transliterations[] = {
+    "", "", "", "˹", "", "", "", "", "", "", "", "", "", "", "", "",
+    "", "", "", "", "", "", "", "", "ά", "", "", "ɯ", "", "ķ", "ɭ", "",
+};
+
+const char* const places[] = {
+    "", "л", "", "", "Ϻ", "", "", "㶫", "㽭", "", "", "",
+    "Ĵ", "ɽ", "", "ӱ", "", "", "", "", "", "", "", "",
+};
+
+const char* const categories[] = {
+    "", "ѧ", "", "", "", "ѧ", "", "ͯ", "", "ż", "ѧ",
+    "ƾ", "ѧ", "", "ӹҵ", "еҵ", "",
+};
+
+const char* const editions[] = { "", "", "", "", "", "", "" };
+
+const char* const asciiPrefixes[] = { "C++", "Python", "Java", "AI", "3D", "UNIX", "Web", "SQL" };
+
+constexpr size_t titleCharacterCount = sizeof(titleCharacters) / sizeof(titleCharacters[0]);
+constexpr size_t surnameCount = sizeof(surnames) / sizeof(surnames[0]);
+constexpr size_t publisherCount = 600;
+
+// ¼СԼÿıһλ
+size_t authorCount(size_t books) {
+    return std::max<size_t>(1000, books / 4);
+}
+
+template <size_t N>
+const char* pick(const char* const (&table)[N], std::mt19937_64& rng) {
+    return table[rng() % N];
+}
+
+} // namespace
+
+CatalogGenerator::WeightedIndex::WeightedIndex(size_t count, double exponent, double offset) {
+    cumulative.reserve(count);
+    double total = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        total += 1.0 / std::pow(static_cast<double>(k) + offset, exponent);
+        cumulative.push_back(total);
+    }
+}
+
+size_t CatalogGenerator::WeightedIndex::operator()(std::mt19937_64& rng) const {
+    double target = static_cast<double>(rng() >> 11) * 0x1.0p-53 * cumulative.back();
+    size_t index = std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+    return std::min(index, cumulative.size() - 1);
+}
+
+CatalogGenerator::CatalogGenerator(const Options& options)
+    : options(options), rng(options.seed),
+    titleChars(titleCharacterCount, 1.0, 2.0),
+    authorRank(authorCount(options.books), 1.0, 50.0),
+    publisherRank(publisherCount, 1.0, 5.0) {
+    // ¼ɣ֮ÿ鰴ɴгȡ
+    authors.reserve(authorCount(options.books));
+    for (size_t i = 0; i < authorCount(options.books); ++i) authors.push_back(makePersonName());
+    publishers.reserve(publisherCount);
+    for (size_t i = 0; i < publisherCount; ++i) publishers.push_back(makePublisher());
+}
+
+double CatalogGenerator::uniform() {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+std::string CatalogGenerator::isbnAt(size_t index) {
+    // 978 + 9 λţ 10^9 صĴɢ+ Уλ
+    uint64_t body = (static_cast<uint64_t>(index) * 387420489ULL + 12345ULL) % 1000000000ULL;
+    char digits[14];
+    std::snprintf(digits, sizeof(digits), "978%09llu", static_cast<unsigned long long>(body));
+    int sum = 0;
+    for (int i = 0; i < 12; ++i) sum += (digits[i] - '0') * (i % 2 == 0 ? 1 : 3);
+    digits[12] = static_cast<char>('0' + (10 - sum % 10) % 10);
+    return std::string(digits, 13);
+}
+
+std::string CatalogGenerator::makeTitle() {
+    std::string title;
+    if (uniform() < 0.04) title += pick(asciiPrefixes, rng);
+
+    double u = uniform();
+    size_t length = u < 0.45 ? 2 + rng() % 3 : u < 0.85 ? 5 + rng() % 4 : 9 + rng() % 6;
+    for (size_t i = 0; i < length; ++i) title += titleCharacters[titleChars(rng)];
+
+    if (uniform() < 0.05) {
+        title += "";
+        for (size_t i = 3 + rng() % 4; i > 0; --i) title += titleCharacters[titleChars(rng)];
+    }
+    if (uniform() < 0.08) {
+        title += "";
+        title += pick(editions, rng);
+        title += "棩";
+    }
+    return title;
+}
+
+std::string CatalogGenerator::makePersonName() {
+    std::string name;
+    if (uniform() < 0.12) {
+        // 
+        for (size_t i = 2 + rng() % 3; i > 0; --i) name += pick(transliterations, rng);
+        name += "";
+        for (size_t i = 2 + rng() % 3; i > 0; --i) name += pick(transliterations, rng);
+    }
+    else {
+        // ƫ򳣼
+        size_t rank = static_cast<size_t>(uniform() * uniform() * surnameCount);
+        name += surnames[std::min(rank, surnameCount - 1)];
+        name += pick(givenCharacters, rng);
+        if (uniform() < 0.65) name += pick(givenCharacters, rng);
+    }
+    double u = uniform();
+    if (u < 0.04) name += "";
+    else if (u < 0.07) name += "";
+    return name;
+}
+
+std::string CatalogGenerator::makePublisher() {
+    std::string name = pick(places, rng);
+    if (uniform() < 0.2) name += "ѧ";
+    else name += pick(categories, rng);
+    name += "";
+    return name;
+}
+
+std::string CatalogGenerator::makeDate() {
+    // ƫ
+    double u = uniform();
+    int year = 2025 - static_cast<int>(75 * u * u);
+    int month = 1 + static_cast<int>(rng() % 12);
+    int day = 1 + static_cast<int>(rng() % 28);
+    char text[32];
+    double form = uniform();
+    if (form < 0.85) std::snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+    else if (form < 0.95) std::snprintf(text, sizeof(text), "%d-%d", year, month);
+    else return std::to_string(year) + "" + std::to_string(month) + "";
+    return text;
+}
+
+std::string CatalogGenerator::nextLine() {
+    std::string line = isbnAt(produced++);
+    line += '|';
+    line += makeTitle();
+    line += '|';
+    line += authors[authorRank(rng)];
+    line += '|';
+    line += publishers[publisherRank(rng)];
+    line += '|';
+    line += makeDate();
+
+    // ۸λԼ 45 ԪĶ̬۵
+    double u1 = 1.0 - uniform();
+    double u2 = uniform();
+    double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    double price = std::clamp(std::exp(std::log(45.0) + 0.6 * normal), 1.0, 999.0);
+    price = uniform() < 0.7 ? std::round(price * 10) / 10 : std::round(price * 100) / 100;
+
+    // ȱƾֵ 40 ļηֲ
+    int quantity = uniform() < 0.05 ? 0 : std::min(999, static_cast<int>(-std::log(1.0 - uniform()) * 40));
+
+    char numbers[64];
+    std::snprintf(numbers, sizeof(numbers), "|%.2f|%d", price, quantity);
+    line += numbers;
+    return line;
+}
+
+bool CatalogGenerator::write(std::ostream& out) {
+    std::string buffer;
+    buffer.reserve(1 << 20);
+    for (size_t i = 0; i < options.books; ++i) {
+        buffer += nextLine();
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20) - 512) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    return out.good();
+}
+
+bool CatalogGenerator::writeFile(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    return out.is_open() && write(out);
+}
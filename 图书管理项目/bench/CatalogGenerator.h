@@ -0,0 +1,61 @@
+#ifndef CATALOG_GENERATOR_H
+#define CATALOG_GENERATOR_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <ostream>
+
+// ϳͼĿ¼ɿظ book.txt ݣڻ׼
+// ɳúְƵƴɣӹ̶С¼аɳȡ/ռͼ飩
+// ۸ƶ̬Ƽηֲƫ겢мֳд
+// ֻ mt19937_64 ԭʼлֲ׼ֲʵ֣ƽ̨ͬһͬ
+class CatalogGenerator {
+public:
+    struct Options {
+        size_t books = 100000;
+        uint64_t seed = 42;
+    };
+
+private:
+    // Ȩسȡ±꣺ۻȨ϶ֲ
+    class WeightedIndex {
+    private:
+        std::vector<double> cumulative;
+
+    public:
+        //  k ȨΪ 1/(k+offset)^exponent
+        WeightedIndex(size_t count, double exponent, double offset);
+        size_t operator()(std::mt19937_64& rng) const;
+    };
+
+    Options options;
+    std::mt19937_64 rng;
+    std::vector<std::string> authors;
+    std::vector<std::string> publishers;
+    WeightedIndex titleChars;
+    WeightedIndex authorRank;
+    WeightedIndex publisherRank;
+    size_t produced = 0;
+
+    double uniform();
+    std::string makeTitle();
+    std::string makePersonName();
+    std::string makePublisher();
+    std::string makeDate();
+
+public:
+    explicit CatalogGenerator(const Options& options);
+
+    //  index  ISBN13 λУλindex ͬʱ ISBN ҲͬҲ index 
+    static std::string isbnAt(size_t index);
+
+    // һһݣ book.txt иʽͬз
+    std::string nextLine();
+
+    // дȫ options.books 飬ʧʱ false
+    bool write(std::ostream& out);
+    bool writeFile(const std::string& path);
+};
+
+#endif // CATALOG_GENERATOR_H
@@ -0,0 +1,176 @@
+#include "ServerLoad.h"
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int connectTo(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    // ֹͣӦʱ޵ȴ
+    timeval timeout{ 10, 0 };
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+// һϵѹ⣺̰߳ƻʱ̳дڵ󣬶ȡ̰߳˳ƥӦ
+struct ConnectionLoad {
+    int fd = -1;
+    std::vector<Clock::time_point> schedule;
+    std::vector<double> latencies;
+    size_t errors = 0;
+    bool sendFailed = false;      // ̸߳дı־
+    bool receiveFailed = false;
+    Clock::time_point finished;
+
+    void send(const ServerLoad::Options& options, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string batch;
+        size_t next = 0;
+        while (next < schedule.size()) {
+            auto now = Clock::now();
+            if (schedule[next] > now) {
+                std::this_thread::sleep_until(schedule[next]);
+                continue;
+            }
+            batch.clear();
+            while (next < schedule.size() && schedule[next] <= now) {
+                batch += options.requests[rng() % options.requests.size()];
+                batch += '\n';
+                ++next;
+            }
+            for (size_t offset = 0; offset < batch.size();) {
+                ssize_t written = ::send(fd, batch.data() + offset, batch.size() - offset, MSG_NOSIGNAL);
+                if (written <= 0) {
+                    sendFailed = true;
+                    return;
+                }
+                offset += static_cast<size_t>(written);
+            }
+        }
+    }
+
+    // ÿӦһ״̬"ok<TAB>n" ֮ n н
+    void receive() {
+        std::string input;
+        size_t position = 0;
+        size_t rowsPending = 0;
+        char chunk[64 * 1024];
+        while (latencies.size() < schedule.size()) {
+            ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                receiveFailed = true;
+                break;
+            }
+            input.append(chunk, static_cast<size_t>(received));
+            size_t end;
+            while ((end = input.find('\n', position)) != std::string::npos) {
+                std::string_view line(input.data() + position, end - position);
+                position = end + 1;
+                if (rowsPending > 0) {
+                    if (--rowsPending == 0) complete();
+                    continue;
+                }
+                if (line.compare(0, 5, "error") == 0) ++errors;
+                if (line.compare(0, 3, "ok\t") == 0) rowsPending = std::strtoull(line.data() + 3, nullptr, 10);
+                if (rowsPending == 0) complete();
+            }
+            if (position > (1 << 20)) {
+                input.erase(0, position);
+                position = 0;
+            }
+        }
+        finished = Clock::now();
+    }
+
+    void complete() {
+        size_t index = latencies.size();
+        latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - schedule[index]).count());
+    }
+};
+
+} // namespace
+
+bool ServerLoad::run(const Options& options, Outcome& outcome, std::string& error) {
+    outcome = Outcome();
+    if (options.requests.empty() || options.rate <= 0 || options.connections == 0) {
+        error = "ѹЧ";
+        return false;
+    }
+
+    std::vector<ConnectionLoad> loads(options.connections);
+    for (auto& load : loads) {
+        load.fd = connectTo(options.socketPath);
+        if (load.fd == -1) {
+            error = "޷ " + options.socketPath + "" + std::strerror(errno);
+            for (auto& opened : loads) if (opened.fd != -1) ::close(opened.fd);
+            return false;
+        }
+    }
+
+    // Ӿʣƻʱ໥
+    double perConnection = options.rate / static_cast<double>(options.connections);
+    size_t count = std::max<size_t>(1, static_cast<size_t>(perConnection * options.seconds));
+    auto start = Clock::now() + std::chrono::milliseconds(20);
+    for (size_t c = 0; c < loads.size(); ++c) {
+        double phase = static_cast<double>(c) / static_cast<double>(loads.size());
+        loads[c].schedule.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto offset = std::chrono::duration<double>((static_cast<double>(i) + phase) / perConnection);
+            loads[c].schedule.push_back(start + std::chrono::duration_cast<Clock::duration>(offset));
+        }
+        loads[c].latencies.reserve(count);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < loads.size(); ++c) {
+        threads.emplace_back(&ConnectionLoad::receive, &loads[c]);
+        threads.emplace_back(&ConnectionLoad::send, &loads[c], std::cref(options), options.seed * 1000003 + c);
+    }
+    for (auto& thread : threads) thread.join();
+
+    Clock::time_point last = start;
+    bool failed = false;
+    for (auto& load : loads) {
+        ::close(load.fd);
+        failed = failed || load.sendFailed || load.receiveFailed;
+        outcome.errors += load.errors;
+        outcome.latencies.insert(outcome.latencies.end(), load.latencies.begin(), load.latencies.end());
+        last = std::max(last, load.finished);
+    }
+    outcome.seconds = std::chrono::duration<double>(last - start).count();
+    if (failed) error = ";ϿʱδӦ";
+    return !failed;
+}
+
+#else
+
+bool ServerLoad::run(const Options&, Outcome& outcome, std::string& error) {
+    outcome = Outcome();
+    error = "ѯѹĿǰֻ֧ Linux";
+    return false;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SERVER_LOAD_H
+#define SERVER_LOAD_H
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// ѯĿѹ⣺̶ Unix ׽ַ󣬲ȴӦˮߣ
+// ӳٴļƻʱ𣬷ʱŶʱҲӳ
+class ServerLoad {
+public:
+    struct Options {
+        std::string socketPath;
+        std::vector<std::string> requests;   // أзȡ
+        double rate = 1000;                  // ÿȫӺϼƣ
+        double seconds = 2;
+        size_t connections = 4;
+        uint64_t seed = 1;
+    };
+
+    struct Outcome {
+        std::vector<double> latencies;   // ÿӳ٣룩
+        size_t errors = 0;               //  error 
+        double seconds = 0;              // ӵһһӦʱ
+    };
+
+    // һѹ⣻ʧܻ;Ͽʱ falseĿǰֻ֧ Linux
+    static bool run(const Options& options, Outcome& outcome, std::string& error);
+};
+
+#endif // SERVER_LOAD_H
@@ -0,0 +1,86 @@
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <string>
+#include "LibraryManagement.h"
+#include "ResultSink.h"
+#include "TestSupport.h"
+
+// ·ڴ棺滻ȫ operator new 
+// Ԥȣ仺桢ſ壩֮ظãӦΪ 0
+
+namespace {
+
+std::atomic<bool> counting{ false };
+std::atomic<size_t> allocations{ 0 };
+
+// ֹõĽŻ
+volatile size_t observed = 0;
+
+// ԤһΣټ rounds εеķ
+template <typename Function>
+size_t allocationsDuring(Function&& call, int rounds = 100) {
+    call();
+    allocations.store(0);
+    counting.store(true);
+    for (int i = 0; i < rounds; ++i) call();
+    counting.store(false);
+    return allocations.load();
+}
+
+} // namespace
+
+// ʽ顢nothrowĬתʽò
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+bool testAllocationFree() {
+    const size_t books = 20000;
+    CHECK(writeCatalog(books));
+    Library library(nullptr);
+    CHECK(library.getTotalBooksCount() == static_cast<int>(books));
+
+    std::string hit = testISBN(7);
+    std::string miss = testISBN(books + 7);
+    Library::BookHandle book = library.findBook(hit);
+    CHECK(book != nullptr);
+    std::string title = book->getTitle();
+    std::string author = book->getAuthor();
+    const std::string absent = "no-such-keyword";
+
+    // ЧtoString ƴгַŻĳȣÿεٷһ
+    CHECK(allocationsDuring([&] { observed = book->toString().size(); }) >= 100);
+
+    CHECK(allocationsDuring([&] { observed = library.isISBNExists(hit) + library.isISBNExists(miss); }) == 0);
+    CHECK(allocationsDuring([&] {
+        observed = (library.findBook(hit) != nullptr) + (library.findBook(miss) != nullptr);
+    }) == 0);
+
+    for (ResultSink::Format format : { ResultSink::Human, ResultSink::JsonLines }) {
+        ResultSink sink(nullStream(), format);
+        CHECK(allocationsDuring([&] {
+            observed = library.searchBookByISBN(hit, sink) + library.searchBookByISBN(miss, sink);
+        }) == 0);
+        CHECK(allocationsDuring([&] {
+            library.searchBookByTitle(title, sink);
+            library.searchBookByTitle(absent, sink);
+        }) == 0);
+        CHECK(allocationsDuring([&] {
+            library.searchBookByAuthor(author, sink);
+            library.searchBookByAuthor(absent, sink);
+        }) == 0);
+        CHECK(sink.matched() > 0);
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <functional>
+#include <filesystem>
+#include "ConcurrentLibrary.h"
+#include "TestSupport.h"
+
+// ߳ɾ֮ flushڸĿ¼¼ book.txt ־𱾺˶ڴеķƬһ
+
+namespace {
+
+const size_t initialBooks = 2000;
+const size_t isbnPool = 3000;        // ȫֻЩ ISBN ISBN Ŀ꣩˶ʱ
+const size_t writerThreads = 4;
+const size_t stepsPerThread = 3000;
+
+bool sameBook(const Book& a, const Book& b) {
+    return a.getISBN() == b.getISBN() && a.getTitle() == b.getTitle() && a.getAuthor() == b.getAuthor()
+        && a.getPublisher() == b.getPublisher() && a.getPublishDate() == b.getPublishDate()
+        && a.getPrice() == b.getPrice() && a.getQuantity() == b.getQuantity();
+}
+
+void randomWrites(ConcurrentLibrary& library, size_t thread) {
+    std::mt19937_64 rng(thread + 1);
+    for (size_t step = 0; step < stepsPerThread; ++step) {
+        std::string isbn = testISBN(rng() % isbnPool);
+        // ۸ȡ֣λСд־ͬһ double
+        double price = static_cast<double>(rng() % 100000) / 100;
+        int quantity = static_cast<int>(rng() % 50);
+        std::string title = "title-" + std::to_string(thread) + "-" + std::to_string(step);
+        switch (rng() % 3) {
+        case 0:
+            library.addBook(Book(isbn, title, "author", "publisher", "2020-01-01", price, quantity));
+            break;
+        case 1: {
+            std::string newISBN = rng() % 4 == 0 ? testISBN(rng() % isbnPool) : isbn;
+            library.updateBook(isbn, Book(newISBN, title, "author", "publisher", "2021-06", price, quantity));
+            break;
+        }
+        default:
+            library.deleteBook(isbn);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+bool testConcurrentWrites() {
+    CHECK(writeCatalog(initialBooks));
+    ConcurrentLibrary library(8);
+    CHECK(library.size() == initialBooks);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < writerThreads; ++t) {
+        threads.emplace_back(randomWrites, std::ref(library), t);
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(library.flush());
+
+    // һĿ¼мļĸе ConcurrentLibrary
+    std::filesystem::path data = std::filesystem::current_path();
+    ScratchDirectory reload("concurrent-reload");
+    for (const char* name : { "book.txt", "book.txt.journal" }) {
+        if (std::filesystem::exists(data / name)) std::filesystem::copy_file(data / name, name);
+    }
+    Library reloaded;
+    CHECK(reloaded.verifyStatistics());
+    CHECK(static_cast<size_t>(reloaded.getTotalBooksCount()) == library.size());
+    Book actual("", "", "", "", "", 0.0, 0);
+    for (size_t i = 0; i < isbnPool; ++i) {
+        std::string isbn = testISBN(i);
+        ConcurrentLibrary::BookHandle expected = library.findBook(isbn);
+        bool found = reloaded.getBook(isbn, actual);
+        CHECK_MESSAGE((expected != nullptr) == found, isbn);
+        if (expected) CHECK_MESSAGE(sameBook(*expected, actual), isbn);
+    }
+    return true;
+}
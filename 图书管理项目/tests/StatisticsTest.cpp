@@ -0,0 +1,65 @@
+#include <string>
+#include <random>
+#include "LibraryManagement.h"
+#include "TestSupport.h"
+
+// άͳƻ棺3000 ɾģÿһ֮ verifyStatistics() Ӧ밴Ľһ
+
+namespace {
+
+const size_t initialBooks = 200;
+const size_t isbnPool = 400;
+const size_t steps = 3000;
+
+// ߡ۸ֻȡ֣ĺϲԼ/ͼ۵Ĳ
+const char* const authors[] = { "author-a", "author-b", "author-c", "author-d" };
+const char* const publishers[] = { "publisher-a", "publisher-b", "publisher-c" };
+
+Book randomBook(std::mt19937_64& rng, const std::string& isbn, size_t step) {
+    double price = static_cast<double>(rng() % 20) * 2.5 + (rng() % 2 == 0 ? 0.99 : 0.0);
+    int quantity = static_cast<int>(rng() % 6);
+    return Book(isbn, "title-" + std::to_string(step), authors[rng() % 4], publishers[rng() % 3], "2020-01-01",
+        price, quantity);
+}
+
+} // namespace
+
+bool testStatisticsAfterEachStep() {
+    CHECK(writeCatalog(initialBooks));
+    Library library;
+    CHECK(library.getTotalBooksCount() == static_cast<int>(initialBooks));
+    CHECK(library.verifyStatistics());
+
+    std::mt19937_64 rng(8);
+    size_t applied = 0;   // ɹ޸ֹȫܾʱ
+    for (size_t step = 0; step < steps; ++step) {
+        std::string isbn = testISBN(rng() % isbnPool);
+        bool ok = false;
+        switch (rng() % 4) {
+        case 0:
+            ok = library.addBook(randomBook(rng, isbn, step));
+            break;
+        case 1: {
+            // ķ֮һĸͬʱ޸ ISBN
+            std::string newISBN = rng() % 4 == 0 ? testISBN(rng() % isbnPool) : isbn;
+            ok = library.updateBook(isbn, randomBook(rng, newISBN, step));
+            break;
+        }
+        case 2: {
+            // ֶμ޸ģֻļ۸
+            BookPatch patch;
+            if (rng() % 2 == 0) patch.price = static_cast<double>(rng() % 40);
+            else patch.quantity = static_cast<int>(rng() % 6);
+            ok = library.updateBook(isbn, patch);
+            break;
+        }
+        default:
+            ok = library.deleteBook(isbn);
+            break;
+        }
+        if (ok) ++applied;
+        CHECK_MESSAGE(library.verifyStatistics(), " " << step + 1 << " ");
+    }
+    CHECK(applied > steps / 4);
+    return true;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string_view>
+#include <exception>
+#include "TestSupport.h"
+
+// Գ򣺲ʱȫԣֻвгĲԡ
+// ÿԼʱĿ¼УвʧܻƲʱط
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    bool (*run)();
+};
+
+const TestCase testCases[] = {
+    { "statistics", testStatisticsAfterEachStep },
+    { "concurrent", testConcurrentWrites },
+    { "allocation", testAllocationFree },
+};
+
+bool runTest(const TestCase& test) {
+    bool passed = false;
+    try {
+        ScratchDirectory directory(test.name);
+        passed = test.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << test.name << ": 쳣" << e.what() << std::endl;
+    }
+    std::cout << (passed ? "[ͨ] " : "[ʧ] ") << test.name << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int failed = 0;
+    if (argc < 2) {
+        for (const TestCase& test : testCases) {
+            if (!runTest(test)) ++failed;
+        }
+        return failed == 0 ? 0 : 1;
+    }
+    for (int i = 1; i < argc; ++i) {
+        const TestCase* found = nullptr;
+        for (const TestCase& test : testCases) {
+            if (std::string_view(test.name) == argv[i]) found = &test;
+        }
+        if (!found) {
+            std::cerr << "δ֪Ĳԣ" << argv[i] << std::endl;
+            ++failed;
+        }
+        else if (!runTest(*found)) {
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
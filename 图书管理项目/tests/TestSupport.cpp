@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <streambuf>
+#include "TestSupport.h"
+
+namespace {
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+} // namespace
+
+ScratchDirectory::ScratchDirectory(const std::string& name) : previous(std::filesystem::current_path()) {
+    std::random_device random;
+    path = std::filesystem::temp_directory_path() / ("library-test-" + name + "-" + std::to_string(random()));
+    std::filesystem::create_directories(path);
+    std::filesystem::current_path(path);
+}
+
+ScratchDirectory::~ScratchDirectory() {
+    std::error_code ec;
+    std::filesystem::current_path(previous, ec);
+    std::filesystem::remove_all(path, ec);
+}
+
+std::string testISBN(size_t index) {
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), "978%010llu", static_cast<unsigned long long>(index));
+    return digits;
+}
+
+bool writeCatalog(size_t books) {
+    std::ofstream out("book.txt", std::ios::binary);
+    char line[160];
+    for (size_t i = 0; i < books; ++i) {
+        // ۸ȡ֣ 0-19
+        std::snprintf(line, sizeof(line), "%s|title-%zu|author-%zu|publisher-%zu|2020-01-01|%.2f|%zu\n",
+            testISBN(i).c_str(), i, i % 37, i % 11, static_cast<double>(i * 7919 % 20000) / 100, i % 20);
+        out << line;
+    }
+    return static_cast<bool>(out);
+}
+
+std::ostream& nullStream() {
+    static NullBuffer buffer;
+    static std::ostream stream(&buffer);
+    return stream;
+}
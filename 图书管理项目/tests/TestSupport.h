@@ -0,0 +1,55 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+#include <string>
+#include <filesystem>
+#include <iostream>
+#include <ostream>
+
+// Գò֣ꡢʱĿ¼붪
+// ÿһ bool ĺCHECK ʧʱλòԺ false
+
+#define CHECK(condition) CHECK_MESSAGE(condition, "")
+
+// ʧʱһ˵ << ƴӣѭеĲ
+#define CHECK_MESSAGE(condition, message)                                                     \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": ʧܣ" << #condition << " " \
+                      << message << std::endl;                                                \
+            return false;                                                                     \
+        }                                                                                     \
+    } while (0)
+
+// ϵͳʱĿ¼½һĿ¼лΪĿ¼Library дĿ¼е book.txt
+// ʱлԭĿ¼ɾ
+class ScratchDirectory {
+private:
+    std::filesystem::path previous;
+    std::filesystem::path path;
+
+public:
+    explicit ScratchDirectory(const std::string& name);
+    ~ScratchDirectory();
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    const std::filesystem::path& get() const { return path; }
+};
+
+//  index ͼ ISBN978  10 λţindex ͬʱͬ
+std::string testISBN(size_t index);
+
+// ڹĿ¼д books ͼ book.txt i  ISBN Ϊ testISBN(i)
+// Ϊ title-<i>ֱ 37  11 ֻ֮
+bool writeCatalog(size_t books);
+
+// ȫ
+std::ostream& nullStream();
+
+// ԣʵڸԵ *Test.cpp 
+bool testStatisticsAfterEachStep();
+bool testConcurrentWrites();
+bool testAllocationFree();
+
+#endif // TEST_SUPPORT_H